@@ -6,10 +6,12 @@
 #include <vector>
 #include "nucleotide.h"
 #include "sequence.h"
+#include "miRNA.h"
 
 namespace microSNPscore { class sequence; } 
 namespace microSNPscore { class miRNA; } 
 namespace microSNPscore { class mRNA; } 
+namespace microSNPscore { class conservationList; } 
 
 namespace microSNPscore {
 
@@ -200,6 +202,55 @@ class SNP {
     
     bool matches(const sequence & the_sequence) const;
 
+    /*****************************************************************//**
+    * @brief check prediction influence
+    *
+    * This method is used to check whether the SNP may have influence on
+    * the downregulation of a given mRNA by a given miRNA, i.e. whether
+    * it matches the miRNA or the mRNA.
+    *
+    * @param the_miRNA miRNA that is predicted to downregulate the mRNA
+    * @param the_mRNA mRNA that is predicted to be downregulated by the
+    *     miRNA
+    *
+    * @return @p true if the SNP matches the miRNA or the mRNA, @p false
+    *     otherwise
+    *
+    * @see matches()
+    *********************************************************************/
+    bool affects(const miRNA & the_miRNA, const mRNA & the_mRNA) const;
+
+    /*****************************************************************//**
+    * @brief calculate mutant downregulation score
+    *
+    * This method calculates the downregulation score of a given mRNA by
+    * a given miRNA binding at a target site starting at a given position
+    * with the SNP applied to the miRNA (if it matches the miRNA) or to
+    * the mRNA (shifting the predicted 3' position if it is downstream of
+    * the SNP) otherwise.
+    * The SNP is expected to affect the prediction (see @p affects).
+    *
+    * @param the_miRNA  miRNA that is predicted to downregulate by the
+    *     mRNA
+    * @param the_mRNA  mRNA that is predicted to be downregulated by the
+    *     miRNA
+    * @param predicted_three_prime_position position on chromosome (the
+    *     5' end of the + strand (i.e. the 3' end of the - strand) beeing
+    *     position 1) that is predicted to be the mRNA nucleotide that
+    *     would bind the miRNA 5' end (if it would bind) (i.e. one base
+    *     downstream (3') from the seed match region)
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
+    * @param verbose (optional) bool indicating wheter verbose output
+    *     to STDERR should be done or not - Defaults to false
+    *
+    * @return the downregulation score of the mutant target site
+    *
+    * @see affects()
+    * @see miRNA::get_downregulation_score()
+    *********************************************************************/
+    downregulationScore get_mutant_score(const miRNA & the_miRNA, const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, const conservationList & conservations, bool verbose = false) const;
+
     /*****************************************************************//**
     * @brief calculate deregulation score
     *
@@ -217,6 +268,8 @@ class SNP {
     *     position 1) that is predicted to be the mRNA nucleotide that
     *     would bind the miRNA 5' end (if it would bind) (i.e. one base
     *     downstream (3') from the seed match region)
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
@@ -226,7 +279,39 @@ class SNP {
     * @see miRNA::get_downregulation_score()
     *********************************************************************/
     
-    deregulationScore get_deregulation_score(const miRNA & the_miRNA, const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, bool verbose = false) const;
+    deregulationScore get_deregulation_score(const miRNA & the_miRNA, const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, const conservationList & conservations, bool verbose = false) const;
+
+    /*****************************************************************//**
+    * @brief calculate deregulation score from wildtype score
+    *
+    * This method does the same as the one calculating the wildtype
+    * score itself but takes the wildtype downregulation score of the
+    * target site (as calculated by miRNA::get_downregulation_score())
+    * instead, allowing to share it between all SNPs predicted for the
+    * same target site.
+    *
+    * @param the_miRNA  miRNA that is predicted to downregulate by the
+    *     mRNA
+    * @param the_mRNA  mRNA that is predicted to be downregulated by the
+    *     miRNA
+    * @param predicted_three_prime_position position on chromosome (the
+    *     5' end of the + strand (i.e. the 3' end of the - strand) beeing
+    *     position 1) that is predicted to be the mRNA nucleotide that
+    *     would bind the miRNA 5' end (if it would bind) (i.e. one base
+    *     downstream (3') from the seed match region)
+    * @param wildtype_score downregulationScore of the miRNA for the
+    *     target site in the unmutated mRNA
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
+    * @param verbose (optional) bool indicating wheter verbose output
+    *     to STDERR should be done or not - Defaults to false
+    *
+    * @return the deregulation score of the SNP for the target site of
+    *     the miRNA starting at the given position in the given mRNA
+    *
+    * @see get_mutant_score()
+    *********************************************************************/
+    deregulationScore get_deregulation_score(const miRNA & the_miRNA, const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, downregulationScore wildtype_score, const conservationList & conservations, bool verbose = false) const;
 
 
   private:
@@ -0,0 +1,79 @@
+#ifndef MICROSNPSCORE_SNPINDEX_H
+#define MICROSNPSCORE_SNPINDEX_H
+
+
+#include <vector>
+#include <map>
+#include "nucleotide.h"
+#include "sequence.h"
+#include "SNP.h"
+#include "entityTable.h"
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief SNP index class
+*
+* This represents an interval index over the SNPs of an entityTable
+* allowing to find all SNPs whose reference overlaps a given range of
+* a chromosome without comparing every SNP.
+* For every chromosome the SNPs are sorted by their (+ strand)
+* position and the longest reference is remembered to know how far
+* before a range an overlapping SNP may start.
+*
+* @see entityTable
+*********************************************************************/
+
+class SNPIndex {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create an SNPIndex for the SNPs of a given table.
+    * The index refers to the SNPs by their IDs in the table.
+    *
+    * @param the_SNPs const entityTable reference to the SNPs to be
+    *     indexed
+    *
+    * @return SNPIndex for the given SNPs
+    *********************************************************************/
+    SNPIndex(const entityTable<SNPID,SNP> & the_SNPs);
+
+    /*****************************************************************//**
+    * @brief range query
+    *
+    * This method is used to find all SNPs whose reference overlaps a
+    * given range of a chromosome.
+    * The IDs found are appended to the given vector in order of the
+    * SNPs' positions.
+    *
+    * @param the_chromosome chromosomeType of the chromosome to search
+    * @param from chromosomePosition of the first position of the range
+    * @param to chromosomePosition of the last position of the range
+    * @param IDs std::vector reference the SNP IDs are appended to
+    *********************************************************************/
+    void find(const chromosomeType & the_chromosome, chromosomePosition from, chromosomePosition to, std::vector<entityID> & IDs) const;
+
+
+  private:
+    /*****************************************************************//**
+    * @brief SNP starts
+    *
+    * This holds the (+ strand) start positions and reference ends of
+    * the SNPs together with their IDs sorted by start position for every
+    * chromosome.
+    *********************************************************************/
+    std::map<chromosomeType,std::vector<std::pair<std::pair<chromosomePosition,chromosomePosition>,entityID> > > starts;
+
+    /*****************************************************************//**
+    * @brief maximal reference lengths
+    *
+    * This holds the length of the longest SNP reference for every
+    * chromosome.
+    *********************************************************************/
+    std::map<chromosomeType,chromosomePosition> max_lengths;
+
+};
+
+} // namespace microSNPscore
+#endif
@@ -7,6 +7,9 @@
 #include "sequence.h"
 #include "nucleotide.h"
 #include <vector>
+#include <map>
+#include <set>
+#include <stddef.h>
 #include "filePath.h"
 
 namespace microSNPscore {
@@ -185,20 +188,153 @@ class conservationRange {
       return score;
     }
 
+/*****************************************************************//**
+* @brief chromosome ID type
+*
+* This is the type of the numbers a conservationList assigns to the
+* chromosomes it knows (in the order of the conservation file).
+*
+* @see conservationList::get_chromosome_ID()
+*********************************************************************/
+typedef unsigned int chromosomeID;
+
+/*****************************************************************//**
+* @brief chromosome conservation
+*
+* This represents the conservation ranges of a single chromosome as
+* flat arrays of their start positions and scores.
+* The first start of every block of starts is repeated in a small
+* block index, so a position is found by a binary search in the block
+* index (which stays in cache) followed by one within a single block.
+*
+* @see conservationList
+*********************************************************************/
+struct chromosomeConservation {
+    /*****************************************************************//**
+    * @brief range starts
+    *
+    * This holds the start positions of the chromosome's ranges in
+    * ascending order.
+    *********************************************************************/
+    std::vector<chromosomePosition> starts;
+
+    /*****************************************************************//**
+    * @brief range scores
+    *
+    * This holds the scores of the chromosome's ranges (in the order of
+    * their starts).
+    *********************************************************************/
+    std::vector<conservationScore> scores;
+
+    /*****************************************************************//**
+    * @brief block index
+    *
+    * This holds the first start of every block of starts.
+    *********************************************************************/
+    std::vector<chromosomePosition> block_starts;
+
+};
+/*****************************************************************//**
+* @brief genomic region set
+*
+* This represents a set of regions on chromosomes (like the exons of
+* the sequences loaded) a conservationList can be restricted to.
+* The regions of every chromosome are kept sorted by their start and
+* merged where they overlap or touch, so adding a region costs a
+* logarithmic search only.
+*
+* @see conservationList
+*********************************************************************/
+class genomicRegions {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create an empty region set.
+    *
+    * @return a genomicRegions without any region
+    *********************************************************************/
+    genomicRegions();
+
+    /*****************************************************************//**
+    * @brief region insertion
+    *
+    * This method is used to add a region to the set (merging it with
+    * the regions it overlaps or touches).
+    *
+    * @param chromosome const chromosomeType reference to the chromosome
+    *     the region is located on
+    * @param start chromosomePosition of the first position of the region
+    * @param end chromosomePosition of the last position of the region
+    *     (regions ending before their start are ignored)
+    *********************************************************************/
+    void add(const chromosomeType & chromosome, chromosomePosition start, chromosomePosition end);
+
+    /*****************************************************************//**
+    * @brief sequence insertion
+    *
+    * This method is used to add the exons of a sequence to the set.
+    *
+    * @param the_sequence const sequence reference to the sequence
+    *********************************************************************/
+    void add(const sequence & the_sequence);
+
+    /*****************************************************************//**
+    * @brief overlap check
+    *
+    * This method is used to check whether a range of positions on a
+    * chromosome shares a position with any region of the set.
+    *
+    * @param chromosome const chromosomeType reference to the chromosome
+    *     the range is located on
+    * @param start chromosomePosition of the first position of the range
+    * @param end chromosomePosition of the last position of the range
+    *
+    * @return true if the range overlaps a region, false otherwise
+    *********************************************************************/
+    bool overlaps(const chromosomeType & chromosome, chromosomePosition start, chromosomePosition end) const;
+
+
+  private:
+    /*****************************************************************//**
+    * @brief chromosome regions
+    *
+    * This maps the start of every region to its end for every
+    * chromosome.
+    *********************************************************************/
+    std::map<chromosomeType,std::map<chromosomePosition,chromosomePosition> > chromosomes;
+
+    friend class conservationList;
+};
 /*****************************************************************//**
 * @brief conservation list
 *
 * This represent a searchable list range on a chromosome with the same
 * conservation.
+* The ranges are partitioned by chromosome, so once the number of a
+* chromosome is known (see @p get_chromosome_ID) looking up scores
+* only compares positions.
+* A text table can be restricted to the ranges overlapping a set of
+* genomicRegions while it is read.
+* Besides the text table a conservation track written by @p convert
+* can be read.
+* It holds the block index of every chromosome, the other starts of a
+* block as variable-length deltas to their predecessor and the scores
+* as 16 bit indices into a table of the distinct scores (which keeps
+* them exact).
+* The track is memory-mapped when opened (using the byte order of the
+* machine it was written on), so only the blocks of positions actually
+* looked up are ever read.
 *********************************************************************/
 class conservationList {
   public:
     /*****************************************************************//**
-    * @brief const iterator type
+    * @brief unknown chromosome ID
     *
-    * This type is used to access the conservation list's ranges.
+    * This is the ID returned for chromosomes without conservation
+    * ranges.
     *********************************************************************/
-    typedef std::vector<conservationRange>::const_iterator const_iterator;
+    static const chromosomeID unknown_chromosome = static_cast<chromosomeID>(-1);
 
     /*****************************************************************//**
     * @brief constructor
@@ -212,37 +348,51 @@ class conservationList {
     * error is raised and an empty list is created.
     * If a line does not match the format or is not in order, an error is
     * raised and the line is ignored.
+    * If regions are given, only the ranges overlapping them are kept
+    * (which gives the same scores for all positions inside the regions)
+    * and the errors for chromosomes of the regions without ranges (or
+    * with regions before their first range) are raised right away.
+    * If the file is a conservation track it is mapped instead (see
+    * @p convert) and if it is no valid track of the current version an
+    * error is raised and an empty list is created.
     *
     * @param conservation_file file path of the input file
+    * @param regions (optional) const genomicRegions pointer to the
+    *     regions the scores will be looked up in (only checked for
+    *     coverage for tracks) - Defaults to NULL (keeping all ranges)
     *
     * @return a conservationList containing the ranges given in the file
     *********************************************************************/
-    conservationList(const filePath & conservation_file);
+    conservationList(const filePath & conservation_file, const genomicRegions * regions = NULL);
 
     /*****************************************************************//**
-    * @brief conservation list begin
+    * @brief destructor
     *
-    * This is used to get the first conservation range in the list.
-    *
-    * @return const_iterator pointing to the first conservation range
+    * This is used to unmap the conservation track (if any).
     *********************************************************************/
-    const_iterator begin() const;
+    ~conservationList();
 
     /*****************************************************************//**
-    * @brief conservation list end
+    * @brief get method for chromosome IDs
+    *
+    * This method is used to look up the number of a chromosome once, so
+    * the scores on it can be accessed without comparing chromosome
+    * names.
     *
-    * This is used to get the end of the conservation list.
+    * @param chromosome const chromosomeType reference to the chromosome
     *
-    * @return const_iterator pointing behind the last conservation range
+    * @return the ID of the chromosome or @p unknown_chromosome if there
+    *     are no ranges on it
     *********************************************************************/
-    const_iterator end() const;
+    chromosomeID get_chromosome_ID(const chromosomeType & chromosome) const;
 
     /*****************************************************************//**
     * @brief get conservation score by chromosome and position
     *
     * This method is used to access the conservation score of a given
     * position on a given chromosome.
-    * If the chromosome is unknown, an error is raised and 0 is returned.
+    * If the chromosome is unknown, an error is raised (once per
+    * chromosome) and 0 is returned.
     *
     * @param chromosome the chromosome the position of interest is
     * located on
@@ -256,16 +406,450 @@ class conservationList {
     
     conservationScore get_score(const chromosomeType & chromosome, const chromosomePosition & position) const;
 
+    /*****************************************************************//**
+    * @brief get conservation score by chromosome ID and position
+    *
+    * This method is used to access the conservation score of a given
+    * position on a chromosome given by its ID.
+    * If the position lies before the first range of the chromosome, an
+    * error is raised (once per chromosome) and 0 is returned.
+    *
+    * @param chromosome chromosomeID of the chromosome the position of
+    *     interest is located on (not @p unknown_chromosome)
+    * @param position the position of interest on the given chromosome
+    *     (the 5' end of the + strand (i.e. the 3' end of the - end)
+    *     beeing position 1)
+    *
+    * @return the conservation score of the given position on the given
+    *     chromosome
+    *
+    * @see get_chromosome_ID()
+    *********************************************************************/
+    conservationScore get_score(chromosomeID chromosome, chromosomePosition position) const;
+
+    /*****************************************************************//**
+    * @brief conservation track creation
+    *
+    * This method is used to create (or replace) the conservation track
+    * of a conservation file.
+    * Errors in the file are stated like when reading it directly.
+    * If the file contains no ranges (e.g. because it cannot be read), is
+    * a conservation track already, the track cannot be written or the
+    * scores contain more than 65536 distinct values an error is raised.
+    *
+    * @param conservation_path filePath to the conservation file
+    * @param track_path filePath to the track file to be written
+    *
+    * @return true if the track was written, false otherwise
+    *********************************************************************/
+    static bool convert(const filePath & conservation_path, const filePath & track_path);
+
+    /*****************************************************************//**
+    * @brief conservation track detection
+    *
+    * This method is used to check whether a given file is a
+    * conservation track (and not a conservation table).
+    *
+    * @param the_path filePath to the file
+    *
+    * @return true if the file starts like a conservation track, false
+    *     otherwise
+    *********************************************************************/
+    static bool is_track(const filePath & the_path);
+
 
   private:
     /*****************************************************************//**
-    * @brief conservation range list
+    * @brief copy constructor - not implemented
+    *
+    * A list may own a track mapping and cannot be copied.
+    *********************************************************************/
+    conservationList(const conservationList & the_list);
+
+    /*****************************************************************//**
+    * @brief assignment operator - not implemented
+    *
+    * A list may own a track mapping and cannot be assigned.
+    *********************************************************************/
+    conservationList & operator=(const conservationList & the_list);
+
+    /*****************************************************************//**
+    * @brief conservation track opening
+    *
+    * This method is used to map the conservation track of the list and
+    * to read its chromosome names.
+    * If the file cannot be mapped or is no valid track of the current
+    * version an error is raised and the list stays empty.
+    *********************************************************************/
+    void open_track();
+
+    /*****************************************************************//**
+    * @brief range appending
+    *
+    * This method is used to append a range read from a text table to
+    * the partition of its chromosome (starting a new partition if the
+    * chromosome differs from the one of the last range appended).
+    *
+    * @param chromosome const chromosomeType reference to the chromosome
+    *     of the range
+    * @param start chromosomePosition where the range starts (after the
+    *     start of the last range appended on the same chromosome)
+    * @param score conservationScore of the range
+    *********************************************************************/
+    void append_range(const chromosomeType & chromosome, chromosomePosition start, conservationScore score);
+
+    /*****************************************************************//**
+    * @brief block size
     *
-    * This is a vector containing the conservation list's entries.
+    * This is the number of range starts per block of the block index of
+    * a chromosome (16 starts fill a cache line).
     *********************************************************************/
-    std::vector<conservationRange> ranges;
+    static const size_t block_size = 16;
+
+    /*****************************************************************//**
+    * @brief get method for block counts
+    *
+    * This method is used to access the number of blocks of ranges on a
+    * chromosome.
+    *
+    * @param chromosome chromosomeID of the chromosome
+    *
+    * @return the number of blocks on the chromosome
+    *********************************************************************/
+    size_t get_block_count(chromosomeID chromosome) const;
+
+    /*****************************************************************//**
+    * @brief get method for block starts
+    *
+    * This method is used to access the start of the first range of a
+    * block from the block index (without restoring the block).
+    *
+    * @param chromosome chromosomeID of the chromosome
+    * @param block size_t representing the number of the block on the
+    *     chromosome (less than its block count)
+    *
+    * @return the first start of the block
+    *********************************************************************/
+    chromosomePosition get_block_start(chromosomeID chromosome, size_t block) const;
+
+    /*****************************************************************//**
+    * @brief block search
+    *
+    * This method is used to search the block index of a chromosome for
+    * the block a position lies in.
+    *
+    * @param chromosome chromosomeID of the chromosome
+    * @param position chromosomePosition of interest
+    *
+    * @return the number of blocks starting at or before the position (so
+    *     0 if no range covers it)
+    *********************************************************************/
+    size_t find_block(chromosomeID chromosome, chromosomePosition position) const;
+
+    /*****************************************************************//**
+    * @brief block decoding
+    *
+    * This method is used to restore the range starts of a block of a
+    * chromosome.
+    * If the block's deltas do not lie inside the conservation track an
+    * error is raised and only the starts read before are restored.
+    *
+    * @param chromosome chromosomeID of the chromosome
+    * @param block size_t representing the number of the block on the
+    *     chromosome (less than its block count)
+    * @param starts chromosomePosition array the starts are assigned to
+    *     (with space for a whole block)
+    *
+    * @return the number of starts restored
+    *********************************************************************/
+    size_t decode_block(chromosomeID chromosome, size_t block, chromosomePosition starts[]) const;
+
+    /*****************************************************************//**
+    * @brief get method for range scores
+    *
+    * This method is used to access the score of a range of a chromosome.
+    * If its index into the score table of the conservation track is
+    * invalid an error is raised and 0 is returned.
+    *
+    * @param chromosome chromosomeID of the chromosome
+    * @param range size_t representing the number of the range on the
+    *     chromosome
+    *
+    * @return the score of the range
+    *********************************************************************/
+    conservationScore get_range_score(chromosomeID chromosome, size_t range) const;
+
+    /*****************************************************************//**
+    * @brief unknown chromosome reporting
+    *
+    * This method is used to state the error of a position without a
+    * conservation range once per chromosome (further positions on a
+    * chromosome reported before are not stated again).
+    *
+    * @param chromosome const chromosomeType reference to the chromosome
+    *     of the position
+    *********************************************************************/
+    void report_unknown(const chromosomeType & chromosome) const;
+
+    /*****************************************************************//**
+    * @brief coverage check
+    *
+    * This method is used to state the errors for the chromosomes of a
+    * set of regions that have no ranges or regions before their first
+    * range, so they are stated once while loading instead of when the
+    * scores are looked up (possibly in several worker processes).
+    *
+    * @param regions const genomicRegions reference to the regions the
+    *     scores will be looked up in
+    *********************************************************************/
+    void report_uncovered(const genomicRegions & regions) const;
+
+    /*****************************************************************//**
+    * @brief chromosome names
+    *
+    * This holds the name of every chromosome (indexed by its ID).
+    *********************************************************************/
+    std::vector<chromosomeType> chromosome_names;
+
+    /*****************************************************************//**
+    * @brief chromosome ID lookup
+    *
+    * This maps the name of every chromosome to its ID.
+    *********************************************************************/
+    std::map<chromosomeType,chromosomeID> chromosome_IDs;
+
+    /*****************************************************************//**
+    * @brief chromosome partitions
+    *
+    * This holds the conservation ranges of every chromosome (indexed by
+    * its ID) read from a text table.
+    *********************************************************************/
+    std::vector<chromosomeConservation> chromosomes;
+
+    /*****************************************************************//**
+    * @brief file path
+    *
+    * This is the path of the conservation file (used in error
+    * messages).
+    *********************************************************************/
+    const filePath path;
+
+    /*****************************************************************//**
+    * @brief track mapping
+    *
+    * This points to the first byte of the mapped conservation track (or
+    * is NULL if the list was read from a text table).
+    *********************************************************************/
+    const char * mapping;
+
+    /*****************************************************************//**
+    * @brief mapping size
+    *
+    * This is the size of the mapped conservation track in bytes.
+    *********************************************************************/
+    size_t mapping_size;
+
+    /*****************************************************************//**
+    * @brief reported chromosomes
+    *
+    * This holds the chromosomes a position without a range was stated
+    * for (so no chromosome is stated twice).
+    *********************************************************************/
+    mutable std::set<chromosomeType> reported_chromosomes;
+
+    friend class conservationWalker;
+    friend std::ostream & operator<<(std::ostream & the_stream, const conservationList & the_list);
+};
+/*****************************************************************//**
+* @brief conservation walker
+*
+* This walks the conservation ranges of a chromosome along a series of
+* positions (like the nucleotides of an exon in either direction).
+* The range of the last position is kept, so the score of a position
+* in it or in one of its neighbouring ranges is returned without
+* searching the list and only jumps (e.g. to the next exon) search
+* the block index.
+* The scores (and errors) are the same as those of
+* conservationList::get_score.
+*
+* @see conservationList
+*********************************************************************/
+class conservationWalker {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to start walking the ranges of a chromosome (looking
+    * it up in the list only once).
+    *
+    * @param the_list const conservationList reference to the list (which
+    *     has to outlive the walker)
+    * @param the_chromosome const chromosomeType reference to the
+    *     chromosome
+    *
+    * @return conservationWalker positioned before the first range
+    *********************************************************************/
+    conservationWalker(const conservationList & the_list, const chromosomeType & the_chromosome);
+
+    /*****************************************************************//**
+    * @brief get conservation score by position
+    *
+    * This method is used to access the conservation score of a position
+    * on the chromosome moving the walker to its range.
+    * If the chromosome is unknown or no range covers the position, an
+    * error is raised (once per chromosome) and 0 is returned.
+    *
+    * @param position the position of interest on the chromosome (the 5'
+    *     end of the + strand (i.e. the 3' end of the - end) beeing
+    *     position 1)
+    *
+    * @return the conservation score of the given position
+    *********************************************************************/
+    inline conservationScore get_score(chromosomePosition position);
+
+
+  private:
+    /*****************************************************************//**
+    * @brief range change
+    *
+    * This method is used to move the walker to the range of a position
+    * outside of the current range (stepping to a neighbouring range or
+    * searching the block index).
+    *
+    * @param position the position of interest on the chromosome
+    *
+    * @return the conservation score of the given position
+    *********************************************************************/
+    conservationScore move_to(chromosomePosition position);
+
+    /*****************************************************************//**
+    * @brief range selection
+    *
+    * This method is used to make a range of the current block the
+    * current range.
+    *
+    * @param index size_t representing the number of the range in the
+    *     current block
+    *********************************************************************/
+    void select_range(size_t index);
+
+    /*****************************************************************//**
+    * @brief block loading
+    *
+    * This method is used to restore the starts of a block (unless it is
+    * the current block already).
+    *
+    * @param the_block size_t representing the number of the block on the
+    *     chromosome
+    *********************************************************************/
+    void load_block(size_t the_block);
+
+    /*****************************************************************//**
+    * @brief conservation list
+    *
+    * This is the list whose ranges are walked.
+    *********************************************************************/
+    const conservationList & list;
+
+    /*****************************************************************//**
+    * @brief chromosome
+    *
+    * This is the chromosome whose ranges are walked (used in error
+    * messages).
+    *********************************************************************/
+    const chromosomeType chromosome;
+
+    /*****************************************************************//**
+    * @brief chromosome ID
+    *
+    * This is the ID of the chromosome in the list.
+    *********************************************************************/
+    const chromosomeID chromosome_ID;
+
+    /*****************************************************************//**
+    * @brief block count
+    *
+    * This is the number of blocks of ranges on the chromosome.
+    *********************************************************************/
+    const size_t block_count;
+
+    /*****************************************************************//**
+    * @brief current block
+    *
+    * This is the number of the block whose starts are restored (or the
+    * block count if none is).
+    *********************************************************************/
+    size_t block;
+
+    /*****************************************************************//**
+    * @brief block length
+    *
+    * This is the number of restored starts of the current block.
+    *********************************************************************/
+    size_t block_length;
+
+    /*****************************************************************//**
+    * @brief block starts
+    *
+    * This holds the restored starts of the current block.
+    *********************************************************************/
+    chromosomePosition starts[conservationList::block_size];
+
+    /*****************************************************************//**
+    * @brief current range
+    *
+    * This is the number of the current range in the current block.
+    *********************************************************************/
+    size_t range;
+
+    /*****************************************************************//**
+    * @brief range start
+    *
+    * This is the first position of the current range.
+    *********************************************************************/
+    chromosomePosition range_start;
+
+    /*****************************************************************//**
+    * @brief range end
+    *
+    * This is the last position of the current range (the last range of
+    * a chromosome covers the rest of it).
+    *********************************************************************/
+    chromosomePosition range_end;
+
+    /*****************************************************************//**
+    * @brief range score
+    *
+    * This is the score of the current range.
+    *********************************************************************/
+    conservationScore range_score;
+
+    /*****************************************************************//**
+    * @brief range state
+    *
+    * This tells whether there is a current range.
+    *********************************************************************/
+    bool in_range;
 
 };
+    /*****************************************************************//**
+    * @brief get conservation score by position
+    *
+    * This method is used to access the conservation score of a position
+    * on the chromosome moving the walker to its range.
+    * If the chromosome is unknown or no range covers the position, an
+    * error is raised (once per chromosome) and 0 is returned.
+    *
+    * @param position the position of interest on the chromosome (the 5'
+    *     end of the + strand (i.e. the 3' end of the - end) beeing
+    *     position 1)
+    *
+    * @return the conservation score of the given position
+    *********************************************************************/
+    inline conservationScore conservationWalker::get_score(chromosomePosition position) {
+      return in_range && position >= range_start && position <= range_end ? range_score : move_to(position);
+}
+
 /*****************************************************************//**
 * @brief output stream conservation range insertion operator
 *
@@ -0,0 +1,471 @@
+#ifndef MICROSNPSCORE_ENTITYTABLE_H
+#define MICROSNPSCORE_ENTITYTABLE_H
+
+
+#include <vector>
+#include <algorithm>
+//for std::equal (key comparison)
+#include <stddef.h>
+//for size_t (hash values)
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief entity ID type
+*
+* This represents the dense integer ID of an entity in an entityTable,
+* the first entity inserted beeing ID 0.
+*********************************************************************/
+typedef unsigned int entityID;
+/*****************************************************************//**
+* @brief entity table class
+*
+* This represents a table of entities (like sequences or SNPs) stored
+* contiguously and identified by dense integer IDs assigned in the
+* order of insertion.
+* The key (e.g. a sequence ID) of an entity only needs to be resolved
+* to its integer ID once, afterwards the entity is accessed directly.
+* Keys are strings resolved through an open addressing hash index, so
+* a key can be looked up directly from the characters of an input line
+* without allocating a string for it (see @p find).
+* Like a std::map, the table keeps the first entity inserted for a
+* given key.
+* Entities holding large buffers (like the nucleotides of sequences)
+* can be moved into the table by swapping them with a default entity
+* instead of copying them (see @p adopt), which is also how such a
+* table grows.
+*
+* @see entityID
+*********************************************************************/
+
+template<class Key, class T>
+class entityTable {
+  public:
+    /*****************************************************************//**
+    * @brief entity insertion
+    *
+    * This method is used to insert an entity with a given key unless an
+    * entity with this key is already contained in the table.
+    *
+    * @param key const Key reference to the key of the entity
+    * @param entity const T reference to the entity
+    *
+    * @return the ID of the inserted entity or of the entity already
+    *     contained with the given key
+    *********************************************************************/
+    entityID insert(const Key & key, const T & entity);
+
+    /*****************************************************************//**
+    * @brief entity adoption
+    *
+    * This method is used to move an entity into the table under a given
+    * key without copying it (unless an entity with this key is already
+    * contained in the table).
+    * The entity is swapped with a default entity stored in the table,
+    * so T needs a default constructor and a swap method. The given
+    * entity is left empty.
+    *
+    * @param key const Key reference to the key of the entity
+    * @param entity T reference to the entity
+    *
+    * @return the ID of the inserted entity or of the entity already
+    *     contained with the given key
+    *********************************************************************/
+    entityID adopt(const Key & key, T & entity);
+
+    /*****************************************************************//**
+    * @brief capacity reservation
+    *
+    * This method is used to make room for a given number of entities
+    * (moving the entities contained by swapping like @p adopt does).
+    *
+    * @param count entityID representing the number of entities
+    *********************************************************************/
+    void reserve(entityID count);
+
+    /*****************************************************************//**
+    * @brief key resolution
+    *
+    * This method is used to resolve the key of an entity to its ID.
+    *
+    * @param key const Key reference to the key of the entity
+    * @param ID entityID reference the ID is assigned to
+    *
+    * @return true if an entity with the given key is contained in the
+    *     table, false otherwise
+    *********************************************************************/
+    inline bool find(const Key & key, entityID & ID) const;
+
+    /*****************************************************************//**
+    * @brief key resolution from characters
+    *
+    * This method is used to resolve the key given by a range of
+    * characters (e.g. a field of an input line) to the ID of its entity
+    * without creating a key object.
+    *
+    * @param begin const char pointer to the first character of the key
+    * @param end const char pointer behind the last character of the key
+    * @param ID entityID reference the ID is assigned to
+    *
+    * @return true if an entity with the given key is contained in the
+    *     table, false otherwise
+    *********************************************************************/
+    inline bool find(const char * begin, const char * end, entityID & ID) const;
+
+    /*****************************************************************//**
+    * @brief entity access
+    *
+    * This operator is used to access the entity with a given ID.
+    * The ID must be a valid one (i.e. less than the table's size).
+    *
+    * @param ID entityID of the entity
+    *
+    * @return const reference to the entity with the given ID
+    *********************************************************************/
+    inline const T & operator[](entityID ID) const;
+
+    /*****************************************************************//**
+    * @brief get method for size
+    *
+    * This method is used to access the number of entities in the table.
+    *
+    * @return the number of entities in the table
+    *********************************************************************/
+    inline entityID size() const;
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create an empty entityTable.
+    *
+    * @return empty entityTable
+    *********************************************************************/
+    entityTable();
+
+
+  private:
+    /*****************************************************************//**
+    * @brief copy constructor - not implemented
+    *
+    * A table holds its entities and is not meant to be copied.
+    *********************************************************************/
+    entityTable(const entityTable & the_table);
+
+    /*****************************************************************//**
+    * @brief assignment operator - not implemented
+    *
+    * A table holds its entities and is not meant to be assigned.
+    *********************************************************************/
+    entityTable & operator=(const entityTable & the_table);
+
+    /*****************************************************************//**
+    * @brief key registration
+    *
+    * This method is used to assign the next free ID to a key unless the
+    * key is registered already (growing the hash index if needed).
+    *
+    * @param key const Key reference to the key to be registered
+    * @param ID entityID reference the ID of the key is assigned to
+    *
+    * @return true if the key was registered, false if it was known
+    *********************************************************************/
+    bool register_key(const Key & key, entityID & ID);
+
+    /*****************************************************************//**
+    * @brief bucket search
+    *
+    * This method is used to find the bucket of the hash index holding
+    * a key or the empty bucket the key would be inserted at.
+    *
+    * @param begin const char pointer to the first character of the key
+    * @param end const char pointer behind the last character of the key
+    *
+    * @return the index of the bucket
+    *********************************************************************/
+    inline size_t find_bucket(const char * begin, const char * end) const;
+
+    /*****************************************************************//**
+    * @brief empty bucket marker
+    *
+    * This marks buckets of the hash index not holding any key.
+    *********************************************************************/
+    static const entityID no_entity = static_cast<entityID>(-1);
+
+    /*****************************************************************//**
+    * @brief entities
+    *
+    * This holds the entities in order of their IDs.
+    *********************************************************************/
+    std::vector<T> entities;
+
+    /*****************************************************************//**
+    * @brief keys
+    *
+    * This holds the keys of the entities in order of their IDs.
+    *********************************************************************/
+    std::vector<Key> keys;
+
+    /*****************************************************************//**
+    * @brief hash index
+    *
+    * This holds the ID of an entity (or @p no_entity) for every bucket
+    * of a hash index of the keys. Its size is a power of two and at
+    * least twice the number of keys.
+    *********************************************************************/
+    std::vector<entityID> buckets;
+
+};
+    /*****************************************************************//**
+    * @brief empty bucket marker
+    *
+    * This marks buckets of the hash index not holding any key.
+    *********************************************************************/
+    template<class Key, class T>
+    const entityID entityTable<Key,T>::no_entity;
+
+    /*****************************************************************//**
+    * @brief entity insertion
+    *
+    * This method is used to insert an entity with a given key unless an
+    * entity with this key is already contained in the table.
+    *
+    * @param key const Key reference to the key of the entity
+    * @param entity const T reference to the entity
+    *
+    * @return the ID of the inserted entity or of the entity already
+    *     contained with the given key
+    *********************************************************************/
+    template<class Key, class T>
+    entityID entityTable<Key,T>::insert(const Key & key, const T & entity) {
+       /****************************************************************\ 
+      | Try to register the key with the next free ID and only store the |
+      | entity if the key was not registered before:                     |
+       \****************************************************************/
+      entityID ID;
+      if(register_key(key,ID))
+      {
+        entities.push_back(entity);
+      }
+      return ID;
+}
+
+    /*****************************************************************//**
+    * @brief entity adoption
+    *
+    * This method is used to move an entity into the table under a given
+    * key without copying it (unless an entity with this key is already
+    * contained in the table).
+    * The entity is swapped with a default entity stored in the table,
+    * so T needs a default constructor and a swap method. The given
+    * entity is left empty.
+    *
+    * @param key const Key reference to the key of the entity
+    * @param entity T reference to the entity
+    *
+    * @return the ID of the inserted entity or of the entity already
+    *     contained with the given key
+    *********************************************************************/
+    template<class Key, class T>
+    entityID entityTable<Key,T>::adopt(const Key & key, T & entity) {
+       /***************************************************************\ 
+      | Try to register the key with the next free ID and only take the |
+      | entity over if the key was not registered before (doubling the  |
+      | capacity first if the table is full):                           |
+       \***************************************************************/
+      entityID ID;
+      if(register_key(key,ID))
+      {
+        if(entities.size() == entities.capacity())
+        {
+          reserve(entities.empty() ? 16 : 2 * entities.size());
+        }
+        entities.push_back(T());
+        entities.back().swap(entity);
+      }
+      return ID;
+}
+
+    /*****************************************************************//**
+    * @brief capacity reservation
+    *
+    * This method is used to make room for a given number of entities
+    * (moving the entities contained by swapping like @p adopt does).
+    *
+    * @param count entityID representing the number of entities
+    *********************************************************************/
+    template<class Key, class T>
+    void entityTable<Key,T>::reserve(entityID count) {
+       /***********************************************************\ 
+      | Fill a larger vector with default entities and swap the     |
+      | entities contained into them (instead of letting the vector |
+      | copy them when it reallocates):                             |
+       \***********************************************************/
+      if(count <= entities.capacity())
+      {
+        return;
+      }
+      std::vector<T> grown;
+      grown.reserve(count);
+      grown.resize(entities.size());
+      for(entityID entity_ID(0);entity_ID!=entities.size();++entity_ID)
+      {
+        grown[entity_ID].swap(entities[entity_ID]);
+      }
+      entities.swap(grown);
+}
+
+    /*****************************************************************//**
+    * @brief key resolution
+    *
+    * This method is used to resolve the key of an entity to its ID.
+    *
+    * @param key const Key reference to the key of the entity
+    * @param ID entityID reference the ID is assigned to
+    *
+    * @return true if an entity with the given key is contained in the
+    *     table, false otherwise
+    *********************************************************************/
+    template<class Key, class T>
+    inline bool entityTable<Key,T>::find(const Key & key, entityID & ID) const {
+      return find(key.data(),key.data() + key.size(),ID);
+}
+
+    /*****************************************************************//**
+    * @brief key resolution from characters
+    *
+    * This method is used to resolve the key given by a range of
+    * characters (e.g. a field of an input line) to the ID of its entity
+    * without creating a key object.
+    *
+    * @param begin const char pointer to the first character of the key
+    * @param end const char pointer behind the last character of the key
+    * @param ID entityID reference the ID is assigned to
+    *
+    * @return true if an entity with the given key is contained in the
+    *     table, false otherwise
+    *********************************************************************/
+    template<class Key, class T>
+    inline bool entityTable<Key,T>::find(const char * begin, const char * end, entityID & ID) const {
+      if(buckets.empty())
+      {
+        return false;
+      }
+      const entityID found(buckets[find_bucket(begin,end)]);
+      if(found == no_entity)
+      {
+        return false;
+      }
+      ID = found;
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief entity access
+    *
+    * This operator is used to access the entity with a given ID.
+    * The ID must be a valid one (i.e. less than the table's size).
+    *
+    * @param ID entityID of the entity
+    *
+    * @return const reference to the entity with the given ID
+    *********************************************************************/
+    template<class Key, class T>
+    inline const T & entityTable<Key,T>::operator[](entityID ID) const {
+      return entities[ID];
+}
+
+    /*****************************************************************//**
+    * @brief get method for size
+    *
+    * This method is used to access the number of entities in the table.
+    *
+    * @return the number of entities in the table
+    *********************************************************************/
+    template<class Key, class T>
+    inline entityID entityTable<Key,T>::size() const {
+      return entities.size();
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create an empty entityTable.
+    *
+    * @return empty entityTable
+    *********************************************************************/
+    template<class Key, class T>
+    entityTable<Key,T>::entityTable() {
+}
+
+    /*****************************************************************//**
+    * @brief key registration
+    *
+    * This method is used to assign the next free ID to a key unless the
+    * key is registered already (growing the hash index if needed).
+    *
+    * @param key const Key reference to the key to be registered
+    * @param ID entityID reference the ID of the key is assigned to
+    *
+    * @return true if the key was registered, false if it was known
+    *********************************************************************/
+    template<class Key, class T>
+    bool entityTable<Key,T>::register_key(const Key & key, entityID & ID) {
+       /************************************************************\ 
+      | Double the hash index (reinserting all keys) before it gets  |
+      | more than half full and store the key in its bucket if it is |
+      | not there yet:                                               |
+       \************************************************************/
+      if(2 * (keys.size() + 1) > buckets.size())
+      {
+        buckets.assign(buckets.empty() ? 16 : 2 * buckets.size(),no_entity);
+        for(entityID key_ID(0);key_ID!=keys.size();++key_ID)
+        {
+          buckets[find_bucket(keys[key_ID].data(),keys[key_ID].data() + keys[key_ID].size())] = key_ID;
+        }
+      }
+      const size_t bucket(find_bucket(key.data(),key.data() + key.size()));
+      if(buckets[bucket] != no_entity)
+      {
+        ID = buckets[bucket];
+        return false;
+      }
+      ID = buckets[bucket] = keys.size();
+      keys.push_back(key);
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief bucket search
+    *
+    * This method is used to find the bucket of the hash index holding
+    * a key or the empty bucket the key would be inserted at.
+    *
+    * @param begin const char pointer to the first character of the key
+    * @param end const char pointer behind the last character of the key
+    *
+    * @return the index of the bucket
+    *********************************************************************/
+    template<class Key, class T>
+    inline size_t entityTable<Key,T>::find_bucket(const char * begin, const char * end) const {
+       /************************************************************\ 
+      | Hash the characters (FNV-1a) and probe the following buckets |
+      | until the key or an empty bucket is found:                   |
+       \************************************************************/
+      size_t hash(2166136261u);
+      for(const char * character_it(begin);character_it!=end;++character_it)
+      {
+        hash = (hash ^ static_cast<unsigned char>(*character_it)) * 16777619u;
+      }
+      const size_t mask(buckets.size() - 1);
+      size_t bucket(hash & mask);
+      while(buckets[bucket] != no_entity &&
+            (keys[buckets[bucket]].size() != size_t(end - begin) || !std::equal(begin,end,keys[buckets[bucket]].data())))
+      {
+        bucket = (bucket + 1) & mask;
+      }
+      return bucket;
+}
+
+
+} // namespace microSNPscore
+#endif
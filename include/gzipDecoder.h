@@ -0,0 +1,284 @@
+#ifndef MICROSNPSCORE_GZIPDECODER_H
+#define MICROSNPSCORE_GZIPDECODER_H
+
+
+#include <vector>
+#include <sys/types.h>
+//for ssize_t (read results)
+#include <zlib.h>
+//for z_stream (stream decompression)
+#include "filePath.h"
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief BGZF block
+*
+* This represents a single block of a BGZF file (a gzip member of at
+* most 64 KiB) before and after its decompression.
+*
+* @see gzipDecoder
+*********************************************************************/
+struct bgzfBlock {
+    /*****************************************************************//**
+    * @brief compressed data
+    *
+    * This holds the deflate data of the block followed by the gzip
+    * trailer (CRC32 and size of the decompressed data).
+    *********************************************************************/
+    std::vector<unsigned char> compressed;
+
+    /*****************************************************************//**
+    * @brief decompressed data
+    *
+    * This holds the decompressed data of the block.
+    *********************************************************************/
+    std::vector<char> data;
+
+    /*****************************************************************//**
+    * @brief validity flag
+    *
+    * This indicates whether the block could be decompressed and matched
+    * its trailer.
+    *********************************************************************/
+    bool valid;
+
+};
+/*****************************************************************//**
+* @brief gzip decoder class
+*
+* This represents a decoder returning the decompressed data of a gzip
+* file (possibly consisting of several members as written by
+* concatenating gzip files) one block after another.
+* BGZF files (gzip files made of independent blocks recording their
+* size, as written by bgzip) are recognized and their blocks are
+* decompressed by several threads in parallel while the next blocks
+* are read, other gzip files are decompressed as a single stream.
+*
+* @see lineReader
+*********************************************************************/
+
+class gzipDecoder {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a gzipDecoder reading a gzip file from a
+    * given file descriptor (positioned at the start of the file).
+    * The descriptor remains owned by the caller.
+    *
+    * @param the_fd int representing the file descriptor to read from
+    * @param the_path filePath to the file (used in error messages)
+    *
+    * @return gzipDecoder for the given file
+    *
+    * @see is_gzip()
+    *********************************************************************/
+    gzipDecoder(int the_fd, const filePath & the_path);
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to release the decompression state.
+    *********************************************************************/
+    ~gzipDecoder();
+
+    /*****************************************************************//**
+    * @brief data reading
+    *
+    * This method is used to get the next decompressed data.
+    * If the file is corrupt or truncated an error is raised.
+    *
+    * @param destination char pointer to the memory the data is written
+    *     to
+    * @param size size_t representing the maximal number of bytes to
+    *     write
+    *
+    * @return the number of bytes written, 0 at the end of the file or -1
+    *     on errors
+    *********************************************************************/
+    ssize_t read(char * destination, size_t size);
+
+    /*****************************************************************//**
+    * @brief gzip detection
+    *
+    * This method is used to check whether a file starts with the gzip
+    * magic bytes (without changing its position).
+    *
+    * @param fd int representing the file descriptor of the file
+    *
+    * @return true if the file is a gzip file, false otherwise (or if
+    *     it cannot be checked, e.g. for pipes)
+    *********************************************************************/
+    static bool is_gzip(int fd);
+
+
+  private:
+    /*****************************************************************//**
+    * @brief copy constructor - not implemented
+    *
+    * A decoder owns its decompression state and cannot be copied.
+    *********************************************************************/
+    gzipDecoder(const gzipDecoder & the_decoder);
+
+    /*****************************************************************//**
+    * @brief assignment operator - not implemented
+    *
+    * A decoder owns its decompression state and cannot be assigned.
+    *********************************************************************/
+    gzipDecoder & operator=(const gzipDecoder & the_decoder);
+
+    /*****************************************************************//**
+    * @brief stream decompression
+    *
+    * This method is used to decompress the next data of a gzip file not
+    * in BGZF format.
+    *
+    * @param destination char pointer to the memory the data is written
+    *     to
+    * @param size size_t representing the maximal number of bytes to
+    *     write
+    *
+    * @return the number of bytes written, 0 at the end of the file or -1
+    *     on errors
+    *********************************************************************/
+    ssize_t read_stream(char * destination, size_t size);
+
+    /*****************************************************************//**
+    * @brief BGZF block reading
+    *
+    * This method is used to read the next blocks of a BGZF file (without
+    * decompressing them).
+    * If a block is truncated or not in BGZF format an error is raised
+    * and no more blocks are read.
+    *
+    * @param blocks std::vector reference the blocks are assigned to
+    *
+    * @return true if at least one block was read, false otherwise
+    *********************************************************************/
+    bool read_blocks(std::vector<bgzfBlock> & blocks);
+
+    /*****************************************************************//**
+    * @brief BGZF batch decompression
+    *
+    * This method is used to decompress the blocks read ahead on several
+    * threads while reading the blocks following them.
+    *
+    * @return true if a batch of blocks was decompressed, false at the
+    *     end of the file or on errors
+    *********************************************************************/
+    bool next_batch();
+
+    /*****************************************************************//**
+    * @brief complete reading
+    *
+    * This method is used to read a given number of bytes from the file
+    * (retrying interrupted and partial reads).
+    *
+    * @param destination void pointer to the memory the data is written to
+    * @param size size_t representing the number of bytes to read
+    *
+    * @return the number of bytes read (less than @p size only at the end
+    *     of the file or on errors)
+    *********************************************************************/
+    size_t read_fully(void * destination, size_t size);
+
+    /*****************************************************************//**
+    * @brief file descriptor
+    *
+    * This is the descriptor of the gzip file read.
+    *********************************************************************/
+    const int fd;
+
+    /*****************************************************************//**
+    * @brief file path
+    *
+    * This is the path of the gzip file (used in error messages).
+    *********************************************************************/
+    const filePath path;
+
+    /*****************************************************************//**
+    * @brief BGZF flag
+    *
+    * This indicates whether the file is in BGZF format.
+    *********************************************************************/
+    bool bgzf;
+
+    /*****************************************************************//**
+    * @brief thread count
+    *
+    * This is the number of threads decompressing BGZF blocks.
+    *********************************************************************/
+    unsigned int threads;
+
+    /*****************************************************************//**
+    * @brief decompression stream
+    *
+    * This is the zlib state decompressing gzip files not in BGZF format.
+    *********************************************************************/
+    z_stream stream;
+
+    /*****************************************************************//**
+    * @brief compressed input
+    *
+    * This holds the compressed data read but not yet decompressed by the
+    * stream.
+    *********************************************************************/
+    std::vector<unsigned char> input;
+
+    /*****************************************************************//**
+    * @brief member end flag
+    *
+    * This indicates whether the stream has just completed a gzip member
+    * (so the file may end).
+    *********************************************************************/
+    bool member_complete;
+
+    /*****************************************************************//**
+    * @brief decompressed BGZF batch
+    *
+    * This holds the decompressed blocks data is currently returned from.
+    *********************************************************************/
+    std::vector<bgzfBlock> batch;
+
+    /*****************************************************************//**
+    * @brief pending BGZF batch
+    *
+    * This holds the blocks read ahead but not yet decompressed.
+    *********************************************************************/
+    std::vector<bgzfBlock> pending;
+
+    /*****************************************************************//**
+    * @brief batch position
+    *
+    * This is the index of the block in the current batch data is
+    * returned from.
+    *********************************************************************/
+    size_t block_index;
+
+    /*****************************************************************//**
+    * @brief block position
+    *
+    * This is the index of the first byte of the current block's data not
+    * yet returned.
+    *********************************************************************/
+    size_t block_position;
+
+    /*****************************************************************//**
+    * @brief input end flag
+    *
+    * This indicates whether all of the file was read.
+    *********************************************************************/
+    bool input_end;
+
+    /*****************************************************************//**
+    * @brief failure flag
+    *
+    * This indicates whether the file turned out to be corrupt.
+    *********************************************************************/
+    bool failed;
+
+};
+
+} // namespace microSNPscore
+#endif
@@ -0,0 +1,384 @@
+#ifndef MICROSNPSCORE_LINEREADER_H
+#define MICROSNPSCORE_LINEREADER_H
+
+
+#include <vector>
+#include <sys/types.h>
+#include "nucleotide.h"
+#include "filePath.h"
+
+namespace microSNPscore {
+
+class gzipDecoder;
+
+/*****************************************************************//**
+* @brief field view
+*
+* This represents a field of a line as pair of pointers into the
+* line's buffer (begin and behind the end) without copying it.
+*********************************************************************/
+struct fieldView {
+    /*****************************************************************//**
+    * @brief field begin
+    *
+    * This points to the first character of the field.
+    *********************************************************************/
+    const char * begin;
+
+    /*****************************************************************//**
+    * @brief field end
+    *
+    * This points behind the last character of the field.
+    *********************************************************************/
+    const char * end;
+
+};
+/*****************************************************************//**
+* @brief line reader class
+*
+* This represents a buffered reader returning the lines of a file one
+* after another without copying them.
+* The file is read in large blocks and the returned lines point into
+* the reader's buffer, so they are only valid until the next line is
+* requested.
+* Like std::getline loops checking the stream state, only lines
+* terminated by a newline are returned (a last line missing the
+* newline is ignored).
+* The reader can be restricted to the lines starting in a byte range
+* of the file, allowing to split a file into slices at line
+* boundaries without reading the other slices.
+* Files compressed with gzip (or bgzip) are decompressed transparently
+* (offsets then refer to the decompressed data), but cannot be
+* restricted to a range.
+*
+* @see gzipDecoder
+*
+* @see fieldView
+*********************************************************************/
+
+class lineReader {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a lineReader for a given file.
+    * If the file cannot be opened for reading the reader is created but
+    * won't return any lines (see @p is_open).
+    * If the file is a gzip file, its decompressed lines are returned.
+    *
+    * @param the_path filePath to the file to be read
+    * @param the_block_size (optional) size_t representing the number of
+    *     bytes to read at once - Defaults to 4 MiB
+    *
+    * @return lineReader for the given file
+    *
+    * @see is_open()
+    *********************************************************************/
+    lineReader(const filePath & the_path, size_t the_block_size = 4194304);
+
+    /*****************************************************************//**
+    * @brief constructor from file descriptor
+    *
+    * This is used to create a lineReader for an already opened file
+    * descriptor (e.g. a socket or pipe).
+    * The reader takes over the descriptor and closes it when it is
+    * destroyed.
+    *
+    * @param the_fd int representing the file descriptor to read from
+    * @param the_block_size (optional) size_t representing the maximal
+    *     number of bytes to read at once - Defaults to 4 MiB
+    *
+    * @return lineReader for the given file descriptor
+    *********************************************************************/
+    lineReader(int the_fd, size_t the_block_size = 4194304);
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to close the file read by the reader.
+    *********************************************************************/
+    ~lineReader();
+
+    /*****************************************************************//**
+    * @brief file state
+    *
+    * This method is used to check whether the file could be opened.
+    *
+    * @return true if the file is open for reading, false otherwise
+    *********************************************************************/
+    inline bool is_open() const;
+
+    /*****************************************************************//**
+    * @brief compression state
+    *
+    * This method is used to check whether the file is decompressed.
+    *
+    * @return true if the file is a gzip file, false otherwise
+    *********************************************************************/
+    inline bool is_compressed() const;
+
+    /*****************************************************************//**
+    * @brief end of file state
+    *
+    * This method is used to check whether all of the file was returned
+    * (i.e. there is no last line missing the newline).
+    *
+    * @return true if the end of the file was reached and all characters
+    *     were returned, false otherwise
+    *********************************************************************/
+    inline bool at_end() const;
+
+    /*****************************************************************//**
+    * @brief next line
+    *
+    * This method is used to get the next line of the file.
+    * The returned line excludes the newline character which is replaced
+    * by a terminating null character in the buffer.
+    *
+    * @param line fieldView reference the line is assigned to
+    *
+    * @return true if a line was assigned, false at the end of the file
+    *     or if the file cannot be read
+    *********************************************************************/
+    bool next_line(fieldView & line);
+
+    /*****************************************************************//**
+    * @brief range restriction
+    *
+    * This method is used to restrict the reader to the lines starting in
+    * a given byte range of the file.
+    * The reader continues at the first line starting at or behind
+    * @p begin and stops before the first line starting at or behind
+    * @p end, so consecutive ranges split the file into slices of
+    * complete lines.
+    *
+    * @param begin off_t representing the offset the range starts at
+    * @param end off_t representing the offset behind the range
+    *
+    * @return true if the reader could be positioned, false otherwise
+    *     (e.g. for compressed files)
+    *********************************************************************/
+    bool set_range(off_t begin, off_t end);
+
+    /*****************************************************************//**
+    * @brief get method for read offset
+    *
+    * This method is used to access the offset of the next line in the
+    * file (i.e. behind the last line returned).
+    *
+    * @return the file offset of the next line
+    *********************************************************************/
+    inline off_t get_offset() const;
+
+    /*****************************************************************//**
+    * @brief get method for file size
+    *
+    * This method is used to access the size of the file read.
+    *
+    * @return the size of the file in bytes (or -1 if it is unknown, e.g.
+    *     for compressed files)
+    *********************************************************************/
+    off_t get_size() const;
+
+    /*****************************************************************//**
+    * @brief field splitting
+    *
+    * This method is used to split a line at tab characters into exactly
+    * the given number of fields.
+    * If @p first_takes_rest is set, additional tab characters are taken
+    * as part of the first field (like a greedy leading '(.+)\t' regular
+    * expression group would do), otherwise lines with additional tab
+    * characters are rejected.
+    *
+    * @param line const fieldView reference to the line to be split
+    * @param fields fieldView array the fields are assigned to (must hold
+    *     at least @p field_count fields)
+    * @param field_count unsigned short representing the number of fields
+    * @param first_takes_rest (optional) bool indicating whether
+    *     additional tab characters belong to the first field - Defaults
+    *     to false
+    *
+    * @return true if the line contains the requested number of fields,
+    *     false otherwise
+    *********************************************************************/
+    static bool split_fields(const fieldView & line, fieldView fields[], unsigned short field_count, bool first_takes_rest = false);
+
+    /*****************************************************************//**
+    * @brief position field conversion
+    *
+    * This method is used to convert a field consisting of decimal digits
+    * only to a chromosomePosition.
+    * Values exceeding the range of chromosomePosition are set to its
+    * maximum.
+    *
+    * @param field const fieldView reference to the field
+    * @param position chromosomePosition reference the value is assigned
+    *     to
+    *
+    * @return true if the field is a non-empty digit string, false
+    *     otherwise
+    *********************************************************************/
+    static bool parse_position(const fieldView & field, chromosomePosition & position);
+
+    /*****************************************************************//**
+    * @brief score field conversion
+    *
+    * This method is used to convert a field consisting of digits,
+    * decimal points, signs and exponent characters (e) only to a
+    * conservationScore.
+    * The field must be followed by a tab or a null character.
+    *
+    * @param field const fieldView reference to the field
+    * @param score conservationScore reference the value is assigned to
+    *
+    * @return true if the field is a non-empty string of valid
+    *     characters, false otherwise
+    *********************************************************************/
+    static bool parse_score(const fieldView & field, conservationScore & score);
+
+
+  private:
+    /*****************************************************************//**
+    * @brief copy constructor - not implemented
+    *
+    * A reader owns its file descriptor and cannot be copied.
+    *********************************************************************/
+    lineReader(const lineReader & the_reader);
+
+    /*****************************************************************//**
+    * @brief assignment operator - not implemented
+    *
+    * A reader owns its file descriptor and cannot be assigned.
+    *********************************************************************/
+    lineReader & operator=(const lineReader & the_reader);
+
+    /*****************************************************************//**
+    * @brief buffer refill
+    *
+    * This method is used to move the unread rest of the buffer to its
+    * front and to read the next block of the file behind it (growing
+    * the buffer if a single line does not fit).
+    *
+    * @return true if new data was read, false at the end of the file or
+    *     on errors
+    *********************************************************************/
+    bool refill();
+
+    /*****************************************************************//**
+    * @brief file descriptor
+    *
+    * This is the descriptor of the file read (or -1 if the file could
+    * not be opened).
+    *********************************************************************/
+    int fd;
+
+    /*****************************************************************//**
+    * @brief decoder
+    *
+    * This decompresses the file if it is a gzip file (or is NULL
+    * otherwise).
+    *********************************************************************/
+    gzipDecoder * decoder;
+
+    /*****************************************************************//**
+    * @brief block size
+    *
+    * This is the number of bytes read at once.
+    *********************************************************************/
+    const size_t block_size;
+
+    /*****************************************************************//**
+    * @brief buffer
+    *
+    * This holds the block(s) read from the file.
+    *********************************************************************/
+    std::vector<char> buffer;
+
+    /*****************************************************************//**
+    * @brief read position
+    *
+    * This is the buffer index of the first character not yet returned.
+    *********************************************************************/
+    size_t position;
+
+    /*****************************************************************//**
+    * @brief filled size
+    *
+    * This is the number of valid characters in the buffer.
+    *********************************************************************/
+    size_t filled;
+
+    /*****************************************************************//**
+    * @brief buffer offset
+    *
+    * This is the offset of the first character of the buffer in the
+    * file.
+    *********************************************************************/
+    off_t buffer_offset;
+
+    /*****************************************************************//**
+    * @brief range end
+    *
+    * This is the offset no line returned may start at or behind (or -1
+    * if the reader is not restricted).
+    *********************************************************************/
+    off_t range_end;
+
+    /*****************************************************************//**
+    * @brief end of file flag
+    *
+    * This indicates whether the whole file was read into the buffer.
+    *********************************************************************/
+    bool end_of_file;
+
+};
+    /*****************************************************************//**
+    * @brief file state
+    *
+    * This method is used to check whether the file could be opened.
+    *
+    * @return true if the file is open for reading, false otherwise
+    *********************************************************************/
+    inline bool lineReader::is_open() const {
+      return fd >= 0;
+}
+
+    /*****************************************************************//**
+    * @brief compression state
+    *
+    * This method is used to check whether the file is decompressed.
+    *
+    * @return true if the file is a gzip file, false otherwise
+    *********************************************************************/
+    inline bool lineReader::is_compressed() const {
+      return decoder != NULL;
+}
+
+    /*****************************************************************//**
+    * @brief end of file state
+    *
+    * This method is used to check whether all of the file was returned
+    * (i.e. there is no last line missing the newline).
+    *
+    * @return true if the end of the file was reached and all characters
+    *     were returned, false otherwise
+    *********************************************************************/
+    inline bool lineReader::at_end() const {
+      return end_of_file && position == filled;
+}
+
+    /*****************************************************************//**
+    * @brief get method for read offset
+    *
+    * This method is used to access the offset of the next line in the
+    * file (i.e. behind the last line returned).
+    *
+    * @return the file offset of the next line
+    *********************************************************************/
+    inline off_t lineReader::get_offset() const {
+      return buffer_offset + position;
+}
+
+
+} // namespace microSNPscore
+#endif
@@ -0,0 +1,125 @@
+#ifndef MICROSNPSCORE_MESSAGECAPTURE_H
+#define MICROSNPSCORE_MESSAGECAPTURE_H
+
+
+#include <string>
+#include <iostream>
+#include <streambuf>
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief message capture class
+*
+* This represents a stream buffer collecting the messages written to a
+* stream (like std::cerr) per thread.
+* While it exists, it replaces the buffer of the stream: text written
+* by a thread that has a capture target set (see @p set_target) is
+* appended to this target, text written by other threads is passed on
+* to the original buffer.
+* This allows threads working on parts of a job in parallel to report
+* errors which are printed in the order the parts would have been done
+* one after another.
+*********************************************************************/
+
+class messageCapture : public std::streambuf {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a messageCapture replacing the buffer of a
+    * given stream.
+    *
+    * @param the_stream std::ostream reference to the stream whose
+    *     messages should be captured
+    *
+    * @return messageCapture for the given stream
+    *********************************************************************/
+    messageCapture(std::ostream & the_stream);
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to give the stream its original buffer back.
+    *********************************************************************/
+    ~messageCapture();
+
+    /*****************************************************************//**
+    * @brief capture target setting
+    *
+    * This method is used to set the string the messages written by the
+    * calling thread are appended to.
+    *
+    * @param target std::string pointer to the string the messages should
+    *     be appended to (or NULL to pass them on to the stream)
+    *********************************************************************/
+    static void set_target(std::string * target);
+
+
+  protected:
+    /*****************************************************************//**
+    * @brief character output
+    *
+    * This method is used by the stream to write a single character.
+    *
+    * @param character int representing the character to write
+    *
+    * @return the character written or EOF on errors
+    *********************************************************************/
+    int overflow(int character);
+
+    /*****************************************************************//**
+    * @brief text output
+    *
+    * This method is used by the stream to write several characters.
+    *
+    * @param text const char pointer to the characters to write
+    * @param count std::streamsize representing the number of characters
+    *
+    * @return the number of characters written
+    *********************************************************************/
+    std::streamsize xsputn(const char * text, std::streamsize count);
+
+    /*****************************************************************//**
+    * @brief synchronization
+    *
+    * This method is used by the stream to flush written characters.
+    *
+    * @return 0 on success, -1 on errors
+    *********************************************************************/
+    int sync();
+
+
+  private:
+    /*****************************************************************//**
+    * @brief copy constructor - not implemented
+    *
+    * A capture replaces the buffer of a stream and cannot be copied.
+    *********************************************************************/
+    messageCapture(const messageCapture & the_capture);
+
+    /*****************************************************************//**
+    * @brief assignment operator - not implemented
+    *
+    * A capture replaces the buffer of a stream and cannot be assigned.
+    *********************************************************************/
+    messageCapture & operator=(const messageCapture & the_capture);
+
+    /*****************************************************************//**
+    * @brief captured stream
+    *
+    * This is the stream whose buffer is replaced.
+    *********************************************************************/
+    std::ostream & stream;
+
+    /*****************************************************************//**
+    * @brief original buffer
+    *
+    * This is the buffer of the stream before it was replaced.
+    *********************************************************************/
+    std::streambuf * const original;
+
+};
+
+} // namespace microSNPscore
+#endif
@@ -50,8 +50,9 @@ class miRNA : public sequence {
     * are treated as masked, respectively.
     *
     * @param the_ID sequenceID representing the ID of the miRNA
-    * @param sequence_string String representing the nucleotide sequence
-    *     (Adenine: A, Cytosine: C, Guanine: G, Uracil: U, Mask: X)
+    * @param sequence_string nucleotideText representing the nucleotide
+    *     sequence (Adenine: A, Cytosine: C, Guanine: G, Uracil: U,
+    *     Mask: X) which may be interrupted by newlines
     * @param the_chromosome chromosomeType representing the chromosome the
     *     miRNA is located on
     * @param the_strand strandType representing the strand (Plus/Minus) on
@@ -66,15 +67,13 @@ class miRNA : public sequence {
     *     the 3' end of the + strand and accordingly the 5' end of
     *     the - strand) of the exons containing the miRNA as
     *     comma-separated list.
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the sequence
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return a miRNA containing the given nucleotides located on the
     *     given chromosome, strand and positions.
     *********************************************************************/
-    miRNA(sequenceID the_id, std::string sequence_string, chromosomeType the_chromosome, strandType the_strand, std::string exon_starts, std::string exon_ends, const conservationList & conservations, bool verbose = false);
+    miRNA(sequenceID the_id, nucleotideText sequence_string, chromosomeType the_chromosome, strandType the_strand, std::string exon_starts, std::string exon_ends, bool verbose = false);
 
     /*****************************************************************//**
     * @brief standard constructor - do not use directly
@@ -107,6 +106,8 @@ class miRNA : public sequence {
     *     position 1) that is predicted to be the mRNA nucleotide that
     *     would bind the miRNA 5' end (if it would bind) (i.e. one base
     *     downstream (3') from the seed match region)
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
@@ -115,7 +116,7 @@ class miRNA : public sequence {
     *
     * @see SNP::get_deregulation_score()
     *********************************************************************/
-    downregulationScore get_downregulation_score(const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, bool verbose = false) const;
+    downregulationScore get_downregulation_score(const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, const conservationList & conservations, bool verbose = false) const;
 
 
   private:
@@ -149,6 +150,8 @@ class miRNA : public sequence {
     *     downstream (3') from the seed match region)
     * @param the_alignment an alignment that is considered to be the best
     *     one for the miRNA-induced downregulation
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
@@ -158,7 +161,7 @@ class miRNA : public sequence {
     *
     * @see get_downregulation_score()
     *********************************************************************/
-    static downregulationScore downregulation_score_candidate(const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, const alignment & the_alignment, bool verbose = false);
+    static downregulationScore downregulation_score_candidate(const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, const alignment & the_alignment, const conservationList & conservations, bool verbose = false);
 
     /*****************************************************************//**
     * @brief secondary structure features calculation
@@ -188,9 +191,15 @@ class miRNA : public sequence {
     *
     * This method is used to calculate the conservation feature for the
     * downregulation score calculation.
+    * The conservation scores are only looked up for the mRNA nucleotides
+    * of the alignment.
     *
     * @param the_alignment an alignment that is considered to be the best
     *     one for the miRNA-induced downregulation
+    * @param the_chromosome const chromosomeType reference to the
+    *     chromosome the mRNA is located on
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
@@ -199,7 +208,7 @@ class miRNA : public sequence {
     *
     * @see downregulation_score_candidate()
     *********************************************************************/
-    static downregulationScore calculate_conservation_feature(const alignment & the_alignment, bool verbose = false);
+    static downregulationScore calculate_conservation_feature(const alignment & the_alignment, const chromosomeType & the_chromosome, const conservationList & conservations, bool verbose = false);
 
     /*****************************************************************//**
     * @brief local AU content feature calculation
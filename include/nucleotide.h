@@ -4,6 +4,8 @@
 
 #include <iostream>
 //for std::ostream (operator<<)
+#include <climits>
+//for SHRT_MIN (unconserved offset)
 namespace microSNPscore {
 
 /*****************************************************************//**
@@ -213,6 +215,15 @@ class matchType {
 * This represents a score of a conservation range
 *********************************************************************/
 typedef double conservationScore;
+
+/*****************************************************************//**
+* @brief conservation offset type
+*
+* This represents the distance between the chromosome position of a
+* nucleotide and the position whose conservation it has (which differ
+* once an indel moved the nucleotide).
+*********************************************************************/
+typedef short conservationOffset;
 /*****************************************************************//**
 * @brief nucleotide class
 *
@@ -220,6 +231,14 @@ typedef double conservationScore;
 *********************************************************************/
 class nucleotide {
   public:
+    /*****************************************************************//**
+    * @brief unconserved offset
+    *
+    * This is the conservation offset of nucleotides without conservation
+    * (i.e. with zero conservation).
+    *********************************************************************/
+    static const conservationOffset unconserved = SHRT_MIN;
+
     /*****************************************************************//**
     * @brief constructor - Do not call without parameter values!
     *
@@ -242,14 +261,17 @@ class nucleotide {
     *     nucleotide, the 5' end of the + strand (i.e. the 3' end of
     *     the - strand) beeing position 1 (gaps should be given the
     *     position of their predecessor in the alignment) - Defaults to 0
-    * @param the_conservation (pseudo-optional) conservation score of the
-    *     nucleotide - Defaults to 0
+    * @param the_conservation_offset (optional) conservationOffset that
+    *     represents the distance between the position on the chromosome
+    *     and the position whose conservation the nucleotide has (or
+    *     @p unconserved for nucleotides without one, e.g. inserted by a
+    *     SNP) - Defaults to 0
     *
     * @return a nucleotide containing the given nucleo base and located at
-    *     the given positions on chromosome and in sequence with the given
-    *     conservation score
+    *     the given positions on chromosome and in sequence with the
+    *     conservation of the given position
     *********************************************************************/
-    nucleotide(nucleoBase the_base = Mask, sequencePosition the_sequence_position = 0, chromosomePosition the_chromosome_position = 0, conservationScore the_conservation = 0);
+    nucleotide(nucleoBase the_base = Mask, sequencePosition the_sequence_position = 0, chromosomePosition the_chromosome_position = 0, conservationOffset the_conservation_offset = 0);
 
     /*****************************************************************//**
     * @brief get method for nucleo base attribute
@@ -284,14 +306,43 @@ class nucleotide {
     inline const chromosomePosition get_chromosome_position() const;
 
     /*****************************************************************//**
-    * @brief get method for conservation score attribute
+    * @brief get method for conservation offset attribute
     *
-    * This method is used to access the conservations score of the
-    * nucleotide.
+    * This method is used to access the distance between the position of
+    * the nucleotide on its chromosome and the position whose
+    * conservation it has.
     *
-    * @return the conservation score of the nucleotide
+    * @return the conservation offset of the nucleotide (@p unconserved
+    *     for nucleotides without conservation)
     *********************************************************************/
-    inline const conservationScore get_conservation() const;
+    inline const conservationOffset get_conservation_offset() const;
+
+    /*****************************************************************//**
+    * @brief conservation state
+    *
+    * This method is used to check whether the nucleotide has the
+    * conservation of a position on its chromosome (and not zero
+    * conservation like nucleotides inserted by a SNP).
+    *
+    * @return true if the nucleotide has a conservation position, false
+    *     otherwise
+    *********************************************************************/
+    inline bool is_conserved() const;
+
+    /*****************************************************************//**
+    * @brief get method for conservation position
+    *
+    * This method is used to access the position on the chromosome whose
+    * conservation score the nucleotide has (i.e. its position before
+    * indels moved it), so the score can be looked up in a
+    * conservationList when it is needed.
+    *
+    * @return the conservation position of the nucleotide (only
+    *     meaningful if it is conserved)
+    *
+    * @see is_conserved()
+    *********************************************************************/
+    inline const chromosomePosition get_conservation_position() const;
 
     /*****************************************************************//**
     * @brief match calculation
@@ -357,11 +408,10 @@ class nucleotide {
     sequencePosition sequence_position;
 
     /*****************************************************************//**
-    * @brief position on chromosome
+    * @brief conservation offset
     *
-    * This is the nucleotide's position on its chromosome, the 5' end of
-    * the + strand (i.e. the 3' end of the - strand) beeing position 1.
-    * Gaps are given the position of their predecessors in the alignment.
+    * This is the distance between the nucleotide's chromosome position
+    * and the position whose conservation it has (or @p unconserved).
     * It should be const but because nucleotides shall be used in a vector
     * and std::vector tries to assign its elements to an internal array it
     * needs a working assignment operator which has to change the object's
@@ -374,12 +424,14 @@ class nucleotide {
     *
     * @see nucleotide()
     *********************************************************************/
-    chromosomePosition chromosome_position;
+    conservationOffset conservation_offset;
 
     /*****************************************************************//**
-    * @brief conservation score
+    * @brief position on chromosome
     *
-    * This is the nucleotide's conservation score.
+    * This is the nucleotide's position on its chromosome, the 5' end of
+    * the + strand (i.e. the 3' end of the - strand) beeing position 1.
+    * Gaps are given the position of their predecessors in the alignment.
     * It should be const but because nucleotides shall be used in a vector
     * and std::vector tries to assign its elements to an internal array it
     * needs a working assignment operator which has to change the object's
@@ -392,7 +444,7 @@ class nucleotide {
     *
     * @see nucleotide()
     *********************************************************************/
-    conservationScore conservation;
+    chromosomePosition chromosome_position;
 
 };
     /*****************************************************************//**
@@ -434,15 +486,48 @@ class nucleotide {
     }
 
     /*****************************************************************//**
-    * @brief get method for conservation score attribute
+    * @brief get method for conservation offset attribute
+    *
+    * This method is used to access the distance between the position of
+    * the nucleotide on its chromosome and the position whose
+    * conservation it has.
+    *
+    * @return the conservation offset of the nucleotide (@p unconserved
+    *     for nucleotides without conservation)
+    *********************************************************************/
+    inline const conservationOffset nucleotide::get_conservation_offset() const {
+      return conservation_offset;
+    }
+
+    /*****************************************************************//**
+    * @brief conservation state
+    *
+    * This method is used to check whether the nucleotide has the
+    * conservation of a position on its chromosome (and not zero
+    * conservation like nucleotides inserted by a SNP).
+    *
+    * @return true if the nucleotide has a conservation position, false
+    *     otherwise
+    *********************************************************************/
+    inline bool nucleotide::is_conserved() const {
+      return conservation_offset != unconserved;
+    }
+
+    /*****************************************************************//**
+    * @brief get method for conservation position
+    *
+    * This method is used to access the position on the chromosome whose
+    * conservation score the nucleotide has (i.e. its position before
+    * indels moved it), so the score can be looked up in a
+    * conservationList when it is needed.
     *
-    * This method is used to access the conservations score of the
-    * nucleotide.
+    * @return the conservation position of the nucleotide (only
+    *     meaningful if it is conserved)
     *
-    * @return the conservation score of the nucleotide
+    * @see is_conserved()
     *********************************************************************/
-    inline const conservationScore nucleotide::get_conservation() const {
-      return conservation;
+    inline const chromosomePosition nucleotide::get_conservation_position() const {
+      return chromosome_position - conservation_offset;
     }
 
 /*****************************************************************//**
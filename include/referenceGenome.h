@@ -0,0 +1,182 @@
+#ifndef MICROSNPSCORE_REFERENCEGENOME_H
+#define MICROSNPSCORE_REFERENCEGENOME_H
+
+
+#include <string>
+#include <map>
+#include <stddef.h>
+#include <sys/types.h>
+//for off_t (index offsets)
+#include "sequence.h"
+#include "filePath.h"
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief genome index entry
+*
+* This represents a line of a FASTA index (.fai file as written by
+* samtools faidx) describing where the bases of a chromosome are
+* located in the genome FASTA file.
+*
+* @see referenceGenome
+*********************************************************************/
+struct genomeIndexEntry {
+    /*****************************************************************//**
+    * @brief chromosome length
+    *
+    * This is the number of bases of the chromosome.
+    *********************************************************************/
+    chromosomePosition length;
+
+    /*****************************************************************//**
+    * @brief sequence offset
+    *
+    * This is the offset of the first base of the chromosome in the
+    * genome file.
+    *********************************************************************/
+    off_t offset;
+
+    /*****************************************************************//**
+    * @brief bases per line
+    *
+    * This is the number of bases in each (but the last) sequence line
+    * of the chromosome.
+    *********************************************************************/
+    off_t line_bases;
+
+    /*****************************************************************//**
+    * @brief bytes per line
+    *
+    * This is the number of bytes of each (but the last) sequence line
+    * of the chromosome including its line break.
+    *********************************************************************/
+    off_t line_width;
+
+};
+/*****************************************************************//**
+* @brief reference genome class
+*
+* This represents a genome FASTA file indexed by samtools faidx (i.e.
+* with a .fai file next to it) the bases of any chromosome range can
+* be taken from.
+* The genome file is memory-mapped when opened, so only the pages of
+* the ranges actually requested are read (and shared with other
+* processes using the genome).
+*
+* @see transcriptAnnotation
+*********************************************************************/
+
+class referenceGenome {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to open an indexed genome FASTA file.
+    * If the file or its index (the file path followed by .fai) cannot be
+    * read or they do not fit each other an error is raised and the
+    * genome is created but won't return any bases (see @p is_open).
+    *
+    * @param the_path filePath to the genome FASTA file
+    *
+    * @return referenceGenome for the given file
+    *
+    * @see is_open()
+    *********************************************************************/
+    referenceGenome(const filePath & the_path);
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to unmap the genome file.
+    *********************************************************************/
+    ~referenceGenome();
+
+    /*****************************************************************//**
+    * @brief get method for opening state
+    *
+    * This method is used to check whether the genome was opened
+    * successfully.
+    *
+    * @return true if the genome can be read, false otherwise
+    *********************************************************************/
+    inline bool is_open() const;
+
+    /*****************************************************************//**
+    * @brief base extraction
+    *
+    * This method is used to append the (+ strand) bases of a range of a
+    * chromosome to a string as they are written in the genome file.
+    *
+    * @param bases std::string reference the bases are appended to
+    * @param chromosome const chromosomeType reference to the chromosome
+    * @param start chromosomePosition of the first base of the range
+    *     (counted from 1)
+    * @param end chromosomePosition of the last base of the range
+    *
+    * @return true if the bases were appended, false if the chromosome is
+    *     not in the genome or the range is not on it
+    *********************************************************************/
+    bool append_bases(std::string & bases, const chromosomeType & chromosome, chromosomePosition start, chromosomePosition end) const;
+
+
+  private:
+    /*****************************************************************//**
+    * @brief copy constructor - not implemented
+    *
+    * A genome owns its mapping and cannot be copied.
+    *********************************************************************/
+    referenceGenome(const referenceGenome & the_genome);
+
+    /*****************************************************************//**
+    * @brief assignment operator - not implemented
+    *
+    * A genome owns its mapping and cannot be assigned.
+    *********************************************************************/
+    referenceGenome & operator=(const referenceGenome & the_genome);
+
+    /*****************************************************************//**
+    * @brief file path
+    *
+    * This is the path of the genome file (used in error messages).
+    *********************************************************************/
+    const filePath path;
+
+    /*****************************************************************//**
+    * @brief chromosome index
+    *
+    * This holds the index entry of every chromosome of the genome.
+    *********************************************************************/
+    std::map<chromosomeType,genomeIndexEntry> chromosomes;
+
+    /*****************************************************************//**
+    * @brief file mapping
+    *
+    * This is the memory-mapped genome file (or NULL if the genome could
+    * not be opened).
+    *********************************************************************/
+    const char * mapping;
+
+    /*****************************************************************//**
+    * @brief mapping size
+    *
+    * This is the size of the mapped file in bytes.
+    *********************************************************************/
+    size_t mapping_size;
+
+};
+    /*****************************************************************//**
+    * @brief get method for opening state
+    *
+    * This method is used to check whether the genome was opened
+    * successfully.
+    *
+    * @return true if the genome can be read, false otherwise
+    *********************************************************************/
+    inline bool referenceGenome::is_open() const {
+      return mapping != NULL;
+}
+
+
+} // namespace microSNPscore
+#endif
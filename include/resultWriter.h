@@ -0,0 +1,235 @@
+#ifndef MICROSNPSCORE_RESULTWRITER_H
+#define MICROSNPSCORE_RESULTWRITER_H
+
+
+#include <string>
+#include <vector>
+#include "nucleotide.h"
+#include "workerPool.h"
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief result writer class
+*
+* This represents a buffered writer for result lines.
+* Results are collected in a large buffer which is written to the
+* output file descriptor in big blocks when it is full, after a given
+* number of results (to allow following a running job) and when the
+* writer is flushed or destroyed.
+* It also provides the number formatting used for result lines without
+* the overhead of output streams.
+*
+* @see resultSink
+*********************************************************************/
+
+class resultWriter : public resultSink {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a resultWriter for a given file descriptor.
+    * The file descriptor is not closed by the writer.
+    *
+    * @param the_fd (optional) int representing the file descriptor to
+    *     write to - Defaults to 1 (STDOUT)
+    * @param the_flush_every (optional) unsigned long representing the
+    *     number of results after which the buffer is written even if it
+    *     is not full (0 means only full buffers are written) - Defaults
+    *     to 0
+    * @param the_buffer_size (optional) size_t representing the size of
+    *     the buffer - Defaults to 1 MiB
+    *
+    * @return resultWriter for the given file descriptor
+    *********************************************************************/
+    resultWriter(int the_fd = 1, unsigned long the_flush_every = 0, size_t the_buffer_size = 1048576);
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to write the remaining buffer content before
+    * destroying the writer.
+    *********************************************************************/
+    ~resultWriter();
+
+    /*****************************************************************//**
+    * @brief result insertion
+    *
+    * This method is used to append a result (one or more complete
+    * lines) to the buffer writing the buffer if it is full or if the
+    * number of results given at construction was reached.
+    * Empty results are ignored.
+    *
+    * @param result const std::string reference to the result
+    *********************************************************************/
+    void put_result(const std::string & result);
+
+    /*****************************************************************//**
+    * @brief buffer writing
+    *
+    * This method is used to write the buffer content to the file
+    * descriptor.
+    * If writing fails an error is raised (only once) and all further
+    * output is discarded.
+    *
+    * @return true if the buffer was written, false otherwise
+    *********************************************************************/
+    bool flush();
+
+    /*****************************************************************//**
+    * @brief get method for failure state
+    *
+    * This method is used to check whether writing has failed.
+    *
+    * @return true if writing has failed, false otherwise
+    *********************************************************************/
+    inline bool failed() const;
+
+    /*****************************************************************//**
+    * @brief get method for written bytes
+    *
+    * This method is used to access the number of bytes written to the
+    * file descriptor so far (excluding the buffer content).
+    *
+    * @return the number of bytes written
+    *********************************************************************/
+    inline unsigned long long get_written() const;
+
+    /*****************************************************************//**
+    * @brief position formatting
+    *
+    * This method is used to append the decimal representation of a
+    * chromosome position to a string.
+    *
+    * @param line std::string reference to append to
+    * @param position chromosomePosition to be appended
+    *********************************************************************/
+    static void append_position(std::string & line, chromosomePosition position);
+
+    /*****************************************************************//**
+    * @brief score formatting
+    *
+    * This method is used to append the decimal representation of a
+    * score to a string.
+    * By default the score is represented like an output stream with
+    * default settings would do (6 significant digits) to keep the output
+    * compatible. Otherwise the shortest representation that is read back
+    * as exactly the same value is used (generated with the Grisu2
+    * algorithm, which may exceed the shortest one by a digit in rare
+    * cases).
+    *
+    * @param line std::string reference to append to
+    * @param score double to be appended
+    * @param shortest (optional) bool indicating whether the shortest
+    *     exact representation should be used - Defaults to false
+    *********************************************************************/
+    static void append_score(std::string & line, double score, bool shortest = false);
+
+
+  private:
+    /*****************************************************************//**
+    * @brief copy constructor - not implemented
+    *
+    * A writer owns its buffer and cannot be copied.
+    *********************************************************************/
+    resultWriter(const resultWriter & the_writer);
+
+    /*****************************************************************//**
+    * @brief assignment operator - not implemented
+    *
+    * A writer owns its buffer and cannot be assigned.
+    *********************************************************************/
+    resultWriter & operator=(const resultWriter & the_writer);
+
+    /*****************************************************************//**
+    * @brief block writing
+    *
+    * This method is used to write a block of characters to the file
+    * descriptor.
+    * If writing fails an error is raised (only once) and all further
+    * output is discarded.
+    *
+    * @param block const char pointer to the first character to write
+    * @param size size_t representing the number of characters to write
+    *
+    * @return true if the block was written, false otherwise
+    *********************************************************************/
+    bool write_block(const char * block, size_t size);
+
+    /*****************************************************************//**
+    * @brief file descriptor
+    *
+    * This is the descriptor of the file written to.
+    *********************************************************************/
+    const int fd;
+
+    /*****************************************************************//**
+    * @brief flush interval
+    *
+    * This is the number of results after which the buffer is written
+    * even if it is not full (0 means never).
+    *********************************************************************/
+    const unsigned long flush_every;
+
+    /*****************************************************************//**
+    * @brief buffer
+    *
+    * This holds the results not yet written.
+    *********************************************************************/
+    std::vector<char> buffer;
+
+    /*****************************************************************//**
+    * @brief filled size
+    *
+    * This is the number of valid characters in the buffer.
+    *********************************************************************/
+    size_t filled;
+
+    /*****************************************************************//**
+    * @brief buffered results
+    *
+    * This is the number of results inserted since the last flush.
+    *********************************************************************/
+    unsigned long buffered_results;
+
+    /*****************************************************************//**
+    * @brief written bytes
+    *
+    * This is the number of bytes written to the file descriptor.
+    *********************************************************************/
+    unsigned long long written;
+
+    /*****************************************************************//**
+    * @brief failure flag
+    *
+    * This indicates whether writing has failed.
+    *********************************************************************/
+    bool write_failed;
+
+};
+    /*****************************************************************//**
+    * @brief get method for failure state
+    *
+    * This method is used to check whether writing has failed.
+    *
+    * @return true if writing has failed, false otherwise
+    *********************************************************************/
+    inline bool resultWriter::failed() const {
+      return write_failed;
+}
+
+    /*****************************************************************//**
+    * @brief get method for written bytes
+    *
+    * This method is used to access the number of bytes written to the
+    * file descriptor so far (excluding the buffer content).
+    *
+    * @return the number of bytes written
+    *********************************************************************/
+    inline unsigned long long resultWriter::get_written() const {
+      return written;
+}
+
+
+} // namespace microSNPscore
+#endif
@@ -9,7 +9,6 @@
 #include <vector>
 
 namespace microSNPscore { class nucleotide; } 
-namespace microSNPscore { class conservationList; } 
 namespace microSNPscore { class SNP; } 
 
 
@@ -188,6 +187,128 @@ class exon {
       return end;
     }
 
+/*****************************************************************//**
+* @brief nucleotide text class
+*
+* This represents the letter code nucleotides of a sequence as a range
+* of characters without copying them (e.g. the sequence lines of a
+* FASTA entry in a memory-mapped file).
+* The range may be interrupted by newlines which are not part of the
+* text.
+* A nucleotideText does not own the characters, so it is only valid
+* as long as the string or mapping it refers to.
+*
+* @see sequence
+*********************************************************************/
+class nucleotideText {
+  public:
+    /*****************************************************************//**
+    * @brief constructor from string
+    *
+    * This is used to create a nucleotideText referring to the characters
+    * of a given string.
+    *
+    * @param the_string const std::string reference to the nucleotides
+    *
+    * @return nucleotideText for the given string
+    *********************************************************************/
+    nucleotideText(const std::string & the_string);
+
+    /*****************************************************************//**
+    * @brief constructor from character range
+    *
+    * This is used to create a nucleotideText referring to a given range
+    * of characters.
+    *
+    * @param the_begin const char pointer to the first character
+    * @param the_end const char pointer behind the last character
+    *
+    * @return nucleotideText for the given character range
+    *********************************************************************/
+    nucleotideText(const char * the_begin, const char * the_end);
+
+    /*****************************************************************//**
+    * @brief text begin
+    *
+    * This is used to get the first character of the range.
+    *
+    * @return const char pointer to the first character of the range
+    *********************************************************************/
+    inline const char * begin() const;
+
+    /*****************************************************************//**
+    * @brief text end
+    *
+    * This is used to get the end of the range.
+    *
+    * @return const char pointer behind the last character of the range
+    *********************************************************************/
+    inline const char * end() const;
+
+    /*****************************************************************//**
+    * @brief length calculation
+    *
+    * This method is used to count the characters of the text (i.e.
+    * without newlines).
+    *
+    * @return the number of characters of the text
+    *********************************************************************/
+    std::string::size_type get_length() const;
+
+    /*****************************************************************//**
+    * @brief string conversion
+    *
+    * This method is used to copy a part of the text to a string
+    * (omitting newlines).
+    *
+    * @param from (optional) const char pointer to the first character of
+    *     the range to copy - Defaults to NULL (the begin of the text)
+    * @param to (optional) const char pointer behind the last character
+    *     of the range to copy - Defaults to NULL (the end of the text)
+    *
+    * @return string containing the characters of the given range
+    *********************************************************************/
+    std::string get_string(const char * from = NULL, const char * to = NULL) const;
+
+
+  private:
+    /*****************************************************************//**
+    * @brief first character
+    *
+    * This points to the first character of the range.
+    *********************************************************************/
+    const char * first;
+
+    /*****************************************************************//**
+    * @brief range end
+    *
+    * This points behind the last character of the range.
+    *********************************************************************/
+    const char * last;
+
+};
+    /*****************************************************************//**
+    * @brief text begin
+    *
+    * This is used to get the first character of the range.
+    *
+    * @return const char pointer to the first character of the range
+    *********************************************************************/
+    inline const char * nucleotideText::begin() const {
+      return first;
+    }
+
+    /*****************************************************************//**
+    * @brief text end
+    *
+    * This is used to get the end of the range.
+    *
+    * @return const char pointer behind the last character of the range
+    *********************************************************************/
+    inline const char * nucleotideText::end() const {
+      return last;
+    }
+
 /*****************************************************************//**
 * @brief sequence class
 *
@@ -222,6 +343,7 @@ class sequence {
     * T is understood as Thymine and is treated as Uracil (simulating
     * transscription).
     * Dashes (-) are understood as Gaps and are omitted.
+    * Newlines are skipped.
     * Other characters than A,a,C,c,G,g,U,u,T,t,X,x or - raise an error
     * and are treated as Mask.
     * The ordering of exon starts and ends does not matter.
@@ -234,8 +356,9 @@ class sequence {
     * are treated as masked, respectively.
     *
     * @param the_ID sequenceID representing the ID of the sequence
-    * @param sequence_string String representing the nucleotide sequence
-    *     (Adenine: A, Cytosine: C, Guanine: G, Uracil: U, Mask: X)
+    * @param sequence_string nucleotideText representing the nucleotide
+    *     sequence (Adenine: A, Cytosine: C, Guanine: G, Uracil: U,
+    *     Mask: X) which may be interrupted by newlines
     * @param the_chromosome chromosomeType representing the chromosome the
     *     sequence is located on
     * @param the_strand strandType representing the strand (Plus/Minus) on
@@ -250,16 +373,13 @@ class sequence {
     *     the 3' end of the + strand and accordingly the 5' end of
     *     the - strand) of the exons containing the sequence as
     *     comma-separated list.
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the sequence
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return a sequence containing the given nucleotides located on the
-    *     given chromosome, strand and positions with the given
-    *     conservation scores.
+    *     given chromosome, strand and positions.
     *********************************************************************/
-    sequence(sequenceID the_ID, std::string sequence_string, chromosomeType the_chromosome, strandType the_strand, std::string exon_starts, std::string exon_ends, const conservationList & conservations, bool verbose = false);
+    sequence(sequenceID the_ID, nucleotideText sequence_string, chromosomeType the_chromosome, strandType the_strand, std::string exon_starts, std::string exon_ends, bool verbose = false);
 
     /*****************************************************************//**
     * @brief standard constructor - do not use directly
@@ -274,6 +394,14 @@ class sequence {
     *********************************************************************/
     sequence();
 
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is virtual since sequences are derived from (mRNA, miRNA) and
+    * owned through pointers (e.g. by an entityTable).
+    *********************************************************************/
+    virtual ~sequence();
+
     /*****************************************************************//**
     * @brief get method for ID attribute
     *
@@ -523,6 +651,18 @@ class sequence {
     *********************************************************************/
     sequence mutate(const SNP & the_SNP) const;
 
+    /*****************************************************************//**
+    * @brief sequence exchange
+    *
+    * This method is used to exchange the content of two sequences
+    * without copying their nucleotides (e.g. to move a sequence into a
+    * container holding a default sequence).
+    *
+    * @param the_sequence sequence reference to the sequence to exchange
+    *     the content with
+    *********************************************************************/
+    void swap(sequence & the_sequence);
+
 
   private:
     /*****************************************************************//**
@@ -539,11 +679,12 @@ class sequence {
     * @param the_length sequenceLength representing the length of the
     *    sequence
     * @param the_nucleotides: std::vector<nucleotide> representing the
-    *     sequence's nucleotides
+    *     sequence's nucleotides (taken over by the sequence, leaving the
+    *     given vector empty, so they are not copied)
     *
     * @return a sequence with the given attributes
     *********************************************************************/
-    sequence(sequenceID the_ID, chromosomeType the_chromosome, strandType the_strand, std::vector<exon> the_exons, sequenceLength the_length, const std::vector<nucleotide> & the_nucleotides);
+    sequence(sequenceID the_ID, chromosomeType the_chromosome, strandType the_strand, std::vector<exon> the_exons, sequenceLength the_length, std::vector<nucleotide> & the_nucleotides);
 
     /*****************************************************************//**
     * @brief exon initialisation
@@ -592,17 +733,19 @@ class sequence {
     * T is understood as Thymine and is treated as Uracil (simulating
     * transscription).
     * Dashes (-) are understood as Gaps and are omitted.
-    * Other characters than A,a,C,c,G,g,U,u,T,t,X,x or - raise an error
-    * and are treated as Mask.
+    * Newlines are skipped.
+    * Other characters than A,a,C,c,G,g,U,u,T,t,X,x or - are treated as
+    * Mask and reported together (with their positions) in one error.
+    * The characters are decoded in blocks using SIMD instructions if
+    * available.
     * If the given sequence length does
     * not match the count of nucleotides an error message is raised and
     * the additional nucleotides are omitted or the missing nucleotides
     * are treated as masked, respectively.
     *
-    * @param the_sequence String representing the nucleotide sequence
-    *     (Adenine: A, Cytosine: C, Guanine: G, Uracil: U, Mask: X)
-    * @param the_chromosome chromosomeType representing the chromosome the
-    *     sequence is located on
+    * @param the_sequence nucleotideText representing the nucleotide
+    *     sequence (Adenine: A, Cytosine: C, Guanine: G, Uracil: U,
+    *     Mask: X) which may be interrupted by newlines
     * @param the_strand strandType representing the strand (Plus/Minus) on
     *     which the sequence is located
     * @param begin_of_exons const_exon_iterator pointing the sequence's
@@ -610,13 +753,11 @@ class sequence {
     * @param end_of_exons const_exon_iterator pointing behind the
     *     sequence's exon vector
     * @param the_length the requested length of the sequence
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the sequence
     *
     * @return a vector containing the sequence's nucleotides
     *********************************************************************/
-    static std::vector<nucleotide> initialize_nucleotides(const std::string & the_sequence, chromosomeType the_chromosome, strandType the_strand
-    , const const_exon_iterator & begin_of_exons, const const_exon_iterator & end_of_exons, sequenceLength the_length, const conservationList & conservations);
+    static std::vector<nucleotide> initialize_nucleotides(const nucleotideText & the_sequence, strandType the_strand
+    , const const_exon_iterator & begin_of_exons, const const_exon_iterator & end_of_exons, sequenceLength the_length);
 
     /*****************************************************************//**
     * @brief string to position vector conversion
@@ -656,22 +797,24 @@ class sequence {
     * @brief sequence ID
     *
     * This is the ID of the sequence.
+    * Like all attributes it is not changed after the construction
+    * except by swapping two sequences.
     *********************************************************************/
-    const sequenceID ID;
+    sequenceID ID;
 
     /*****************************************************************//**
     * @brief chromosome
     *
     * This is the chromosome the sequence is located on.
     *********************************************************************/
-    const chromosomeType chromosome;
+    chromosomeType chromosome;
 
     /*****************************************************************//**
     * @brief strand on chromosome
     *
     * This is the chromosome strand (Plus or Minus) the sequence is on.
     *********************************************************************/
-    const strandType strand;
+    strandType strand;
 
     /*****************************************************************//**
     * @brief exon segmentation
@@ -681,22 +824,23 @@ class sequence {
     * beeing the 5' end of the + strand and accordingly the 3' end of
     * the - strand) on the chromosome
     *********************************************************************/
-    const std::vector<exon> exons;
+    std::vector<exon> exons;
 
     /*****************************************************************//**
     * @brief sequence length
     *
     * This is the length of the sequence.
     *********************************************************************/
-    const sequenceLength length;
+    sequenceLength length;
 
     /*****************************************************************//**
     * @brief nucleotide sequence
     *
     * A vector containing the sequence's nucleotides from 5' to 3'
     *********************************************************************/
-    const std::vector<nucleotide> nucleotides;
+    std::vector<nucleotide> nucleotides;
 
+    friend class sequenceDatabase;
 };
     /*****************************************************************//**
     * @brief get method for ID attribute
@@ -0,0 +1,209 @@
+#ifndef MICROSNPSCORE_SEQUENCEDATABASE_H
+#define MICROSNPSCORE_SEQUENCEDATABASE_H
+
+
+#include <vector>
+#include <stddef.h>
+#include "sequence.h"
+#include "mRNA.h"
+#include "miRNA.h"
+#include "filePath.h"
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief sequence database class
+*
+* This represents a compiled binary database of the sequences of a
+* sequence file, so sequences can be created without parsing the
+* sequence file.
+* For every sequence the database holds the ID, chromosome, strand and
+* exons and the nucleo bases packed into 2 bits each together with a
+* bitmap of the masked nucleotides.
+* The chromosome positions of the nucleotides are not stored since
+* they follow from the exons (and the conservation is only looked up
+* for them when a target site is scored).
+* The database is memory-mapped when opened and uses the byte order of
+* the machine it was built on.
+*
+* @see sequenceFile
+*********************************************************************/
+
+class sequenceDatabase {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to open an existing sequence database.
+    * If the file cannot be mapped or is no valid database of the current
+    * version an error is raised and the database is created but won't
+    * contain any sequences (see @p is_open).
+    *
+    * @param the_path filePath to the database file
+    *
+    * @return sequenceDatabase for the given file
+    *
+    * @see is_open()
+    *********************************************************************/
+    sequenceDatabase(const filePath & the_path);
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to unmap the database file.
+    *********************************************************************/
+    ~sequenceDatabase();
+
+    /*****************************************************************//**
+    * @brief database state
+    *
+    * This method is used to check whether the database could be opened.
+    *
+    * @return true if the database is open, false otherwise
+    *********************************************************************/
+    inline bool is_open() const;
+
+    /*****************************************************************//**
+    * @brief get method for sequence count
+    *
+    * This method is used to access the number of sequences in the
+    * database.
+    *
+    * @return the number of sequences in the database
+    *********************************************************************/
+    unsigned long size() const;
+
+    /*****************************************************************//**
+    * @brief get method for sequence IDs
+    *
+    * This method is used to access the ID of a sequence without creating
+    * the sequence.
+    *
+    * @param index unsigned long representing the number of the sequence
+    *     in the database (less than its size)
+    *
+    * @return the ID of the sequence
+    *********************************************************************/
+    sequenceID get_ID(unsigned long index) const;
+
+    /*****************************************************************//**
+    * @brief mRNA object creation
+    *
+    * This method is used to create a mRNA object from a sequence of the
+    * database.
+    *
+    * @param index unsigned long representing the number of the sequence
+    *     in the database (less than its size)
+    *
+    * @return mRNA object corresponding to the sequence
+    *********************************************************************/
+    mRNA get_mRNA(unsigned long index) const;
+
+    /*****************************************************************//**
+    * @brief miRNA object creation
+    *
+    * This method is used to create a miRNA object from a sequence of the
+    * database.
+    *
+    * @param index unsigned long representing the number of the sequence
+    *     in the database (less than its size)
+    *
+    * @return miRNA object corresponding to the sequence
+    *********************************************************************/
+    miRNA get_miRNA(unsigned long index) const;
+
+    /*****************************************************************//**
+    * @brief database creation
+    *
+    * This method is used to create (or replace) the database of a
+    * sequence file.
+    * Errors in the file are stated like when reading it directly.
+    * If the file cannot be read or the database cannot be written an
+    * error is raised.
+    *
+    * @param sequence_path filePath to the sequence file
+    * @param database_path filePath to the database file to be written
+    *
+    * @return true if the database was written, false otherwise
+    *********************************************************************/
+    static bool build(const filePath & sequence_path, const filePath & database_path);
+
+    /*****************************************************************//**
+    * @brief database detection
+    *
+    * This method is used to check whether a given file is a sequence
+    * database (and not e.g. a sequence file).
+    *
+    * @param the_path filePath to the file
+    *
+    * @return true if the file starts like a sequence database, false
+    *     otherwise
+    *********************************************************************/
+    static bool is_database(const filePath & the_path);
+
+
+  private:
+    /*****************************************************************//**
+    * @brief copy constructor - not implemented
+    *
+    * A database owns its mapping and cannot be copied.
+    *********************************************************************/
+    sequenceDatabase(const sequenceDatabase & the_database);
+
+    /*****************************************************************//**
+    * @brief assignment operator - not implemented
+    *
+    * A database owns its mapping and cannot be assigned.
+    *********************************************************************/
+    sequenceDatabase & operator=(const sequenceDatabase & the_database);
+
+    /*****************************************************************//**
+    * @brief sequence object creation
+    *
+    * This method is used to create a sequence object from a sequence of
+    * the database.
+    *
+    * @param index unsigned long representing the number of the sequence
+    *     in the database (less than its size)
+    *
+    * @return sequence object corresponding to the sequence
+    *********************************************************************/
+    sequence get_sequence(unsigned long index) const;
+
+    /*****************************************************************//**
+    * @brief file path
+    *
+    * This is the path of the database file (used in error messages).
+    *********************************************************************/
+    const filePath path;
+
+    /*****************************************************************//**
+    * @brief file mapping
+    *
+    * This points to the first byte of the mapped database file (or is
+    * NULL if it could not be opened).
+    *********************************************************************/
+    const char * mapping;
+
+    /*****************************************************************//**
+    * @brief mapping size
+    *
+    * This is the size of the mapped database file in bytes.
+    *********************************************************************/
+    size_t mapping_size;
+
+};
+    /*****************************************************************//**
+    * @brief database state
+    *
+    * This method is used to check whether the database could be opened.
+    *
+    * @return true if the database is open, false otherwise
+    *********************************************************************/
+    inline bool sequenceDatabase::is_open() const {
+      return mapping != NULL;
+}
+
+
+} // namespace microSNPscore
+#endif
@@ -9,9 +9,10 @@
 #include "mRNA.h"
 #include "miRNA.h"
 #include <vector>
+#include <set>
 #include "filePath.h"
+#include "lineReader.h"
 
-namespace microSNPscore { class conservationList; } 
 
 namespace microSNPscore {
 
@@ -57,6 +58,19 @@ class sequenceFileEntry {
     
     sequenceFileEntry(std::string FASTA_entry);
 
+    /*****************************************************************//**
+    * @brief default constructor
+    *
+    * This is used to create the empty default sequenceFileEntry (i.e.
+    * the one corresponding to the FASTA entry ">|||1|\n\n").
+    * It is intended to be filled by a sequenceFileReader.
+    *
+    * @return empty default sequenceFileEntry
+    *
+    * @see sequenceFileReader::next()
+    *********************************************************************/
+    sequenceFileEntry();
+
     /*****************************************************************//**
     * @brief constructor from sequence object
     *
@@ -68,20 +82,28 @@ class sequenceFileEntry {
     *********************************************************************/
     sequenceFileEntry(const sequence & the_sequence);
 
+    /*****************************************************************//**
+    * @brief get method for ID attribute
+    *
+    * This method is used to access the ID of the sequence the entry is
+    * for without creating the sequence object.
+    *
+    * @return the ID of the sequence
+    *********************************************************************/
+    inline const sequenceID get_ID() const;
+
     /*****************************************************************//**
     * @brief sequence object creation
     *
     * This method is used to create a sequence object corresponding to the
     * sequence file entry.
     *
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the sequence
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return sequence object corresponding to the sequence file entry
     *********************************************************************/
-    inline sequence get_sequence(const conservationList & conservations, bool verbose = false) const;
+    inline sequence get_sequence(bool verbose = false) const;
 
     /*****************************************************************//**
     * @brief mRNA object creation
@@ -89,14 +111,12 @@ class sequenceFileEntry {
     * This method is used to create a mRNA object corresponding to the
     * sequence file entry.
     *
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the mRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return mRNA object corresponding to the sequence file entry
     *********************************************************************/
-    inline mRNA get_mRNA(const conservationList & conservations, bool verbose = false) const;
+    inline mRNA get_mRNA(bool verbose = false) const;
 
     /*****************************************************************//**
     * @brief miRNA object creation
@@ -104,14 +124,12 @@ class sequenceFileEntry {
     * This method is used to create a miRNA object corresponding to the
     * sequence file entry.
     *
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the miRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return miRNA object corresponding to the sequence file entry
     *********************************************************************/
-    inline miRNA get_miRNA(const conservationList & conservations, bool verbose = false) const;
+    inline miRNA get_miRNA(bool verbose = false) const;
 
     /*****************************************************************//**
     * @brief FASTA entry creation
@@ -128,8 +146,69 @@ class sequenceFileEntry {
     
     std::string get_FASTA(sequenceLength nucleotides_per_line = 60) const;
 
+    /*****************************************************************//**
+    * @brief FASTA entry appending
+    *
+    * This method is used to append the FASTA entry corresponding to the
+    * sequence file entry to a string (e.g. an output buffer reserved
+    * for several entries).
+    *
+    * @param FASTA std::string reference the FASTA entry is appended to
+    * @param nucleotides_per_line (optional) sequenceLength of one line
+    * in the FASTA output (a newline will be insterted after every that
+    * number of nucleotides) - Defaults to 60
+    *
+    * @see get_FASTA()
+    *********************************************************************/
+    void append_FASTA(std::string & FASTA, sequenceLength nucleotides_per_line = 60) const;
+
+    /*****************************************************************//**
+    * @brief sequence FASTA entry appending
+    *
+    * This method is used to append the FASTA entry of a given sequence
+    * to a string without creating a sequence file entry for it first.
+    * The entry is the same @p get_FASTA would return for an entry
+    * created from the sequence.
+    *
+    * @param FASTA std::string reference the FASTA entry is appended to
+    * @param the_sequence const sequence reference to the sequence the
+    *     entry should be created for
+    * @param nucleotides_per_line (optional) sequenceLength of one line
+    * in the FASTA output (a newline will be insterted after every that
+    * number of nucleotides) - Defaults to 60
+    *********************************************************************/
+    static void append_FASTA(std::string & FASTA, const sequence & the_sequence, sequenceLength nucleotides_per_line = 60);
+
 
   private:
+    /*****************************************************************//**
+    * @brief FASTA header parsing
+    *
+    * This method is used to assign the sequence ID, exon starts, exon
+    * ends, strand and chromosome given in a FASTA header line (without
+    * the leading > sign and the newline) to the entry.
+    * The line must contain at least four pipe (|) characters, additional
+    * ones are taken as part of the sequence ID.
+    * If the line is not a valid header the entry is not changed.
+    *
+    * @param begin const char pointer to the first character of the line
+    * @param end const char pointer behind the last character of the line
+    *
+    * @return true if the line is a valid FASTA header, false otherwise
+    *********************************************************************/
+    bool set_header(const char * begin, const char * end);
+
+    /*****************************************************************//**
+    * @brief nucleotide text access
+    *
+    * This method is used to access the nucleotides of the entry no
+    * matter whether they are held by the entry or refer to the mapping
+    * of a sequenceFileReader.
+    *
+    * @return nucleotideText referring to the nucleotides of the entry
+    *********************************************************************/
+    inline nucleotideText get_nucleotides() const;
+
     /*****************************************************************//**
     * @brief sequence ID
     *
@@ -182,22 +261,51 @@ class sequenceFileEntry {
     
     std::string nucleotide_sequence;
 
+    /*****************************************************************//**
+    * @brief mapped nucleotides begin
+    *
+    * This points to the first character of the sequence lines in the
+    * mapping of the sequenceFileReader the entry was read by (or is NULL
+    * if the nucleotides are held by the entry).
+    *********************************************************************/
+    const char * mapped_begin;
+
+    /*****************************************************************//**
+    * @brief mapped nucleotides end
+    *
+    * This points behind the last character of the sequence lines in the
+    * mapping of the sequenceFileReader the entry was read by.
+    *********************************************************************/
+    const char * mapped_end;
+
+    friend class sequenceFileReader;
+    friend class transcriptAnnotation;
 };
+    /*****************************************************************//**
+    * @brief get method for ID attribute
+    *
+    * This method is used to access the ID of the sequence the entry is
+    * for without creating the sequence object.
+    *
+    * @return the ID of the sequence
+    *********************************************************************/
+    inline const sequenceID sequenceFileEntry::get_ID() const {
+      return ID;
+}
+
     /*****************************************************************//**
     * @brief sequence object creation
     *
     * This method is used to create a sequence object corresponding to the
     * sequence file entry.
     *
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the sequence
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return sequence object corresponding to the sequence file entry
     *********************************************************************/
-    inline sequence sequenceFileEntry::get_sequence(const conservationList & conservations, bool verbose) const {
-      return sequence(ID,nucleotide_sequence,chromosome,strand,exon_starts,exon_ends,conservations,verbose);
+    inline sequence sequenceFileEntry::get_sequence(bool verbose) const {
+      return sequence(ID,get_nucleotides(),chromosome,strand,exon_starts,exon_ends,verbose);
 }
 
     /*****************************************************************//**
@@ -206,15 +314,13 @@ class sequenceFileEntry {
     * This method is used to create a mRNA object corresponding to the
     * sequence file entry.
     *
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the mRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return mRNA object corresponding to the sequence file entry
     *********************************************************************/
-    inline mRNA sequenceFileEntry::get_mRNA(const conservationList & conservations, bool verbose) const {
-      return mRNA(ID,nucleotide_sequence,chromosome,strand,exon_starts,exon_ends,conservations,verbose);
+    inline mRNA sequenceFileEntry::get_mRNA(bool verbose) const {
+      return mRNA(ID,get_nucleotides(),chromosome,strand,exon_starts,exon_ends,verbose);
 }
 
     /*****************************************************************//**
@@ -223,15 +329,312 @@ class sequenceFileEntry {
     * This method is used to create a miRNA object corresponding to the
     * sequence file entry.
     *
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the miRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return miRNA object corresponding to the sequence file entry
     *********************************************************************/
-    inline miRNA sequenceFileEntry::get_miRNA(const conservationList & conservations, bool verbose) const {
-      return miRNA(ID,nucleotide_sequence,chromosome,strand,exon_starts,exon_ends,conservations,verbose);
+    inline miRNA sequenceFileEntry::get_miRNA(bool verbose) const {
+      return miRNA(ID,get_nucleotides(),chromosome,strand,exon_starts,exon_ends,verbose);
+}
+
+    /*****************************************************************//**
+    * @brief nucleotide text access
+    *
+    * This method is used to access the nucleotides of the entry no
+    * matter whether they are held by the entry or refer to the mapping
+    * of a sequenceFileReader.
+    *
+    * @return nucleotideText referring to the nucleotides of the entry
+    *********************************************************************/
+    inline nucleotideText sequenceFileEntry::get_nucleotides() const {
+      return mapped_begin != NULL ? nucleotideText(mapped_begin,mapped_end) : nucleotideText(nucleotide_sequence);
+}
+
+/*****************************************************************//**
+* @brief sequence file reader class
+*
+* This represents a reader returning the FASTA entries of a sequence
+* file one after another in a single pass over the file, so only the
+* current entry has to be kept in memory.
+* Invalid entries are reported (with the number of the line they start
+* in) and skipped, the valid ones in the rest of the file are still
+* returned.
+* Optionally the file is memory-mapped instead of read, so the entries
+* refer to the sequence lines in the mapping instead of copying them
+* and the pages of the file are shared with other processes reading it.
+*
+* @see sequenceFileEntry
+* @see lineReader
+*********************************************************************/
+
+class sequenceFileReader {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a sequenceFileReader for a given file.
+    * If the file cannot be opened for reading the reader is created but
+    * won't return any entries (see @p is_open).
+    * If the file should be mapped but cannot be (e.g. because it is a
+    * pipe or compressed), it is read instead.
+    * Files compressed with gzip are decompressed transparently.
+    * The nucleotides of the entries returned by a reader mapping its
+    * file are only valid as long as the reader exists.
+    *
+    * @param the_path filePath to the sequence file
+    * @param map_file (optional) bool indicating whether the file should
+    *     be memory-mapped - Defaults to false
+    *
+    * @return sequenceFileReader for the given file
+    *
+    * @see is_open()
+    *********************************************************************/
+    sequenceFileReader(const filePath & the_path, bool map_file = false);
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to unmap or close the file read by the reader.
+    *********************************************************************/
+    ~sequenceFileReader();
+
+    /*****************************************************************//**
+    * @brief file state
+    *
+    * This method is used to check whether the file could be opened.
+    *
+    * @return true if the file is open for reading, false otherwise
+    *********************************************************************/
+    inline bool is_open() const;
+
+    /*****************************************************************//**
+    * @brief compression state
+    *
+    * This method is used to check whether the file is decompressed (so
+    * the offsets of its entries do not refer to the file itself).
+    *
+    * @return true if the file is a gzip file, false otherwise
+    *********************************************************************/
+    inline bool is_compressed() const;
+
+    /*****************************************************************//**
+    * @brief next entry
+    *
+    * This method is used to read the next valid FASTA entry of the file.
+    * A valid FASTA entry starts with the > sign followed by the sequence
+    * ID, a pipe (|) character, a comma-separated list of exon starts,
+    * another pipe character, a comma-separated list of exon ends, another
+    * pipe character, 1 or -1 representing the strand (+ or -,
+    * respectively), a last pipe character, the chromosome name and
+    * linebreak followed by the sequence which may contain newlines but
+    * no > signs.
+    * If the header line containes more than four pipe characters, the
+    * additional one are taken as part of the sequence ID.
+    * Invalid entries and lines outside of any entry are skipped stating
+    * an error.
+    *
+    * @param entry sequenceFileEntry reference the entry is assigned to
+    *
+    * @return true if an entry was assigned, false at the end of the file
+    *     or if the file cannot be read
+    *********************************************************************/
+    bool next(sequenceFileEntry & entry);
+
+    /*****************************************************************//**
+    * @brief get method for entry offset
+    *
+    * This method is used to access the offset of the header line of the
+    * entry returned last in the file.
+    *
+    * @return the file offset of the last entry
+    *********************************************************************/
+    inline off_t get_entry_offset() const;
+
+    /*****************************************************************//**
+    * @brief get method for entry size
+    *
+    * This method is used to access the number of bytes the entry
+    * returned last takes in the file (from its header line up to the
+    * newline of its last line).
+    *
+    * @return the size of the last entry in the file
+    *********************************************************************/
+    inline off_t get_entry_size() const;
+
+
+  private:
+    /*****************************************************************//**
+    * @brief copy constructor - not implemented
+    *
+    * A reader owns its file (mapping) and cannot be copied.
+    *********************************************************************/
+    sequenceFileReader(const sequenceFileReader & the_reader);
+
+    /*****************************************************************//**
+    * @brief assignment operator - not implemented
+    *
+    * A reader owns its file (mapping) and cannot be assigned.
+    *********************************************************************/
+    sequenceFileReader & operator=(const sequenceFileReader & the_reader);
+
+    /*****************************************************************//**
+    * @brief next line
+    *
+    * This method is used to get the next line of the file counting the
+    * lines read.
+    * At the end of the file an error is stated if its last line is not
+    * terminated by a newline (since the line is ignored).
+    *
+    * @param line fieldView reference the line is assigned to
+    *
+    * @return true if a line was assigned, false at the end of the file
+    *********************************************************************/
+    bool next_line(fieldView & line);
+
+    /*****************************************************************//**
+    * @brief file path
+    *
+    * This is the path of the file read (used in error messages).
+    *********************************************************************/
+    const filePath path;
+
+    /*****************************************************************//**
+    * @brief line reader
+    *
+    * This is the reader the lines of the file are taken from (or NULL
+    * if the file is mapped).
+    *********************************************************************/
+    lineReader * lines;
+
+    /*****************************************************************//**
+    * @brief file mapping
+    *
+    * This points to the first character of the mapped file (or is NULL
+    * if the file is read).
+    *********************************************************************/
+    const char * mapping;
+
+    /*****************************************************************//**
+    * @brief mapping end
+    *
+    * This points behind the last character of the mapped file.
+    *********************************************************************/
+    const char * mapping_end;
+
+    /*****************************************************************//**
+    * @brief mapping position
+    *
+    * This points to the first character of the mapped file not read yet.
+    *********************************************************************/
+    const char * mapped_position;
+
+    /*****************************************************************//**
+    * @brief line number
+    *
+    * This is the number of lines read so far.
+    *********************************************************************/
+    unsigned long line_number;
+
+    /*****************************************************************//**
+    * @brief read offset
+    *
+    * This is the offset behind the last line read.
+    *********************************************************************/
+    off_t read_offset;
+
+    /*****************************************************************//**
+    * @brief pending header
+    *
+    * This holds the header line of the next entry (read while looking
+    * for the end of the previous one) or is empty if no header is
+    * pending.
+    *********************************************************************/
+    std::string header;
+
+    /*****************************************************************//**
+    * @brief pending header line number
+    *
+    * This is the number of the line the pending header was read from.
+    *********************************************************************/
+    unsigned long header_line_number;
+
+    /*****************************************************************//**
+    * @brief pending header offset
+    *
+    * This is the offset of the pending header in the file.
+    *********************************************************************/
+    off_t header_offset;
+
+    /*****************************************************************//**
+    * @brief entry offset
+    *
+    * This is the offset of the header of the entry returned last.
+    *********************************************************************/
+    off_t entry_offset;
+
+    /*****************************************************************//**
+    * @brief entry end
+    *
+    * This is the offset behind the last line of the entry returned last.
+    *********************************************************************/
+    off_t entry_end;
+
+    /*****************************************************************//**
+    * @brief end of file flag
+    *
+    * This indicates whether the end of the file was reached (so it is
+    * checked only once).
+    *********************************************************************/
+    bool end_of_file;
+
+};
+    /*****************************************************************//**
+    * @brief file state
+    *
+    * This method is used to check whether the file could be opened.
+    *
+    * @return true if the file is open for reading, false otherwise
+    *********************************************************************/
+    inline bool sequenceFileReader::is_open() const {
+      return mapping != NULL || lines->is_open();
+}
+
+    /*****************************************************************//**
+    * @brief compression state
+    *
+    * This method is used to check whether the file is decompressed (so
+    * the offsets of its entries do not refer to the file itself).
+    *
+    * @return true if the file is a gzip file, false otherwise
+    *********************************************************************/
+    inline bool sequenceFileReader::is_compressed() const {
+      return mapping == NULL && lines->is_compressed();
+}
+
+    /*****************************************************************//**
+    * @brief get method for entry offset
+    *
+    * This method is used to access the offset of the header line of the
+    * entry returned last in the file.
+    *
+    * @return the file offset of the last entry
+    *********************************************************************/
+    inline off_t sequenceFileReader::get_entry_offset() const {
+      return entry_offset;
+}
+
+    /*****************************************************************//**
+    * @brief get method for entry size
+    *
+    * This method is used to access the number of bytes the entry
+    * returned last takes in the file (from its header line up to the
+    * newline of its last line).
+    *
+    * @return the size of the last entry in the file
+    *********************************************************************/
+    inline off_t sequenceFileReader::get_entry_size() const {
+      return entry_end - entry_offset;
 }
 
 /*****************************************************************//**
@@ -281,18 +684,32 @@ class sequenceFile {
     * file to the sequence file's entries.
     * If the file does not exist or does not contain any valid FASTA
     * entires an error is raised and no sequence file entry is created.
-    * A valid FASTA entry starts with the > sign followed by the sequence
-    * ID, a pipe (|) character, a comma-separated list of exon starts,
-    * another pipe character, a comma-separated list of exon ends, another
-    * pipe character, 1 or -1 representing the strand (+ or -,
-    * respectively), a last pipe character, the chromosome name and
-    * linebreak followed by the sequence which may contain newlines but
-    * must end with a newline.
-    * If the header line containes more than four pipe characters, the
-    * additional one are taken as part of the sequence ID.
+    * Invalid entries are skipped stating an error (see
+    * sequenceFileReader::next() for the valid format).
+    *
+    * @see sequenceFileReader
     *********************************************************************/
     void read();
 
+    /*****************************************************************//**
+    * @brief read requested entries using the index
+    *
+    * This method is used to read only the entries of the sequences with
+    * the given IDs using the index of the file (see sequenceFileIndex),
+    * appending them to the sequence file's entries in file order.
+    * IDs not contained in the index are ignored.
+    * If the file has no up to date index nothing is read, so the caller
+    * may read the whole file instead.
+    *
+    * @param IDs const std::set reference to the IDs of the sequences to
+    *     be read
+    *
+    * @return true if the index was used, false otherwise
+    *
+    * @see sequenceFileIndex::build()
+    *********************************************************************/
+    bool read(const std::set<sequenceID> & IDs);
+
     /*****************************************************************//**
     * @brief entry vector begin
     *
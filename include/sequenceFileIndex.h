@@ -0,0 +1,148 @@
+#ifndef MICROSNPSCORE_SEQUENCEFILEINDEX_H
+#define MICROSNPSCORE_SEQUENCEFILEINDEX_H
+
+
+#include <map>
+#include <sys/types.h>
+#include "sequence.h"
+#include "filePath.h"
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief sequence file index class
+*
+* This represents an index of a sequence file (similar to a FASTA
+* index) recording the byte offset and size of the entry for every
+* sequence ID, so single entries can be read without parsing the
+* whole file.
+* The index is stored next to the sequence file (see @p get_path)
+* as a header line holding the size and modification time of the
+* indexed file followed by one tab-separated line per sequence ID
+* containing the ID, the offset and the size of its entry.
+* An index not matching the current size and modification time of its
+* sequence file is out of date and not used.
+*
+* @see sequenceFile::read()
+* @see sequenceFileReader
+*********************************************************************/
+
+class sequenceFileIndex {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to load the index of a given sequence file.
+    * If there is no index the sequenceFileIndex is created but not
+    * loaded (see @p is_loaded).
+    * If the index is out of date or invalid an error is raised and it is
+    * not loaded either.
+    *
+    * @param the_path filePath to the sequence file (not to the index)
+    *
+    * @return sequenceFileIndex for the given sequence file
+    *
+    * @see is_loaded()
+    *********************************************************************/
+    sequenceFileIndex(const filePath & the_path);
+
+    /*****************************************************************//**
+    * @brief index state
+    *
+    * This method is used to check whether the index could be loaded.
+    *
+    * @return true if an up to date index was loaded, false otherwise
+    *********************************************************************/
+    inline bool is_loaded() const;
+
+    /*****************************************************************//**
+    * @brief entry location
+    *
+    * This method is used to find the location of the entry of a given
+    * sequence in the sequence file.
+    *
+    * @param ID const sequenceID reference to the ID of the sequence
+    * @param offset off_t reference the entry's offset is assigned to
+    * @param size off_t reference the entry's size is assigned to
+    *
+    * @return true if the sequence is contained in the index, false
+    *     otherwise
+    *********************************************************************/
+    bool find(const sequenceID & ID, off_t & offset, off_t & size) const;
+
+    /*****************************************************************//**
+    * @brief index creation
+    *
+    * This method is used to create (or replace) the index of a given
+    * sequence file.
+    * Like a sequenceFile, the index keeps the first entry for IDs
+    * occurring more than once, invalid entries are skipped.
+    * If the sequence file cannot be read, is compressed or the index
+    * cannot be written an error is raised.
+    *
+    * @param the_path filePath to the sequence file
+    *
+    * @return true if the index was written, false otherwise
+    *********************************************************************/
+    static bool build(const filePath & the_path);
+
+    /*****************************************************************//**
+    * @brief index path
+    *
+    * This method is used to get the path of the index of a given
+    * sequence file (i.e. the path of the sequence file followed by
+    * ".idx").
+    *
+    * @param the_path filePath to the sequence file
+    *
+    * @return filePath to the index of the sequence file
+    *********************************************************************/
+    static filePath get_path(const filePath & the_path);
+
+
+  private:
+    /*****************************************************************//**
+    * @brief file signature
+    *
+    * This method is used to create the header line of the index of a
+    * given sequence file from its current size and modification time.
+    *
+    * @param the_path filePath to the sequence file
+    * @param signature std::string reference the header line (without
+    *     newline) is assigned to
+    *
+    * @return true if the sequence file's status could be read, false
+    *     otherwise
+    *********************************************************************/
+    static bool get_signature(const filePath & the_path, std::string & signature);
+
+    /*****************************************************************//**
+    * @brief entry locations
+    *
+    * This maps the sequence IDs to the offsets and sizes of their
+    * entries in the sequence file.
+    *********************************************************************/
+    std::map<sequenceID,std::pair<off_t,off_t> > locations;
+
+    /*****************************************************************//**
+    * @brief loaded flag
+    *
+    * This indicates whether an up to date index was loaded.
+    *********************************************************************/
+    bool loaded;
+
+};
+    /*****************************************************************//**
+    * @brief index state
+    *
+    * This method is used to check whether the index could be loaded.
+    *
+    * @return true if an up to date index was loaded, false otherwise
+    *********************************************************************/
+    inline bool sequenceFileIndex::is_loaded() const {
+      return loaded;
+}
+
+
+} // namespace microSNPscore
+#endif
@@ -0,0 +1,99 @@
+#ifndef MICROSNPSCORE_SEQUENCELOADER_H
+#define MICROSNPSCORE_SEQUENCELOADER_H
+
+
+#include <set>
+#include "sequence.h"
+#include "mRNA.h"
+#include "miRNA.h"
+#include "filePath.h"
+#include "entityTable.h"
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief processor count
+*
+* This is used to get the number of processors online (at least one).
+*
+* @return unsigned int representing the number of processors
+*********************************************************************/
+unsigned int processor_count();
+
+/*****************************************************************//**
+* @brief mRNA reading
+*
+* This is used to read the mRNAs from the given file into their table.
+* The file may be a FASTA file (indexed or not, possibly compressed) or
+* a sequence database, or a transcript annotation if a genome is given.
+*
+* @param table entityTable reference to the table the mRNAs should be
+*     inserted into
+* @param path filePath of the mRNA file
+* @param verbose bool indicating whether the mRNAs should be created
+*     verbosely
+* @param IDs std::set pointer to the IDs of the mRNAs needed (or NULL
+*     to read all of them)
+* @param genome_path filePath of the genome the annotated mRNAs are
+*     taken from (or empty if the file is no annotation)
+*********************************************************************/
+void read_mRNAs(entityTable<sequenceID,mRNA> & table, const filePath & path,
+                bool verbose = false,
+                const std::set<sequenceID> * IDs = NULL,
+                const filePath & genome_path = "");
+
+/*****************************************************************//**
+* @brief miRNA reading
+*
+* This is used to read the miRNAs from the given file into their table.
+* The file may be a FASTA file (indexed or not, possibly compressed) or
+* a sequence database.
+*
+* @param table entityTable reference to the table the miRNAs should be
+*     inserted into
+* @param path filePath of the miRNA file
+* @param verbose bool indicating whether the miRNAs should be created
+*     verbosely
+* @param IDs std::set pointer to the IDs of the miRNAs needed (or NULL
+*     to read all of them)
+*********************************************************************/
+void read_miRNAs(entityTable<sequenceID,miRNA> & table, const filePath & path,
+                 bool verbose = false,
+                 const std::set<sequenceID> * IDs = NULL);
+
+/*****************************************************************//**
+* @brief sequence reading
+*
+* This is used to read the mRNAs and miRNAs from the given files into
+* their tables.
+* Each file may be a FASTA file (indexed or not, possibly compressed)
+* or a sequence database, the mRNA file is a transcript annotation if
+* a genome is given.
+* The sequences of FASTA files and annotations are created on one
+* thread per processor, the messages are printed in the order of the
+* entries nonetheless.
+*
+* @param mRNA_table entityTable reference to the table the mRNAs
+*     should be inserted into
+* @param mRNA_path filePath of the mRNA file
+* @param miRNA_table entityTable reference to the table the miRNAs
+*     should be inserted into
+* @param miRNA_path filePath of the miRNA file
+* @param verbose bool indicating whether the sequences should be
+*     created verbosely
+* @param mRNA_IDs std::set pointer to the IDs of the mRNAs needed (or
+*     NULL to read all of them)
+* @param miRNA_IDs std::set pointer to the IDs of the miRNAs needed (or
+*     NULL to read all of them)
+* @param genome_path filePath of the genome the annotated mRNAs are
+*     taken from (or empty if the mRNA file is no annotation)
+*********************************************************************/
+void read_sequences(entityTable<sequenceID,mRNA> & mRNA_table, const filePath & mRNA_path,
+                    entityTable<sequenceID,miRNA> & miRNA_table, const filePath & miRNA_path,
+                    bool verbose = false,
+                    const std::set<sequenceID> * mRNA_IDs = NULL,
+                    const std::set<sequenceID> * miRNA_IDs = NULL,
+                    const filePath & genome_path = "");
+
+} // namespace microSNPscore
+#endif
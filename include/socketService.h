@@ -0,0 +1,135 @@
+#ifndef MICROSNPSCORE_SOCKETSERVICE_H
+#define MICROSNPSCORE_SOCKETSERVICE_H
+
+
+#include <string>
+#include "filePath.h"
+#include "workerPool.h"
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief socket server class
+*
+* This represents a server answering requests with a worker task over
+* a local (Unix domain) socket.
+* Every connection is served by its own process (sharing the data
+* loaded before the server was started), reading newline-terminated
+* request lines and answering each of them in order with a
+* length-prefixed frame containing the task's result, so clients may
+* send further requests before the previous ones are answered.
+*
+* @see socketClient
+* @see workerPool::append_frame()
+*********************************************************************/
+
+class socketServer {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a socketServer for a given task and socket
+    * path.
+    * The socket is not created before the server is run.
+    *
+    * @param the_task workerTask reference to process the requests with
+    * @param the_path filePath of the socket to listen on
+    *
+    * @return socketServer for the given task and socket path
+    *********************************************************************/
+    socketServer(workerTask & the_task, const filePath & the_path);
+
+    /*****************************************************************//**
+    * @brief request serving
+    *
+    * This method is used to create the socket and to serve connections
+    * until the server receives SIGINT or SIGTERM.
+    * A stale socket left at the path is replaced, other files are not.
+    * If the socket cannot be created an error is raised.
+    * The socket is removed when the server stops.
+    *
+    * @return true if the server was stopped by a signal, false if the
+    *     socket could not be created or accepting connections failed
+    *********************************************************************/
+    bool run();
+
+
+  private:
+    /*****************************************************************//**
+    * @brief connection serving
+    *
+    * This method is used to answer the requests read from a connection
+    * until the client stops sending or the connection breaks.
+    *
+    * @param connection_fd int representing the connection's descriptor
+    *********************************************************************/
+    void serve_connection(int connection_fd);
+
+    /*****************************************************************//**
+    * @brief server task
+    *
+    * This is the task the requests are processed with.
+    *********************************************************************/
+    workerTask & task;
+
+    /*****************************************************************//**
+    * @brief socket path
+    *
+    * This is the path of the socket the server listens on.
+    *********************************************************************/
+    const filePath path;
+
+};
+/*****************************************************************//**
+* @brief socket client class
+*
+* This represents a client sending request lines to a socketServer and
+* passing the answers on in request order.
+* Requests are sent while answers are received, so the server is kept
+* busy without waiting for every single answer.
+*
+* @see socketServer
+*********************************************************************/
+
+class socketClient {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a socketClient for a given socket path.
+    * The connection is not made before the client is run.
+    *
+    * @param the_path filePath of the socket to connect to
+    *
+    * @return socketClient for the given socket path
+    *********************************************************************/
+    socketClient(const filePath & the_path);
+
+    /*****************************************************************//**
+    * @brief request sending
+    *
+    * This method is used to connect to the server, send all requests of
+    * a source and pass the answers on to a sink in request order.
+    * If the connection cannot be made or breaks before all requests are
+    * answered an error is raised.
+    *
+    * @param source requestSource reference to take the requests from
+    * @param sink resultSink reference to pass the answers to
+    *
+    * @return true if all requests were answered, false otherwise
+    *********************************************************************/
+    bool run(requestSource & source, resultSink & sink);
+
+
+  private:
+    /*****************************************************************//**
+    * @brief socket path
+    *
+    * This is the path of the socket the client connects to.
+    *********************************************************************/
+    const filePath path;
+
+};
+
+} // namespace microSNPscore
+#endif
@@ -0,0 +1,209 @@
+#ifndef MICROSNPSCORE_TRANSCRIPTANNOTATION_H
+#define MICROSNPSCORE_TRANSCRIPTANNOTATION_H
+
+
+#include <string>
+#include <vector>
+#include <map>
+#include "sequence.h"
+#include "filePath.h"
+#include "lineReader.h"
+
+namespace microSNPscore { class referenceGenome; }
+namespace microSNPscore { class sequenceFileEntry; }
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief annotated transcript
+*
+* This represents the location of a transcript as given in an
+* annotation file.
+*
+* @see transcriptAnnotation
+*********************************************************************/
+struct annotatedTranscript {
+    /*****************************************************************//**
+    * @brief transcript ID
+    *
+    * This is the ID of the transcript.
+    *********************************************************************/
+    sequenceID ID;
+
+    /*****************************************************************//**
+    * @brief chromosome
+    *
+    * This is the chromosome the transcript is located on.
+    *********************************************************************/
+    chromosomeType chromosome;
+
+    /*****************************************************************//**
+    * @brief strand
+    *
+    * This is the strand the transcript is located on.
+    *********************************************************************/
+    strandType strand;
+
+    /*****************************************************************//**
+    * @brief exons
+    *
+    * This holds the exons of the transcript (with positions counted
+    * from 1) in the order they were given.
+    *********************************************************************/
+    std::vector<exon> exons;
+
+};
+/*****************************************************************//**
+* @brief transcript annotation class
+*
+* This represents the transcripts of a BED12 or GTF annotation file
+* whose sequences can be taken from a reference genome.
+* BED12 lines describe a transcript each (with 0-based start
+* positions), GTF lines describe an exon each (with 1-based positions)
+* and are grouped by their transcript_id attribute (lines of other
+* features are ignored).
+* Only the locations are held, the sequence of a transcript is
+* extracted (spliced and on its strand) when its sequence file entry is
+* requested, so transcripts that are not needed are never read from the
+* genome.
+*
+* @see referenceGenome
+* @see sequenceFileEntry
+*********************************************************************/
+
+class transcriptAnnotation {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to read the transcripts of an annotation file.
+    * Invalid lines are reported and skipped.
+    * If the file cannot be read an error is raised and the annotation is
+    * created without any transcripts.
+    *
+    * @param the_path filePath to the BED12 or GTF file
+    *
+    * @return transcriptAnnotation for the given file
+    *********************************************************************/
+    transcriptAnnotation(const filePath & the_path);
+
+    /*****************************************************************//**
+    * @brief get method for transcript count
+    *
+    * This method is used to access the number of transcripts in the
+    * annotation.
+    *
+    * @return the number of transcripts in the annotation
+    *********************************************************************/
+    inline unsigned long size() const;
+
+    /*****************************************************************//**
+    * @brief get method for transcript IDs
+    *
+    * This method is used to access the ID of a transcript without
+    * extracting its sequence.
+    *
+    * @param index unsigned long representing the number of the
+    *     transcript in the annotation (less than its size)
+    *
+    * @return the ID of the transcript
+    *********************************************************************/
+    inline const sequenceID & get_ID(unsigned long index) const;
+
+    /*****************************************************************//**
+    * @brief sequence file entry creation
+    *
+    * This method is used to assign the sequence file entry of a
+    * transcript to a given entry taking the spliced sequence of its
+    * exons from a genome (reverse complemented for transcripts on the
+    * - strand).
+    * Ns and other ambiguous bases of the genome are masked.
+    * If an exon is not on the genome an error is raised and the entry is
+    * not changed.
+    *
+    * @param index unsigned long representing the number of the
+    *     transcript in the annotation (less than its size)
+    * @param genome const referenceGenome reference to the genome the
+    *     sequence is taken from
+    * @param entry sequenceFileEntry reference the entry is assigned to
+    *
+    * @return true if the entry was assigned, false otherwise
+    *********************************************************************/
+    bool get_entry(unsigned long index, const referenceGenome & genome, sequenceFileEntry & entry) const;
+
+
+  private:
+    /*****************************************************************//**
+    * @brief BED12 line parsing
+    *
+    * This method is used to add the transcript described by the fields
+    * of a BED12 line.
+    *
+    * @param fields const fieldView array holding the twelve fields
+    *
+    * @return true if the fields describe a valid transcript, false
+    *     otherwise
+    *********************************************************************/
+    bool add_BED_line(const fieldView fields[]);
+
+    /*****************************************************************//**
+    * @brief GTF line parsing
+    *
+    * This method is used to add the exon described by the fields of a
+    * GTF line to its transcript (lines of other features are accepted
+    * but ignored).
+    *
+    * @param fields const fieldView array holding the nine fields
+    *
+    * @return true if the fields describe a valid feature, false
+    *     otherwise
+    *********************************************************************/
+    bool add_GTF_line(const fieldView fields[]);
+
+    /*****************************************************************//**
+    * @brief transcripts
+    *
+    * This holds the transcripts in the order they first appear in the
+    * file.
+    *********************************************************************/
+    std::vector<annotatedTranscript> transcripts;
+
+    /*****************************************************************//**
+    * @brief GTF transcript numbers
+    *
+    * This holds the number of every transcript read from GTF lines, so
+    * their exons can be added to it.
+    *********************************************************************/
+    std::map<sequenceID,unsigned long> GTF_transcripts;
+
+};
+    /*****************************************************************//**
+    * @brief get method for transcript count
+    *
+    * This method is used to access the number of transcripts in the
+    * annotation.
+    *
+    * @return the number of transcripts in the annotation
+    *********************************************************************/
+    inline unsigned long transcriptAnnotation::size() const {
+      return transcripts.size();
+}
+
+    /*****************************************************************//**
+    * @brief get method for transcript IDs
+    *
+    * This method is used to access the ID of a transcript without
+    * extracting its sequence.
+    *
+    * @param index unsigned long representing the number of the
+    *     transcript in the annotation (less than its size)
+    *
+    * @return the ID of the transcript
+    *********************************************************************/
+    inline const sequenceID & transcriptAnnotation::get_ID(unsigned long index) const {
+      return transcripts[index].ID;
+}
+
+
+} // namespace microSNPscore
+#endif
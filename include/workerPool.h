@@ -0,0 +1,367 @@
+#ifndef MICROSNPSCORE_WORKERPOOL_H
+#define MICROSNPSCORE_WORKERPOOL_H
+
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <sys/types.h>
+//for pid_t (worker process IDs)
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief worker task interface
+*
+* This represents the work to be done by a worker pool for each
+* request. Implementations turn a request string into a result string
+* and must not depend on the order in which requests are processed.
+*
+* @see workerPool
+*********************************************************************/
+
+class workerTask {
+  public:
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to destroy a worker task.
+    *********************************************************************/
+    virtual ~workerTask();
+
+    /*****************************************************************//**
+    * @brief request processing
+    *
+    * This method is used to process a single request.
+    *
+    * @param request const std::string reference to the request to be
+    *     processed
+    *
+    * @return the result of the request (may be empty)
+    *********************************************************************/
+    virtual std::string process(const std::string & request) = 0;
+
+};
+/*****************************************************************//**
+* @brief request source interface
+*
+* This represents the source the requests processed by a worker pool
+* are taken from.
+*
+* @see workerPool
+*********************************************************************/
+
+class requestSource {
+  public:
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to destroy a request source.
+    *********************************************************************/
+    virtual ~requestSource();
+
+    /*****************************************************************//**
+    * @brief next request
+    *
+    * This method is used to get the next request to be processed.
+    *
+    * @param request std::string reference the next request is assigned
+    *     to
+    *
+    * @return true if a request was assigned, false if there are no more
+    *     requests
+    *********************************************************************/
+    virtual bool next_request(std::string & request) = 0;
+
+};
+/*****************************************************************//**
+* @brief result sink interface
+*
+* This represents the destination the results of a worker pool are
+* passed to in the order of their requests.
+*
+* @see workerPool
+*********************************************************************/
+
+class resultSink {
+  public:
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to destroy a result sink.
+    *********************************************************************/
+    virtual ~resultSink();
+
+    /*****************************************************************//**
+    * @brief result insertion
+    *
+    * This method is used to pass the next result to the sink.
+    *
+    * @param result const std::string reference to the result
+    *********************************************************************/
+    virtual void put_result(const std::string & result) = 0;
+
+};
+/*****************************************************************//**
+* @brief worker pool class
+*
+* This represents a pool of worker processes processing the requests
+* of a request source with a worker task and passing the results to a
+* result sink in request order.
+* Workers are forked processes instead of threads because the RNAplfold
+* library code used for the accessibility calculation keeps its state
+* in global variables. Data loaded before calling the @p run method is
+* shared with the workers (copy-on-write) and must not be changed by
+* the task.
+* A pool with a single worker processes all requests in the calling
+* process without forking.
+*
+* @see workerTask
+* @see requestSource
+* @see resultSink
+*********************************************************************/
+
+class workerPool {
+  public:
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a worker pool.
+    * The workers are not started until the @p run method is called.
+    *
+    * @param the_task workerTask reference to the task the workers should
+    *     process the requests with
+    * @param the_worker_count (optional) unsigned short representing the
+    *     number of worker processes - Defaults to 1
+    * @param the_queue_depth (optional) unsigned short representing the
+    *     maximal number of requests queued per worker - Defaults to 16
+    *
+    * @return a worker pool processing requests with the given task
+    *
+    * @see run()
+    *********************************************************************/
+    workerPool(workerTask & the_task, unsigned short the_worker_count = 1, unsigned short the_queue_depth = 16);
+
+    /*****************************************************************//**
+    * @brief request processing
+    *
+    * This method is used to process all requests of the given source
+    * passing the results to the given sink in the order of the requests.
+    * The number of results held back to restore the request order is
+    * limited by the number of workers times the queue depth.
+    * If a worker process cannot be started or terminates unexpectedly an
+    * error is raised and the processing is stopped.
+    *
+    * @param source requestSource reference to take the requests from
+    * @param sink resultSink reference to pass the results to
+    *
+    * @return true if all requests were processed, false otherwise
+    *********************************************************************/
+    bool run(requestSource & source, resultSink & sink);
+
+    /*****************************************************************//**
+    * @brief get method for worker count attribute
+    *
+    * This method is used to access the number of worker processes.
+    *
+    * @return the number of worker processes
+    *********************************************************************/
+    inline const unsigned short get_worker_count() const;
+
+    /*****************************************************************//**
+    * @brief frame creation
+    *
+    * This method is used to append a length-prefixed frame containing
+    * the given payload to a buffer.
+    * Frames are used for the worker pipes and may be used for other
+    * byte streams carrying payloads that may contain newlines.
+    *
+    * @param buffer std::string reference to append the frame to
+    * @param payload const std::string reference to the frame's payload
+    *********************************************************************/
+    static void append_frame(std::string & buffer, const std::string & payload);
+
+    /*****************************************************************//**
+    * @brief frame extraction
+    *
+    * This method is used to extract a complete length-prefixed frame
+    * starting at a given offset of a buffer. The buffer is left as it is
+    * and the offset is moved behind the frame so consecutive frames are
+    * extracted without moving the remaining bytes.
+    *
+    * @param buffer const std::string reference to extract the frame from
+    * @param offset std::string::size_type reference to the offset of
+    *     the frame (moved behind it if it is complete)
+    * @param payload std::string reference the frame's payload is
+    *     assigned to
+    *
+    * @return true if a complete frame was extracted, false otherwise
+    *
+    * @see compact_buffer()
+    *********************************************************************/
+    static bool extract_frame(const std::string & buffer, std::string::size_type & offset, std::string & payload);
+
+    /*****************************************************************//**
+    * @brief buffer compaction
+    *
+    * This method is used to drop the consumed bytes before a given
+    * offset from a buffer. To keep appending and consuming linear, the
+    * bytes are only moved once the consumed part exceeds half of the
+    * buffer (an entirely consumed buffer is simply cleared).
+    *
+    * @param buffer std::string reference to compact
+    * @param offset std::string::size_type reference to the number of
+    *     consumed bytes at the beginning of the buffer (reset to zero if
+    *     they are dropped)
+    *********************************************************************/
+    static void compact_buffer(std::string & buffer, std::string::size_type & offset);
+
+
+  private:
+    /*****************************************************************//**
+    * @brief worker process
+    *
+    * This represents the parent's end of a worker process.
+    *********************************************************************/
+    struct worker {
+        /*****************************************************************//**
+        * @brief process ID
+        *
+        * This is the process ID of the worker.
+        *********************************************************************/
+        pid_t pid;
+
+        /*****************************************************************//**
+        * @brief request file descriptor
+        *
+        * This is the (non-blocking) pipe end requests are written to.
+        *********************************************************************/
+        int request_fd;
+
+        /*****************************************************************//**
+        * @brief result file descriptor
+        *
+        * This is the (non-blocking) pipe end results are read from.
+        *********************************************************************/
+        int result_fd;
+
+        /*****************************************************************//**
+        * @brief request buffer
+        *
+        * This holds framed requests not yet written to the worker
+        * (behind the written offset).
+        *********************************************************************/
+        std::string requests;
+
+        /*****************************************************************//**
+        * @brief written offset
+        *
+        * This is the number of bytes at the beginning of the request
+        * buffer already written to the worker.
+        *********************************************************************/
+        std::string::size_type requests_written;
+
+        /*****************************************************************//**
+        * @brief result buffer
+        *
+        * This holds result bytes read from the worker but not yet
+        * complete (behind the extracted offset).
+        *********************************************************************/
+        std::string results;
+
+        /*****************************************************************//**
+        * @brief extracted offset
+        *
+        * This is the number of bytes at the beginning of the result
+        * buffer already extracted as complete frames.
+        *********************************************************************/
+        std::string::size_type results_extracted;
+
+        /*****************************************************************//**
+        * @brief request numbers
+        *
+        * This holds the numbers of the requests sent to the worker whose
+        * results have not been read yet in the order they were sent.
+        *********************************************************************/
+        std::deque<unsigned long> in_flight;
+
+    };
+
+    /*****************************************************************//**
+    * @brief worker process main loop
+    *
+    * This method is run in a forked worker process. It reads framed
+    * requests from the given file descriptor, processes them with the
+    * task and writes the framed results to the other file descriptor
+    * until the request pipe is closed.
+    *
+    * @param request_fd file descriptor to read requests from
+    * @param result_fd file descriptor to write results to
+    *
+    * @return true if the request pipe was closed properly, false on
+    *     errors
+    *********************************************************************/
+    bool serve(int request_fd, int result_fd);
+
+    /*****************************************************************//**
+    * @brief worker process start
+    *
+    * This method is used to fork the worker processes.
+    *
+    * @return true if all worker processes were started, false otherwise
+    *********************************************************************/
+    bool start_workers();
+
+    /*****************************************************************//**
+    * @brief worker process stop
+    *
+    * This method is used to close the pipes to the worker processes
+    * and wait for their termination.
+    *
+    * @return true if all workers terminated normally, false otherwise
+    *********************************************************************/
+    bool stop_workers();
+
+    /*****************************************************************//**
+    * @brief worker task
+    *
+    * This is the task the requests are processed with.
+    *********************************************************************/
+    workerTask & task;
+
+    /*****************************************************************//**
+    * @brief worker count
+    *
+    * This is the number of worker processes.
+    *********************************************************************/
+    const unsigned short worker_count;
+
+    /*****************************************************************//**
+    * @brief queue depth
+    *
+    * This is the maximal number of requests queued per worker.
+    *********************************************************************/
+    const unsigned short queue_depth;
+
+    /*****************************************************************//**
+    * @brief workers
+    *
+    * This holds the parent's ends of the running worker processes.
+    *********************************************************************/
+    std::vector<worker> workers;
+
+};
+    /*****************************************************************//**
+    * @brief get method for worker count attribute
+    *
+    * This method is used to access the number of worker processes.
+    *
+    * @return the number of worker processes
+    *********************************************************************/
+    inline const unsigned short workerPool::get_worker_count() const {
+      return worker_count;
+    }
+
+
+} // namespace microSNPscore
+#endif
@@ -133,6 +133,69 @@ namespace microSNPscore {
       }
 }
 
+    /*****************************************************************//**
+    * @brief check prediction influence
+    *
+    * This method is used to check whether the SNP may have influence on
+    * the downregulation of a given mRNA by a given miRNA, i.e. whether
+    * it matches the miRNA or the mRNA.
+    *
+    * @param the_miRNA miRNA that is predicted to downregulate the mRNA
+    * @param the_mRNA mRNA that is predicted to be downregulated by the
+    *     miRNA
+    *
+    * @return @p true if the SNP matches the miRNA or the mRNA, @p false
+    *     otherwise
+    *
+    * @see matches()
+    *********************************************************************/
+    bool SNP::affects(const miRNA & the_miRNA, const mRNA & the_mRNA) const {
+      return matches(the_miRNA) || matches(the_mRNA);
+}
+
+    /*****************************************************************//**
+    * @brief calculate mutant downregulation score
+    *
+    * This method calculates the downregulation score of a given mRNA by
+    * a given miRNA binding at a target site starting at a given position
+    * with the SNP applied to the miRNA (if it matches the miRNA) or to
+    * the mRNA (shifting the predicted 3' position if it is downstream of
+    * the SNP) otherwise.
+    * The SNP is expected to affect the prediction (see @p affects).
+    *
+    * @param the_miRNA  miRNA that is predicted to downregulate by the
+    *     mRNA
+    * @param the_mRNA  mRNA that is predicted to be downregulated by the
+    *     miRNA
+    * @param predicted_three_prime_position position on chromosome (the
+    *     5' end of the + strand (i.e. the 3' end of the - strand) beeing
+    *     position 1) that is predicted to be the mRNA nucleotide that
+    *     would bind the miRNA 5' end (if it would bind) (i.e. one base
+    *     downstream (3') from the seed match region)
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
+    * @param verbose (optional) bool indicating wheter verbose output
+    *     to STDERR should be done or not - Defaults to false
+    *
+    * @return the downregulation score of the mutant target site
+    *
+    * @see affects()
+    * @see miRNA::get_downregulation_score()
+    *********************************************************************/
+    downregulationScore SNP::get_mutant_score(const miRNA & the_miRNA, const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, const conservationList & conservations, bool verbose) const {
+       /*************************************************************\ 
+      | Mutate the miRNA if the SNP matches it and the mRNA otherwise |
+      | shifting the predicted 3' position if it is located behind    |
+      | the reference:                                                |
+       \*************************************************************/
+      return matches(the_miRNA) ? the_miRNA.mutate(*this).get_downregulation_score(the_mRNA,predicted_three_prime_position,conservations,verbose) :
+                                  the_miRNA.get_downregulation_score(the_mRNA.mutate(*this),predicted_three_prime_position +
+                                                                     (predicted_three_prime_position < (get_position(Plus) +
+                                                                                                        reference_end(Plus) -
+                                                                                                        reference_begin(Plus)) ?
+                                                                      0 : get_shift()),conservations,verbose);
+}
+
     /*****************************************************************//**
     * @brief calculate deregulation score
     *
@@ -150,6 +213,8 @@ namespace microSNPscore {
     *     position 1) that is predicted to be the mRNA nucleotide that
     *     would bind the miRNA 5' end (if it would bind) (i.e. one base
     *     downstream (3') from the seed match region)
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
@@ -159,7 +224,7 @@ namespace microSNPscore {
     * @see miRNA::get_downregulation_score()
     *********************************************************************/
     
-    deregulationScore SNP::get_deregulation_score(const miRNA & the_miRNA, const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, bool verbose) const {
+    deregulationScore SNP::get_deregulation_score(const miRNA & the_miRNA, const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, const conservationList & conservations, bool verbose) const {
        /*************************************************************\ 
       | Verify that the SNP may have influence on the downregulation  |
       | score and if so return the score difference between reference |
@@ -189,14 +254,9 @@ namespace microSNPscore {
       {
         if(verbose){std::cerr << "microSNPscore:    deregulation score calculation: ...SNP does match prediction --> calculating score" << std::endl
                               << "microSNPscore:    deregulation score calculation: Calculating wildtype score..." << std::endl;}
-        downregulationScore wt_score = the_miRNA.get_downregulation_score(the_mRNA,predicted_three_prime_position,verbose);
+        downregulationScore wt_score = the_miRNA.get_downregulation_score(the_mRNA,predicted_three_prime_position,conservations,verbose);
         if(verbose){std::cerr << "microSNPscore:    deregulation score calculation: Calculating mutant score..." << std::endl;}
-        downregulationScore mt_score = (SNP_on_miRNA ? the_miRNA.mutate(*this).get_downregulation_score(the_mRNA,predicted_three_prime_position,verbose) :
-                                                       the_miRNA.get_downregulation_score(the_mRNA.mutate(*this),predicted_three_prime_position +
-                                                                                          (predicted_three_prime_position < (get_position(Plus) +
-                                                                                                                             reference_end(Plus) -
-                                                                                                                             reference_begin(Plus)) ?
-                                                                                           0 : get_shift()),verbose));
+        downregulationScore mt_score = get_mutant_score(the_miRNA,the_mRNA,predicted_three_prime_position,conservations,verbose);
         if(verbose){std::cerr << "microSNPscore:    deregulation score calculation: ...wildtype score is " << wt_score << std::endl
                               << "microSNPscore:    deregulation score calculation: ...mutant score is " << mt_score << std::endl
                               << "microSNPscore:    deregulation score calculation: ...deregulation score is " << wt_score - mt_score << std::endl
@@ -205,6 +265,56 @@ namespace microSNPscore {
       }
 }
 
+    /*****************************************************************//**
+    * @brief calculate deregulation score from wildtype score
+    *
+    * This method does the same as the one calculating the wildtype
+    * score itself but takes the wildtype downregulation score of the
+    * target site (as calculated by miRNA::get_downregulation_score())
+    * instead, allowing to share it between all SNPs predicted for the
+    * same target site.
+    *
+    * @param the_miRNA  miRNA that is predicted to downregulate by the
+    *     mRNA
+    * @param the_mRNA  mRNA that is predicted to be downregulated by the
+    *     miRNA
+    * @param predicted_three_prime_position position on chromosome (the
+    *     5' end of the + strand (i.e. the 3' end of the - strand) beeing
+    *     position 1) that is predicted to be the mRNA nucleotide that
+    *     would bind the miRNA 5' end (if it would bind) (i.e. one base
+    *     downstream (3') from the seed match region)
+    * @param wildtype_score downregulationScore of the miRNA for the
+    *     target site in the unmutated mRNA
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
+    * @param verbose (optional) bool indicating wheter verbose output
+    *     to STDERR should be done or not - Defaults to false
+    *
+    * @return the deregulation score of the SNP for the target site of
+    *     the miRNA starting at the given position in the given mRNA
+    *
+    * @see get_mutant_score()
+    *********************************************************************/
+    deregulationScore SNP::get_deregulation_score(const miRNA & the_miRNA, const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, downregulationScore wildtype_score, const conservationList & conservations, bool verbose) const {
+       /************************************************************\ 
+      | Verify that the SNP may have influence on the downregulation |
+      | score and if so return the difference between the given      |
+      | wildtype score and the mutant score:                         |
+       \************************************************************/
+      if(!affects(the_miRNA,the_mRNA))
+      {
+        if(verbose){std::cerr << "microSNPscore:    deregulation score calculation: ...SNP does not match prediction --> score is 0" << std::endl;}
+        return 0;
+      }
+      if(verbose){std::cerr << "microSNPscore:    deregulation score calculation: Calculating mutant score..." << std::endl;}
+      downregulationScore mt_score = get_mutant_score(the_miRNA,the_mRNA,predicted_three_prime_position,conservations,verbose);
+      if(verbose){std::cerr << "microSNPscore:    deregulation score calculation: ...wildtype score is " << wildtype_score << std::endl
+                            << "microSNPscore:    deregulation score calculation: ...mutant score is " << mt_score << std::endl
+                            << "microSNPscore:    deregulation score calculation: ...deregulation score is " << wildtype_score - mt_score << std::endl
+                            << "microSNPscore:    deregulation score calculation: ...done" << std::endl;}
+      return wildtype_score - mt_score;
+}
+
     /*****************************************************************//**
     * @brief convert char to nucleo base
     *
@@ -0,0 +1,79 @@
+#include <algorithm>
+//for std::sort and std::lower_bound (position ordering)
+#include "SNPIndex.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create an SNPIndex for the SNPs of a given table.
+    * The index refers to the SNPs by their IDs in the table.
+    *
+    * @param the_SNPs const entityTable reference to the SNPs to be
+    *     indexed
+    *
+    * @return SNPIndex for the given SNPs
+    *********************************************************************/
+    SNPIndex::SNPIndex(const entityTable<SNPID,SNP> & the_SNPs) {
+       /**************************************************************\ 
+      | Insert every SNP's reference range into the list of its        |
+      | chromosome (counting insertions without reference as one base) |
+      | and sort the lists by start position afterwards:               |
+       \**************************************************************/
+      for(entityID SNP_ID(0);SNP_ID!=the_SNPs.size();++SNP_ID)
+      {
+        const SNP & the_SNP(the_SNPs[SNP_ID]);
+        const chromosomePosition length(std::max<chromosomePosition>(1,the_SNP.reference_end(Plus)-the_SNP.reference_begin(Plus)));
+        const chromosomePosition start(the_SNP.get_position(Plus));
+        starts[the_SNP.get_chromosome()].push_back(std::make_pair(std::make_pair(start,start+length-1),SNP_ID));
+        chromosomePosition & max_length(max_lengths[the_SNP.get_chromosome()]);
+        max_length = std::max(max_length,length);
+      }
+      for(std::map<chromosomeType,std::vector<std::pair<std::pair<chromosomePosition,chromosomePosition>,entityID> > >::iterator
+          chromosome_it(starts.begin());chromosome_it!=starts.end();++chromosome_it)
+      {
+        std::sort(chromosome_it->second.begin(),chromosome_it->second.end());
+      }
+}
+
+    /*****************************************************************//**
+    * @brief range query
+    *
+    * This method is used to find all SNPs whose reference overlaps a
+    * given range of a chromosome.
+    * The IDs found are appended to the given vector in order of the
+    * SNPs' positions.
+    *
+    * @param the_chromosome chromosomeType of the chromosome to search
+    * @param from chromosomePosition of the first position of the range
+    * @param to chromosomePosition of the last position of the range
+    * @param IDs std::vector reference the SNP IDs are appended to
+    *********************************************************************/
+    void SNPIndex::find(const chromosomeType & the_chromosome, chromosomePosition from, chromosomePosition to, std::vector<entityID> & IDs) const {
+       /**************************************************************\ 
+      | Start at the first SNP that may reach into the range given the |
+      | chromosome's longest reference and append the IDs of those     |
+      | ending inside or behind it until the range end is passed:      |
+       \**************************************************************/
+      std::map<chromosomeType,std::vector<std::pair<std::pair<chromosomePosition,chromosomePosition>,entityID> > >::const_iterator
+        chromosome_it(starts.find(the_chromosome));
+      if(chromosome_it == starts.end())
+      {
+        return;
+      }
+      const chromosomePosition max_length(max_lengths.find(the_chromosome)->second);
+      const chromosomePosition first_start(from > max_length ? from - max_length + 1 : 0);
+      for(std::vector<std::pair<std::pair<chromosomePosition,chromosomePosition>,entityID> >::const_iterator
+          SNP_it(std::lower_bound(chromosome_it->second.begin(),chromosome_it->second.end(),std::make_pair(std::make_pair(first_start,chromosomePosition(0)),entityID(0))));
+          SNP_it!=chromosome_it->second.end() && SNP_it->first.first<=to;++SNP_it)
+      {
+        if(SNP_it->first.second >= from)
+        {
+          IDs.push_back(SNP_it->second);
+        }
+      }
+}
+
+
+} // namespace microSNPscore
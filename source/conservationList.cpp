@@ -2,18 +2,158 @@
 #include <iostream>
 // for std::cerr and std::endl (error stating)
 #include <algorithm>
-// for std::lower_bound (binary search for ranges)
+// for std::upper_bound, std::min and std::max (binary search for ranges and region merging)
 #include <fstream>
-// for std::ifstream (file reading)
-#include <regex.h>
-// for regex_t, regmatch_t, regcomp and regexec (regular expressions)
-#include <sstream>
-// for std::istringstream (type conversion)
+// for std::ofstream and std::ifstream (track writing and detection)
+#include <cstdio>
+// for std::rename and std::remove (track replacement)
+#include <string.h>
+// for memcpy, memcmp and strerror (score keys, magic checking and error stating)
+#include <errno.h>
+// for errno (error stating)
+#include <stdint.h>
+// for uint16_t, uint32_t and uint64_t (file layout)
+#include <unistd.h>
+// for close (file access)
+#include <fcntl.h>
+// for open (file access)
+#include <sys/mman.h>
+// for mmap, madvise and munmap (file mapping)
+#include <sys/stat.h>
+// for fstat (file size)
 
 #include "conservationList.h"
+#include "lineReader.h"
 
 namespace microSNPscore {
 
+    const chromosomeID conservationList::unknown_chromosome;
+
+    const size_t conservationList::block_size;
+
+    /*****************************************************************//**
+    * @brief track header
+    *
+    * This is the layout of the first bytes of a conservation track.
+    *********************************************************************/
+    struct trackHeader {
+      char magic[8];
+      uint64_t version;
+      uint64_t byte_order;
+      uint64_t block_size;
+      uint64_t chromosome_count;
+      uint64_t chromosomes_offset;
+      uint64_t score_count;
+      uint64_t scores_offset;
+    };
+
+    /*****************************************************************//**
+    * @brief track chromosome
+    *
+    * This is the layout of the entry of one chromosome in the chromosome
+    * table of a conservation track (offsets of blocks are relative to the
+    * file start, those in the block offset table are relative to the
+    * chromosome's deltas).
+    *********************************************************************/
+    struct trackChromosome {
+      uint64_t name_offset;
+      uint64_t name_length;
+      uint64_t range_count;
+      uint64_t block_starts_offset;
+      uint64_t block_offsets_offset;
+      uint64_t deltas_offset;
+      uint64_t deltas_size;
+      uint64_t scores_offset;
+    };
+
+    /*****************************************************************//**
+    * @brief track magic
+    *
+    * This identifies a file as conservation track.
+    *********************************************************************/
+    static const char track_magic[8] = {'m','S','N','P','c','o','n','\0'};
+
+    /*****************************************************************//**
+    * @brief track version
+    *
+    * This is the version of the file layout written and understood.
+    *********************************************************************/
+    static const uint64_t track_version(1);
+
+    /*****************************************************************//**
+    * @brief byte order mark
+    *
+    * This is written to detect tracks written with another byte order.
+    *********************************************************************/
+    static const uint64_t track_byte_order(0x0102030405060708ULL);
+
+    /*****************************************************************//**
+    * @brief data appending
+    *
+    * This is used to append a block of data to a track file padding it
+    * to a multiple of 8 bytes (so all blocks are aligned).
+    *
+    * @param file std::ofstream reference to the track file
+    * @param offset uint64_t reference to the current end of the file
+    *     (moved behind the appended block)
+    * @param data const void pointer to the data
+    * @param size size_t representing the number of bytes to append
+    *
+    * @return the offset of the appended block in the file
+    *********************************************************************/
+    static uint64_t append_block(std::ofstream & file, uint64_t & offset, const void * data, size_t size) {
+      static const char padding[8] = {0,0,0,0,0,0,0,0};
+      const uint64_t block_offset(offset);
+      file.write(static_cast<const char *>(data),size);
+      file.write(padding,(8 - size % 8) % 8);
+      offset += size + (8 - size % 8) % 8;
+      return block_offset;
+}
+
+    /*****************************************************************//**
+    * @brief delta reading
+    *
+    * This is used to read a start delta of a conservation track (stored
+    * in 7 bit groups starting with the lowest one, the highest bit of
+    * each byte telling whether another group follows).
+    *
+    * @param byte const unsigned char pointer reference to the first byte
+    *     of the delta (moved behind it)
+    * @param end const unsigned char pointer behind the last byte that
+    *     may be read
+    * @param delta uint64_t reference the delta is assigned to
+    *
+    * @return true if a complete delta of at most 5 bytes was read, false
+    *     otherwise
+    *********************************************************************/
+    static inline bool read_delta(const unsigned char * & byte, const unsigned char * end, uint64_t & delta) {
+      delta = 0;
+      for(unsigned short shift(0);byte!=end && shift<35;shift+=7)
+      {
+        delta |= uint64_t(*byte & 0x7f) << shift;
+        if((*byte++ & 0x80) == 0)
+        {
+          return true;
+        }
+      }
+      return false;
+}
+
+    /*****************************************************************//**
+    * @brief track chromosome access
+    *
+    * This is used to access the chromosome table entry of a chromosome
+    * of a mapped conservation track.
+    *
+    * @param mapping const char pointer to the first byte of the track
+    * @param chromosome chromosomeID of the chromosome
+    *
+    * @return the entry of the chromosome
+    *********************************************************************/
+    static inline const trackChromosome & track_chromosome(const char * mapping, chromosomeID chromosome) {
+      return reinterpret_cast<const trackChromosome *>(mapping + reinterpret_cast<const trackHeader *>(mapping)->chromosomes_offset)[chromosome];
+}
+
     /*****************************************************************//**
     * @brief constructor - Do not call without parameter values!
     *
@@ -43,6 +183,105 @@ namespace microSNPscore {
     :chromosome(the_chromosome),start(the_start),score(the_score) {
 }
 
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create an empty region set.
+    *
+    * @return a genomicRegions without any region
+    *********************************************************************/
+    genomicRegions::genomicRegions()
+    :chromosomes() {
+}
+
+    /*****************************************************************//**
+    * @brief region insertion
+    *
+    * This method is used to add a region to the set (merging it with
+    * the regions it overlaps or touches).
+    *
+    * @param chromosome const chromosomeType reference to the chromosome
+    *     the region is located on
+    * @param start chromosomePosition of the first position of the region
+    * @param end chromosomePosition of the last position of the region
+    *     (regions ending before their start are ignored)
+    *********************************************************************/
+    void genomicRegions::add(const chromosomeType & chromosome, chromosomePosition start, chromosomePosition end) {
+      if(end < start)
+      {
+        return;
+      }
+       /**************************************************************\ 
+      | Extend the region to the start of the preceding region if they |
+      | overlap or touch (and stop if that one covers it completely),  |
+      | then swallow all following regions starting at most one        |
+      | position behind its end:                                       |
+       \**************************************************************/
+      std::map<chromosomePosition,chromosomePosition> & regions(chromosomes[chromosome]);
+      std::map<chromosomePosition,chromosomePosition>::iterator region_it(regions.upper_bound(start));
+      if(region_it != regions.begin())
+      {
+        std::map<chromosomePosition,chromosomePosition>::iterator preceding_it(region_it);
+        --preceding_it;
+        if(preceding_it->second >= end)
+        {
+          return;
+        }
+        if(preceding_it->second >= start || start - preceding_it->second == 1)
+        {
+          start = preceding_it->first;
+          region_it = preceding_it;
+        }
+      }
+      while(region_it != regions.end() && (region_it->first <= end || region_it->first - end == 1))
+      {
+        end = std::max(end,region_it->second);
+        regions.erase(region_it++);
+      }
+      regions[start] = end;
+}
+
+    /*****************************************************************//**
+    * @brief sequence insertion
+    *
+    * This method is used to add the exons of a sequence to the set.
+    *
+    * @param the_sequence const sequence reference to the sequence
+    *********************************************************************/
+    void genomicRegions::add(const sequence & the_sequence) {
+      for(sequence::const_exon_iterator exon_it(the_sequence.exons_begin());exon_it!=the_sequence.exons_end();++exon_it)
+      {
+        add(the_sequence.get_chromosome(),exon_it->get_start(),exon_it->get_end());
+      }
+}
+
+    /*****************************************************************//**
+    * @brief overlap check
+    *
+    * This method is used to check whether a range of positions on a
+    * chromosome shares a position with any region of the set.
+    *
+    * @param chromosome const chromosomeType reference to the chromosome
+    *     the range is located on
+    * @param start chromosomePosition of the first position of the range
+    * @param end chromosomePosition of the last position of the range
+    *
+    * @return true if the range overlaps a region, false otherwise
+    *********************************************************************/
+    bool genomicRegions::overlaps(const chromosomeType & chromosome, chromosomePosition start, chromosomePosition end) const {
+       /*************************************************************\ 
+      | The range overlaps a region if the last region starting at or |
+      | before its end (the regions are disjoint) reaches its start:  |
+       \*************************************************************/
+      const std::map<chromosomeType,std::map<chromosomePosition,chromosomePosition> >::const_iterator chromosome_it(chromosomes.find(chromosome));
+      if(chromosome_it == chromosomes.end())
+      {
+        return false;
+      }
+      std::map<chromosomePosition,chromosomePosition>::const_iterator region_it(chromosome_it->second.upper_bound(end));
+      return region_it != chromosome_it->second.begin() && (--region_it)->second >= start;
+}
+
     /*****************************************************************//**
     * @brief constructor
     *
@@ -55,18 +294,38 @@ namespace microSNPscore {
     * error is raised and an empty list is created.
     * If a line does not match the format or is not in order, an error is
     * raised and the line is ignored.
+    * If regions are given, only the ranges overlapping them are kept
+    * (which gives the same scores for all positions inside the regions)
+    * and the errors for chromosomes of the regions without ranges (or
+    * with regions before their first range) are raised right away.
+    * If the file is a conservation track it is mapped instead (see
+    * @p convert) and if it is no valid track of the current version an
+    * error is raised and an empty list is created.
     *
     * @param conservation_file file path of the input file
+    * @param regions (optional) const genomicRegions pointer to the
+    *     regions the scores will be looked up in (only checked for
+    *     coverage for tracks) - Defaults to NULL (keeping all ranges)
     *
     * @return a conservationList containing the ranges given in the file
     *********************************************************************/
-    conservationList::conservationList(const filePath & conservation_file) {
-       /********************************************************\ 
-      | Try to open an input file stream associated to the given |
-      | file path stating an error in the case of failure:       |
-       \********************************************************/
-      std::ifstream infile(conservation_file.c_str());
-      if(infile.fail())
+    conservationList::conservationList(const filePath & conservation_file, const genomicRegions * regions)
+    :chromosome_names(),chromosome_IDs(),chromosomes(),path(conservation_file),mapping(NULL),mapping_size(0),reported_chromosomes() {
+      if(is_track(conservation_file))
+      {
+        open_track();
+        if(regions != NULL)
+        {
+          report_uncovered(*regions);
+        }
+        return;
+      }
+       /*************************************************\ 
+      | Try to open a line reader for the given file path |
+      | stating an error in the case of failure:          |
+       \*************************************************/
+      lineReader infile(conservation_file);
+      if(!infile.is_open())
       {
         std::cerr << "microSNPscore::conservationList::conservationList\n";
         std::cerr << " ==> Cannot open file to read from: ";
@@ -75,96 +334,141 @@ namespace microSNPscore {
       }
       else
       {
-         /**************************************************************\ 
-        | Try to initialize extended regular expression matching a valid |
-        | conservation range line stating error in case of failure:      |
-         \**************************************************************/
-        regex_t line_regex;
-        char line_pattern[] = "^(.+)\t([[:digit:]]+)\t([-[:digit:].e+]+)$";
-        if(regcomp(&line_regex,line_pattern,REG_EXTENDED) != 0)
-        {
-          std::cerr << "microSNPscore::conservationList::conservationList\n";
-          std::cerr << " ==> compiling line regular expression failed\n";
-          std::cerr << "  --> no conservations will be read from the file\n";
-        }
-        else
+         /***********************************************************\ 
+        | Read the content of the file linewise and try to split each |
+        | line into a chromosome, a start position and a score field  |
+        | stating error in case of failure:                           |
+         \***********************************************************/
+        fieldView line;
+        fieldView fields[3];
+        bool pending(false);
+        chromosomeType pending_chromosome;
+        chromosomePosition pending_start(0);
+        conservationScore pending_score(0);
+        while(infile.next_line(line))
         {
-           /**************************************************************\ 
-          | Read the content of the file linewise into a string and try to |
-          | match the initialized regular expression stating error in case |
-          | of failure:                                                    |
-           \**************************************************************/
-          std::string line_string;
-          size_t line_nmatch(4);
-          regmatch_t line_pmatch[line_nmatch];
-          while(getline(infile,line_string).good())
+          chromosomePosition line_start;
+          conservationScore line_score;
+          if(!lineReader::split_fields(line,fields,3,true) || fields[0].begin == fields[0].end ||
+             !lineReader::parse_position(fields[1],line_start) || !lineReader::parse_score(fields[2],line_score))
+          {
+                std::cerr << "microSNPscore::conservationList::conservationList\n";
+                std::cerr << " ==> no valid conservation range:\n";
+                std::cerr << line.begin << std::endl;
+                std::cerr << "  --> omitting line\n";
+          }
+          else
           {
-            if(regexec(&line_regex,line_string.c_str(),line_nmatch,line_pmatch,0) != 0)
+             /***********************************************************\ 
+            | Check whether the line is in order with its predecessor (on |
+            | the same chromosome or on a preceding one) stating an error |
+            | if not:                                                     |
+             \***********************************************************/
+            const chromosomeType line_chromosome(fields[0].begin,fields[0].end);
+            const bool new_chromosome(!pending || line_chromosome != pending_chromosome);
+            if(pending && (new_chromosome ? line_chromosome < pending_chromosome : line_start <= pending_start))
             {
-                  std::cerr << "microSNPscore::conservationList::conservationList\n";
-                  std::cerr << " ==> no valid conservation range:\n";
-                  std::cerr << line_string << std::endl;
-                  std::cerr << "  --> omitting line\n";
+                std::cerr << "microSNPscore::conservationList::conservationList\n";
+                std::cerr << " ==> conservation range out of order:\n";
+                std::cerr << line.begin << std::endl;
+                std::cerr << "  --> omitting line\n";
             }
             else
             {
-               /*****************************************************************\ 
-              | Extract the subsequences matching the regular expression's groups |
-              | from the line assigning them to the corresponding parameters      |
-              | (converting them via a stringstream) create conservation range:   |
-               \*****************************************************************/
-              chromosomeType line_chromosome(line_string.substr(line_pmatch[1].rm_so,line_pmatch[1].rm_eo-line_pmatch[1].rm_so));
-              chromosomePosition line_start;
-              std::istringstream stream_start(line_string.substr(line_pmatch[2].rm_so,line_pmatch[2].rm_eo-line_pmatch[2].rm_so));
-              stream_start >> line_start;
-              conservationScore line_score;
-              std::istringstream stream_score(line_string.substr(line_pmatch[3].rm_so,line_pmatch[3].rm_eo-line_pmatch[3].rm_so));
-              stream_score >> line_score;
-              conservationRange line_range(line_chromosome,line_start,line_score);
-               /*******************************************************\ 
-              | If this is not the first line check whether is in order |
-              | with its predecessor stating an error if not:           |
-               \*******************************************************/
-              if(ranges.begin() != ranges.end() && line_range <= *(ranges.end()-1))
+               /*************************************************************\ 
+              | Keep the preceding range (which ends right before this one or |
+              | at the end of its chromosome) if no regions are given or it   |
+              | overlaps one of them and hold this one back until its end is  |
+              | known:                                                        |
+               \*************************************************************/
+              if(pending && (regions == NULL || regions->overlaps(pending_chromosome,pending_start,
+                                                                  new_chromosome ? chromosomePosition(-1) : line_start - 1)))
               {
-                  std::cerr << "microSNPscore::conservationList::conservationList\n";
-                  std::cerr << " ==> conservation range out of order:\n";
-                  std::cerr << line_string << std::endl;
-                  std::cerr << "  --> omitting line\n";
+                append_range(pending_chromosome,pending_start,pending_score);
               }
-              else
-              {
-                 /***********************************\ 
-                | Append the new range to the vector: |
-                 \***********************************/
-                ranges.push_back(line_range);
-              } // ranges.begin() == ranges.end() || line_range > *(ranges.end()-1)
-            } // regexec(&line_regex,line_string.c_str(),line_nmatch,line_pmatch,0) == 0
-          } // getline(infile,line_string).good()
-        } // regcomp(&line_regex,line_pattern,REG_EXTENDED) == 0
-      } // !infile.fail()
+              pending = true;
+              pending_chromosome = line_chromosome;
+              pending_start = line_start;
+              pending_score = line_score;
+            } // in order
+          } // valid line
+        } // infile.next_line(line)
+         /***************************************************\ 
+        | Keep the last range (ending at the end of its       |
+        | chromosome) under the same condition as the others: |
+         \***************************************************/
+        if(pending && (regions == NULL || regions->overlaps(pending_chromosome,pending_start,chromosomePosition(-1))))
+        {
+          append_range(pending_chromosome,pending_start,pending_score);
+        }
+      } // infile.is_open()
+      if(regions != NULL)
+      {
+        report_uncovered(*regions);
+      }
 }
 
     /*****************************************************************//**
-    * @brief conservation list begin
+    * @brief destructor
     *
-    * This is used to get the first conservation range in the list.
+    * This is used to unmap the conservation track (if any).
+    *********************************************************************/
+    conservationList::~conservationList() {
+      if(mapping != NULL)
+      {
+        munmap(const_cast<char *>(mapping),mapping_size);
+      }
+}
+
+    /*****************************************************************//**
+    * @brief range appending
     *
-    * @return const_iterator pointing to the first conservation range
+    * This method is used to append a range read from a text table to
+    * the partition of its chromosome (starting a new partition if the
+    * chromosome differs from the one of the last range appended).
+    *
+    * @param chromosome const chromosomeType reference to the chromosome
+    *     of the range
+    * @param start chromosomePosition where the range starts (after the
+    *     start of the last range appended on the same chromosome)
+    * @param score conservationScore of the range
     *********************************************************************/
-    conservationList::const_iterator conservationList::begin() const {
-      return ranges.begin();
+    void conservationList::append_range(const chromosomeType & chromosome, chromosomePosition start, conservationScore score) {
+       /***************************************************************\ 
+      | Start a partition for a new chromosome and append the range to  |
+      | the chromosome's partition (adding its start to the block index |
+      | if it begins a block):                                          |
+       \***************************************************************/
+      if(chromosome_names.empty() || chromosome != chromosome_names.back())
+      {
+        chromosome_IDs[chromosome] = chromosome_names.size();
+        chromosome_names.push_back(chromosome);
+        chromosomes.push_back(chromosomeConservation());
+      }
+      chromosomeConservation & partition(chromosomes.back());
+      if(partition.starts.size() % block_size == 0)
+      {
+        partition.block_starts.push_back(start);
+      }
+      partition.starts.push_back(start);
+      partition.scores.push_back(score);
 }
 
     /*****************************************************************//**
-    * @brief conservation list end
+    * @brief get method for chromosome IDs
+    *
+    * This method is used to look up the number of a chromosome once, so
+    * the scores on it can be accessed without comparing chromosome
+    * names.
     *
-    * This is used to get the end of the conservation list.
+    * @param chromosome const chromosomeType reference to the chromosome
     *
-    * @return const_iterator pointing behind the last conservation range
+    * @return the ID of the chromosome or @p unknown_chromosome if there
+    *     are no ranges on it
     *********************************************************************/
-    conservationList::const_iterator conservationList::end() const {
-      return ranges.end();
+    chromosomeID conservationList::get_chromosome_ID(const chromosomeType & chromosome) const {
+      const std::map<chromosomeType,chromosomeID>::const_iterator ID_it(chromosome_IDs.find(chromosome));
+      return ID_it != chromosome_IDs.end() ? ID_it->second : unknown_chromosome;
 }
 
     /*****************************************************************//**
@@ -172,7 +476,8 @@ namespace microSNPscore {
     *
     * This method is used to access the conservation score of a given
     * position on a given chromosome.
-    * If the chromosome is unknown, an error is raised and 0 is returned.
+    * If the chromosome is unknown, an error is raised (once per
+    * chromosome) and 0 is returned.
     *
     * @param chromosome the chromosome the position of interest is
     * located on
@@ -185,31 +490,608 @@ namespace microSNPscore {
     *********************************************************************/
     
     conservationScore conservationList::get_score(const chromosomeType & chromosome, const chromosomePosition & position) const {
+       /*****************************************************************\ 
+      | Look the chromosome up and search its partition (stating an error |
+      | and returning 0 if it has none):                                  |
+       \*****************************************************************/
+      const chromosomeID ID(get_chromosome_ID(chromosome));
+      if(ID == unknown_chromosome)
+      {
+        report_unknown(chromosome);
+        return 0;
+      }
+      return get_score(ID,position);
+}
+
+    /*****************************************************************//**
+    * @brief get conservation score by chromosome ID and position
+    *
+    * This method is used to access the conservation score of a given
+    * position on a chromosome given by its ID.
+    * If the position lies before the first range of the chromosome, an
+    * error is raised (once per chromosome) and 0 is returned.
+    *
+    * @param chromosome chromosomeID of the chromosome the position of
+    *     interest is located on (not @p unknown_chromosome)
+    * @param position the position of interest on the given chromosome
+    *     (the 5' end of the + strand (i.e. the 3' end of the - end)
+    *     beeing position 1)
+    *
+    * @return the conservation score of the given position on the given
+    *     chromosome
+    *
+    * @see get_chromosome_ID()
+    *********************************************************************/
+    conservationScore conservationList::get_score(chromosomeID chromosome, chromosomePosition position) const {
+       /*************************************************************\ 
+      | Find the last block starting at or before the position in the |
+      | block index (stating an error and returning 0 if there is     |
+      | none) and return the score of the last range starting at or   |
+      | before the position in this block (the last range of a        |
+      | chromosome covers the rest of it):                            |
+       \*************************************************************/
+      const size_t next_block(find_block(chromosome,position));
+      if(next_block == 0)
+      {
+        report_unknown(chromosome_names[chromosome]);
+        return 0;
+      }
+      chromosomePosition starts[block_size];
+      const size_t block_length(decode_block(chromosome,next_block - 1,starts));
+      return get_range_score(chromosome,(next_block - 1) * block_size + (std::upper_bound(starts,starts + block_length,position) - starts - 1));
+}
+
+    /*****************************************************************//**
+    * @brief unknown chromosome reporting
+    *
+    * This method is used to state the error of a position without a
+    * conservation range once per chromosome (further positions on a
+    * chromosome reported before are not stated again).
+    *
+    * @param chromosome const chromosomeType reference to the chromosome
+    *     of the position
+    *********************************************************************/
+    void conservationList::report_unknown(const chromosomeType & chromosome) const {
+      if(reported_chromosomes.insert(chromosome).second)
+      {
+        std::cerr << "microSNPscore::conservationList::get_score\n";
+        std::cerr << " ==> Unkown chromosome: " << chromosome << std::endl;
+        std::cerr << "  --> assuming zero conservation\n";
+      }
+}
+
+    /*****************************************************************//**
+    * @brief coverage check
+    *
+    * This method is used to state the errors for the chromosomes of a
+    * set of regions that have no ranges or regions before their first
+    * range, so they are stated once while loading instead of when the
+    * scores are looked up (possibly in several worker processes).
+    *
+    * @param regions const genomicRegions reference to the regions the
+    *     scores will be looked up in
+    *********************************************************************/
+    void conservationList::report_uncovered(const genomicRegions & regions) const {
+       /***********************************************************\ 
+      | Compare the first region of every chromosome with its first |
+      | range (if it has any):                                      |
+       \***********************************************************/
+      for(std::map<chromosomeType,std::map<chromosomePosition,chromosomePosition> >::const_iterator chromosome_it(regions.chromosomes.begin());
+          chromosome_it!=regions.chromosomes.end();++chromosome_it)
+      {
+        const chromosomeID ID(get_chromosome_ID(chromosome_it->first));
+        if(!chromosome_it->second.empty() && (ID == unknown_chromosome || chromosome_it->second.begin()->first < get_block_start(ID,0)))
+        {
+          report_unknown(chromosome_it->first);
+        }
+      }
+}
+
+    /*****************************************************************//**
+    * @brief conservation track creation
+    *
+    * This method is used to create (or replace) the conservation track
+    * of a conservation file.
+    * Errors in the file are stated like when reading it directly.
+    * If the file contains no ranges (e.g. because it cannot be read), is
+    * a conservation track already, the track cannot be written or the
+    * scores contain more than 65536 distinct values an error is raised.
+    *
+    * @param conservation_path filePath to the conservation file
+    * @param track_path filePath to the track file to be written
+    *
+    * @return true if the track was written, false otherwise
+    *********************************************************************/
+    bool conservationList::convert(const filePath & conservation_path, const filePath & track_path) {
+       /*************************************************************\ 
+      | Read the conservation table and try to open a temporary track |
+      | file stating an error in the case of failure and reserve the  |
+      | space for the header:                                         |
+       \*************************************************************/
+      const conservationList conservations(conservation_path);
+      if(conservations.mapping != NULL || conservations.chromosomes.empty())
+      {
+        std::cerr << "microSNPscore::conservationList::convert\n";
+        std::cerr << (conservations.mapping != NULL ? " ==> file is a conservation track already: " : " ==> no conservation ranges in file: ");
+        std::cerr << conservation_path << std::endl;
+        std::cerr << "  --> no track will be created\n";
+        return false;
+      }
+      const filePath temporary_path(track_path+".tmp");
+      std::ofstream track(temporary_path.c_str(),std::ios::out | std::ios::binary | std::ios::trunc);
+      if(track.fail())
+      {
+        std::cerr << "microSNPscore::conservationList::convert\n";
+        std::cerr << " ==> Cannot open file to write to: ";
+        std::cerr << temporary_path << std::endl;
+        std::cerr << "  --> no track will be created\n";
+        return false;
+      }
+      trackHeader header;
+      memset(&header,0,sizeof(header));
+      uint64_t offset(0);
+      append_block(track,offset,&header,sizeof(header));
+       /****************************************************************\ 
+      | Append the blocks of every chromosome to the file: its name, its |
+      | block index, the deltas of the other starts of each block to     |
+      | their predecessors and the index of every range's score in the   |
+      | dictionary of distinct scores:                                   |
+       \****************************************************************/
+      std::vector<trackChromosome> records;
+      std::map<uint64_t,uint16_t> score_indices;
+      std::vector<double> scores;
+      for(chromosomeID chromosome(0);chromosome!=conservations.chromosomes.size();++chromosome)
+      {
+        const chromosomeConservation & partition(conservations.chromosomes[chromosome]);
+        const std::vector<uint32_t> block_starts(partition.block_starts.begin(),partition.block_starts.end());
+        std::vector<uint64_t> block_offsets;
+        std::vector<unsigned char> deltas;
+        std::vector<uint16_t> score_index(partition.starts.size(),0);
+        for(size_t range(0);range!=partition.starts.size();++range)
+        {
+          if(range % block_size == 0)
+          {
+            block_offsets.push_back(deltas.size());
+          }
+          else
+          {
+            uint32_t delta(partition.starts[range] - partition.starts[range - 1]);
+            for(;delta>=0x80;delta>>=7)
+            {
+              deltas.push_back(static_cast<unsigned char>((delta & 0x7f) | 0x80));
+            }
+            deltas.push_back(static_cast<unsigned char>(delta));
+          }
+          const double score(partition.scores[range]);
+          uint64_t score_key(0);
+          memcpy(&score_key,&score,sizeof(score));
+          std::map<uint64_t,uint16_t>::iterator score_it(score_indices.find(score_key));
+          if(score_it == score_indices.end())
+          {
+            if(scores.size() > uint16_t(-1))
+            {
+              std::cerr << "microSNPscore::conservationList::convert\n";
+              std::cerr << " ==> more than " << scores.size() << " distinct conservation scores in file: ";
+              std::cerr << conservation_path << std::endl;
+              std::cerr << "  --> no track will be created\n";
+              track.close();
+              std::remove(temporary_path.c_str());
+              return false;
+            }
+            score_it = score_indices.insert(std::make_pair(score_key,uint16_t(scores.size()))).first;
+            scores.push_back(score);
+          }
+          score_index[range] = score_it->second;
+        } // range
+        const chromosomeType & name(conservations.chromosome_names[chromosome]);
+        trackChromosome record;
+        record.name_offset = append_block(track,offset,name.data(),name.size());
+        record.name_length = name.size();
+        record.range_count = partition.starts.size();
+        record.block_starts_offset = append_block(track,offset,&block_starts[0],block_starts.size() * sizeof(uint32_t));
+        record.block_offsets_offset = append_block(track,offset,&block_offsets[0],block_offsets.size() * sizeof(uint64_t));
+        record.deltas_offset = append_block(track,offset,deltas.empty() ? NULL : &deltas[0],deltas.size());
+        record.deltas_size = deltas.size();
+        record.scores_offset = append_block(track,offset,&score_index[0],score_index.size() * sizeof(uint16_t));
+        records.push_back(record);
+      } // chromosome
+       /*************************************************************\ 
+      | Append the score dictionary and the chromosome table, fill in |
+      | the header and replace the track by the temporary one if all  |
+      | went well stating an error otherwise:                         |
+       \*************************************************************/
+      memcpy(header.magic,track_magic,sizeof(track_magic));
+      header.version = track_version;
+      header.byte_order = track_byte_order;
+      header.block_size = block_size;
+      header.score_count = scores.size();
+      header.scores_offset = append_block(track,offset,&scores[0],scores.size() * sizeof(double));
+      header.chromosome_count = records.size();
+      header.chromosomes_offset = append_block(track,offset,&records[0],records.size() * sizeof(trackChromosome));
+      track.seekp(0);
+      track.write(reinterpret_cast<const char *>(&header),sizeof(header));
+      track.close();
+      if(track.fail() || std::rename(temporary_path.c_str(),track_path.c_str()) != 0)
+      {
+        std::cerr << "microSNPscore::conservationList::convert\n";
+        std::cerr << " ==> Cannot write track: ";
+        std::cerr << track_path << std::endl;
+        std::cerr << "  --> no track will be created\n";
+        std::remove(temporary_path.c_str());
+        return false;
+      }
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief conservation track detection
+    *
+    * This method is used to check whether a given file is a
+    * conservation track (and not a conservation table).
+    *
+    * @param the_path filePath to the file
+    *
+    * @return true if the file starts like a conservation track, false
+    *     otherwise
+    *********************************************************************/
+    bool conservationList::is_track(const filePath & the_path) {
+      std::ifstream the_file(the_path.c_str(),std::ios::in | std::ios::binary);
+      char magic[sizeof(track_magic)];
+      return the_file.read(magic,sizeof(magic)).good() && memcmp(magic,track_magic,sizeof(magic)) == 0;
+}
+
+    /*****************************************************************//**
+    * @brief conservation track opening
+    *
+    * This method is used to map the conservation track of the list and
+    * to read its chromosome names.
+    * If the file cannot be mapped or is no valid track of the current
+    * version an error is raised and the list stays empty.
+    *********************************************************************/
+    void conservationList::open_track() {
+       /***************************************************\ 
+      | Try to map the whole file read-only (expecting      |
+      | scattered accesses) stating an error in the case of |
+      | failure:                                            |
+       \***************************************************/
+      const int fd(open(path.c_str(),O_RDONLY));
+      struct stat file_status;
+      void * the_mapping(MAP_FAILED);
+      const char * reason("file too short");
+      if(fd < 0 || fstat(fd,&file_status) != 0)
+      {
+        reason = strerror(errno);
+      }
+      else if(file_status.st_size >= off_t(sizeof(trackHeader)))
+      {
+        the_mapping = mmap(NULL,file_status.st_size,PROT_READ,MAP_SHARED,fd,0);
+        reason = strerror(errno);
+      }
+      if(the_mapping == MAP_FAILED)
+      {
+        std::cerr << "microSNPscore::conservationList::conservationList\n";
+        std::cerr << " ==> Cannot map conservation track: ";
+        std::cerr << path << ": " << reason << std::endl;
+        std::cerr << "  --> no conservations will be read from the file\n";
+        if(fd >= 0)
+        {
+          close(fd);
+        }
+        return;
+      }
+      close(fd);
+      madvise(the_mapping,file_status.st_size,MADV_RANDOM);
+      mapping = static_cast<const char *>(the_mapping);
+      mapping_size = file_status.st_size;
        /************************************************************\ 
-      | Search for the first range not beginning before the searched |
-      | position and return its score if it is a perfect match or    |
-      | the one of its predecessor (if one exists):                  |
+      | Make sure the header identifies a track of the current       |
+      | version, byte order and block size and that all tables and   |
+      | blocks lie inside the file (aligned for access) and read the |
+      | chromosome names (which have to be unique), unmapping the    |
+      | file if not:                                                 |
        \************************************************************/
-      const std::vector<conservationRange>::const_iterator possible_border(std::lower_bound(ranges.begin(),ranges.end(),conservationRange(chromosome,position)));
-      if(possible_border!=ranges.end())
+      const trackHeader & header(*reinterpret_cast<const trackHeader *>(mapping));
+      bool valid(header.version == track_version && header.byte_order == track_byte_order &&
+                 header.block_size == block_size &&
+                 header.chromosomes_offset % 8 == 0 && header.chromosomes_offset <= mapping_size &&
+                 header.chromosome_count <= (mapping_size - header.chromosomes_offset) / sizeof(trackChromosome) &&
+                 header.scores_offset % 8 == 0 && header.scores_offset <= mapping_size &&
+                 header.score_count <= (mapping_size - header.scores_offset) / sizeof(double));
+      for(uint64_t chromosome(0);valid && chromosome!=header.chromosome_count;++chromosome)
       {
-        if(possible_border->get_chromosome() == chromosome && possible_border->get_start() == position)
+        const trackChromosome & record(track_chromosome(mapping,chromosome));
+        const uint64_t block_count((record.range_count + block_size - 1) / block_size);
+        const uint64_t block_offsets[5] = {record.name_offset,record.block_starts_offset,record.block_offsets_offset,
+                                           record.deltas_offset,record.scores_offset};
+        const uint64_t block_sizes[5] = {record.name_length,block_count * sizeof(uint32_t),block_count * sizeof(uint64_t),
+                                         record.deltas_size,record.range_count * sizeof(uint16_t)};
+        valid = record.range_count < mapping_size && record.block_starts_offset % 8 == 0 &&
+                record.block_offsets_offset % 8 == 0 && record.scores_offset % 8 == 0;
+        for(unsigned short block(0);valid && block!=5;++block)
         {
-          return possible_border->get_score();
+          valid = block_offsets[block] <= mapping_size && block_sizes[block] <= mapping_size - block_offsets[block];
         }
-        else if(possible_border != ranges.begin() && (possible_border-1)->get_chromosome() == chromosome)
+        if(valid)
         {
-          return (possible_border-1)->get_score();
+          const chromosomeType name(mapping + record.name_offset,record.name_length);
+          valid = chromosome_IDs.insert(std::make_pair(name,chromosomeID(chromosome))).second;
+          chromosome_names.push_back(name);
         }
-      } // else case for both if statements:
-       /***************************************************\ 
-      | If no score is defined state an error and return 0: |
-       \***************************************************/
-      std::cerr << "microSNPscore::conservationList::get_score\n";
-      std::cerr << " ==> Unkown chromosome: " << chromosome << std::endl;
-      std::cerr << "  --> assuming zero conservation\n";
-      return 0;
-      
+      }
+      if(!valid)
+      {
+        std::cerr << "microSNPscore::conservationList::conservationList\n";
+        std::cerr << " ==> no valid conservation track of version " << track_version << ": ";
+        std::cerr << path << std::endl;
+        std::cerr << "  --> no conservations will be read from the file (convert it again)\n";
+        munmap(const_cast<char *>(mapping),mapping_size);
+        mapping = NULL;
+        mapping_size = 0;
+        chromosome_names.clear();
+        chromosome_IDs.clear();
+      }
+}
+
+    /*****************************************************************//**
+    * @brief get method for block counts
+    *
+    * This method is used to access the number of blocks of ranges on a
+    * chromosome.
+    *
+    * @param chromosome chromosomeID of the chromosome
+    *
+    * @return the number of blocks on the chromosome
+    *********************************************************************/
+    size_t conservationList::get_block_count(chromosomeID chromosome) const {
+      return mapping != NULL ?
+             (track_chromosome(mapping,chromosome).range_count + block_size - 1) / block_size :
+             chromosomes[chromosome].block_starts.size();
+}
+
+    /*****************************************************************//**
+    * @brief get method for block starts
+    *
+    * This method is used to access the start of the first range of a
+    * block from the block index (without restoring the block).
+    *
+    * @param chromosome chromosomeID of the chromosome
+    * @param block size_t representing the number of the block on the
+    *     chromosome (less than its block count)
+    *
+    * @return the first start of the block
+    *********************************************************************/
+    chromosomePosition conservationList::get_block_start(chromosomeID chromosome, size_t block) const {
+      return mapping != NULL ?
+             reinterpret_cast<const uint32_t *>(mapping + track_chromosome(mapping,chromosome).block_starts_offset)[block] :
+             chromosomes[chromosome].block_starts[block];
+}
+
+    /*****************************************************************//**
+    * @brief block search
+    *
+    * This method is used to search the block index of a chromosome for
+    * the block a position lies in.
+    *
+    * @param chromosome chromosomeID of the chromosome
+    * @param position chromosomePosition of interest
+    *
+    * @return the number of blocks starting at or before the position (so
+    *     0 if no range covers it)
+    *********************************************************************/
+    size_t conservationList::find_block(chromosomeID chromosome, chromosomePosition position) const {
+      if(mapping != NULL)
+      {
+        const uint32_t * block_starts(reinterpret_cast<const uint32_t *>(mapping + track_chromosome(mapping,chromosome).block_starts_offset));
+        return std::upper_bound(block_starts,block_starts + get_block_count(chromosome),position) - block_starts;
+      }
+      const std::vector<chromosomePosition> & block_starts(chromosomes[chromosome].block_starts);
+      return std::upper_bound(block_starts.begin(),block_starts.end(),position) - block_starts.begin();
+}
+
+    /*****************************************************************//**
+    * @brief block decoding
+    *
+    * This method is used to restore the range starts of a block of a
+    * chromosome.
+    * If the block's deltas do not lie inside the conservation track an
+    * error is raised and only the starts read before are restored.
+    *
+    * @param chromosome chromosomeID of the chromosome
+    * @param block size_t representing the number of the block on the
+    *     chromosome (less than its block count)
+    * @param starts chromosomePosition array the starts are assigned to
+    *     (with space for a whole block)
+    *
+    * @return the number of starts restored
+    *********************************************************************/
+    size_t conservationList::decode_block(chromosomeID chromosome, size_t block, chromosomePosition starts[]) const {
+      if(mapping == NULL)
+      {
+        const std::vector<chromosomePosition> & chromosome_starts(chromosomes[chromosome].starts);
+        const size_t block_length(std::min(block_size,chromosome_starts.size() - block * block_size));
+        std::copy(chromosome_starts.begin() + block * block_size,chromosome_starts.begin() + block * block_size + block_length,starts);
+        return block_length;
+      }
+       /**************************************************************\ 
+      | For a track take the first start from the block index and add  |
+      | the deltas of the other starts of the block one by one stating |
+      | an error if they run out of the chromosome's deltas:           |
+       \**************************************************************/
+      const trackChromosome & record(track_chromosome(mapping,chromosome));
+      const size_t block_length(std::min(uint64_t(block_size),record.range_count - block * block_size));
+      const uint64_t block_offset(reinterpret_cast<const uint64_t *>(mapping + record.block_offsets_offset)[block]);
+      const unsigned char * deltas_end(reinterpret_cast<const unsigned char *>(mapping + record.deltas_offset + record.deltas_size));
+      const unsigned char * delta_byte(deltas_end - record.deltas_size + std::min(block_offset,record.deltas_size));
+      starts[0] = reinterpret_cast<const uint32_t *>(mapping + record.block_starts_offset)[block];
+      size_t decoded(1);
+      uint64_t delta;
+      while(decoded != block_length && read_delta(delta_byte,deltas_end,delta) && delta != 0 &&
+            delta <= chromosomePosition(-1) - starts[decoded - 1])
+      {
+        starts[decoded] = starts[decoded - 1] + delta;
+        ++decoded;
+      }
+      if(decoded != block_length)
+      {
+        std::cerr << "microSNPscore::conservationList::get_score\n";
+        std::cerr << " ==> invalid range starts in conservation track: ";
+        std::cerr << path << std::endl;
+        std::cerr << "  --> ignoring the rest of the block\n";
+      }
+      return decoded;
+}
+
+    /*****************************************************************//**
+    * @brief get method for range scores
+    *
+    * This method is used to access the score of a range of a chromosome.
+    * If its index into the score table of the conservation track is
+    * invalid an error is raised and 0 is returned.
+    *
+    * @param chromosome chromosomeID of the chromosome
+    * @param range size_t representing the number of the range on the
+    *     chromosome
+    *
+    * @return the score of the range
+    *********************************************************************/
+    conservationScore conservationList::get_range_score(chromosomeID chromosome, size_t range) const {
+      if(mapping == NULL)
+      {
+        return chromosomes[chromosome].scores[range];
+      }
+      const trackHeader & header(*reinterpret_cast<const trackHeader *>(mapping));
+      const uint16_t score_index(reinterpret_cast<const uint16_t *>(mapping + track_chromosome(mapping,chromosome).scores_offset)[range]);
+      if(score_index >= header.score_count)
+      {
+        std::cerr << "microSNPscore::conservationList::get_score\n";
+        std::cerr << " ==> invalid conservation score index in conservation track: ";
+        std::cerr << path << std::endl;
+        std::cerr << "  --> assuming zero conservation\n";
+        return 0;
+      }
+      return reinterpret_cast<const double *>(mapping + header.scores_offset)[score_index];
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to start walking the ranges of a chromosome (looking
+    * it up in the list only once).
+    *
+    * @param the_list const conservationList reference to the list (which
+    *     has to outlive the walker)
+    * @param the_chromosome const chromosomeType reference to the
+    *     chromosome
+    *
+    * @return conservationWalker positioned before the first range
+    *********************************************************************/
+    conservationWalker::conservationWalker(const conservationList & the_list, const chromosomeType & the_chromosome)
+    :list(the_list),chromosome(the_chromosome),chromosome_ID(list.get_chromosome_ID(chromosome)),
+     block_count(chromosome_ID != conservationList::unknown_chromosome ? list.get_block_count(chromosome_ID) : 0),
+     block(block_count),block_length(0),range(0),range_start(0),range_end(0),range_score(0),in_range(false) {
+}
+
+    /*****************************************************************//**
+    * @brief range change
+    *
+    * This method is used to move the walker to the range of a position
+    * outside of the current range (stepping to a neighbouring range or
+    * searching the block index).
+    *
+    * @param position the position of interest on the chromosome
+    *
+    * @return the conservation score of the given position
+    *********************************************************************/
+    conservationScore conservationWalker::move_to(chromosomePosition position) {
+      if(chromosome_ID == conservationList::unknown_chromosome)
+      {
+        list.report_unknown(chromosome);
+        return 0;
+      }
+       /**************************************************************\ 
+      | Step to the following or preceding range if the position lies  |
+      | right behind or before the current one (restoring the adjacent |
+      | block if the current range is at its border):                  |
+       \**************************************************************/
+      if(in_range && position > range_end && position - range_end == 1)
+      {
+        if(range + 1 != block_length)
+        {
+          select_range(range + 1);
+        }
+        else
+        {
+          load_block(block + 1);
+          select_range(0);
+        }
+        return range_score;
+      }
+      if(in_range && position < range_start && range_start - position == 1 && (range != 0 || block != 0))
+      {
+        if(range != 0)
+        {
+          select_range(range - 1);
+        }
+        else
+        {
+          load_block(block - 1);
+          select_range(block_length - 1);
+        }
+        return range_score;
+      }
+       /*************************************************************\ 
+      | Otherwise search the block index for the position (stating an |
+      | error and returning 0 if no range covers it) and select the   |
+      | last range of its block starting at or before it:             |
+       \*************************************************************/
+      const size_t next_block(list.find_block(chromosome_ID,position));
+      if(next_block == 0)
+      {
+        in_range = false;
+        list.report_unknown(chromosome);
+        return 0;
+      }
+      load_block(next_block - 1);
+      select_range(std::upper_bound(starts,starts + block_length,position) - starts - 1);
+      return range_score;
+}
+
+    /*****************************************************************//**
+    * @brief range selection
+    *
+    * This method is used to make a range of the current block the
+    * current range.
+    *
+    * @param index size_t representing the number of the range in the
+    *     current block
+    *********************************************************************/
+    void conservationWalker::select_range(size_t index) {
+      range = index;
+      range_start = starts[range];
+      range_end = range + 1 != block_length ?
+                  starts[range + 1] - 1 :
+                  (block + 1 != block_count ?
+                   list.get_block_start(chromosome_ID,block + 1) - 1 :
+                   chromosomePosition(-1));
+      range_score = list.get_range_score(chromosome_ID,block * conservationList::block_size + range);
+      in_range = true;
+}
+
+    /*****************************************************************//**
+    * @brief block loading
+    *
+    * This method is used to restore the starts of a block (unless it is
+    * the current block already).
+    *
+    * @param the_block size_t representing the number of the block on the
+    *     chromosome
+    *********************************************************************/
+    void conservationWalker::load_block(size_t the_block) {
+      if(the_block != block)
+      {
+        block = the_block;
+        block_length = list.decode_block(chromosome_ID,block,starts);
+      }
 }
 
 /*****************************************************************//**
@@ -250,9 +1132,18 @@ std::ostream & operator<<(std::ostream & the_stream, const conservationRange & t
 *********************************************************************/
 std::ostream & operator<<(std::ostream & the_stream, const conservationList & the_list)
 {
-  for(conservationList::const_iterator range_it(the_list.begin());range_it!=the_list.end();++range_it)
+  for(chromosomeID chromosome(0);chromosome!=the_list.chromosome_names.size();++chromosome)
   {
-    the_stream << *range_it << std::endl;
+    for(size_t block(0);block!=the_list.get_block_count(chromosome);++block)
+    {
+      chromosomePosition starts[conservationList::block_size];
+      const size_t block_length(the_list.decode_block(chromosome,block,starts));
+      for(size_t range(0);range!=block_length;++range)
+      {
+        the_stream << conservationRange(the_list.chromosome_names[chromosome],starts[range],
+                                        the_list.get_range_score(chromosome,block * conservationList::block_size + range)) << std::endl;
+      }
+    }
   }
   return the_stream;
 }
@@ -0,0 +1,464 @@
+#include <iostream>
+//for std::cerr and std::endl (error stating)
+#include <algorithm>
+//for std::min (copy sizes)
+#include <string.h>
+//for memcpy and memset (data copying and stream initialization)
+#include <unistd.h>
+//for read, pread and sysconf (file access and processor count)
+#include <errno.h>
+//for errno (interrupted reads)
+#include <pthread.h>
+//for pthread_create and pthread_join (parallel decompression)
+#include "gzipDecoder.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief BGZF blocks per thread
+    *
+    * This is the number of blocks read ahead for each decompressing
+    * thread.
+    *********************************************************************/
+    static const size_t blocks_per_thread(16);
+
+    /*****************************************************************//**
+    * @brief stream input size
+    *
+    * This is the number of compressed bytes read at once when
+    * decompressing a gzip file as a single stream.
+    *********************************************************************/
+    static const size_t stream_input_size(1048576);
+
+    /*****************************************************************//**
+    * @brief BGZF block data size limit
+    *
+    * This is the largest uncompressed size a BGZF block may have (larger
+    * sizes in a block trailer mark the block as corrupt).
+    *********************************************************************/
+    static const unsigned long max_block_data_size(65536);
+
+    /*****************************************************************//**
+    * @brief decompression job
+    *
+    * This represents the share of a batch of BGZF blocks decompressed by
+    * one thread (every @p step -th block starting with @p first).
+    *********************************************************************/
+    struct bgzfJob {
+      std::vector<bgzfBlock> * blocks;
+      size_t first;
+      size_t step;
+    };
+
+    /*****************************************************************//**
+    * @brief little endian conversion
+    *
+    * This is used to read an unsigned integer stored in little endian
+    * byte order (as in gzip headers and trailers).
+    *
+    * @param bytes const unsigned char pointer to the first byte
+    * @param count unsigned short representing the number of bytes
+    *
+    * @return the value of the integer
+    *********************************************************************/
+    static unsigned long little_endian(const unsigned char * bytes, unsigned short count) {
+      unsigned long value(0);
+      while(count != 0)
+      {
+        --count;
+        value = (value << 8) | bytes[count];
+      }
+      return value;
+}
+
+    /*****************************************************************//**
+    * @brief BGZF block decompression
+    *
+    * This is used as thread function decompressing the blocks of a job
+    * and checking their size and CRC32 against their trailers (blocks
+    * claiming more than @p max_block_data_size bytes are not inflated).
+    *
+    * @param argument void pointer to the bgzfJob
+    *
+    * @return NULL
+    *********************************************************************/
+    static void * inflate_blocks(void * argument) {
+      const bgzfJob & job(*static_cast<bgzfJob *>(argument));
+      z_stream block_stream;
+      memset(&block_stream,0,sizeof(block_stream));
+      const bool initialized(inflateInit2(&block_stream,-15) == Z_OK);
+      for(size_t block_index(job.first);block_index<job.blocks->size();block_index+=job.step)
+      {
+        bgzfBlock & block((*job.blocks)[block_index]);
+        const unsigned char * trailer(&block.compressed[block.compressed.size()-8]);
+        const unsigned long size(little_endian(trailer+4,4));
+        block.valid = false;
+        if(size > max_block_data_size)
+        {
+          block.data.clear();
+          continue;
+        }
+        block.data.resize(size);
+        if(initialized && inflateReset(&block_stream) == Z_OK)
+        {
+          char empty_output(0);
+          block_stream.next_in = &block.compressed[0];
+          block_stream.avail_in = block.compressed.size() - 8;
+          block_stream.next_out = reinterpret_cast<Bytef *>(size != 0 ? &block.data[0] : &empty_output);
+          block_stream.avail_out = size;
+          block.valid = inflate(&block_stream,Z_FINISH) == Z_STREAM_END && block_stream.total_out == size &&
+                        crc32(crc32(0L,Z_NULL,0),block_stream.next_out - size,size) == little_endian(trailer,4);
+        }
+      }
+      if(initialized)
+      {
+        inflateEnd(&block_stream);
+      }
+      return NULL;
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a gzipDecoder reading a gzip file from a
+    * given file descriptor (positioned at the start of the file).
+    * The descriptor remains owned by the caller.
+    *
+    * @param the_fd int representing the file descriptor to read from
+    * @param the_path filePath to the file (used in error messages)
+    *
+    * @return gzipDecoder for the given file
+    *
+    * @see is_gzip()
+    *********************************************************************/
+    gzipDecoder::gzipDecoder(int the_fd, const filePath & the_path)
+    :fd(the_fd),path(the_path),bgzf(false),threads(1),member_complete(false),block_index(0),block_position(0),input_end(false),failed(false) {
+       /**************************************************************\ 
+      | The file is in BGZF format if its first header has the extra   |
+      | field of a BGZF block (subfield BC holding the block size),    |
+      | in which case the blocks are decompressed by one thread per    |
+      | processor (at most 8), otherwise prepare stream decompression: |
+       \**************************************************************/
+      unsigned char header[18];
+      bgzf = pread(fd,header,sizeof(header),0) == ssize_t(sizeof(header)) && header[3] == 4 &&
+             little_endian(header+10,2) == 6 && header[12] == 'B' && header[13] == 'C' && little_endian(header+14,2) == 2;
+      const long processors(sysconf(_SC_NPROCESSORS_ONLN));
+      threads = processors < 1 ? 1 : (processors > 8 ? 8 : processors);
+      memset(&stream,0,sizeof(stream));
+      if(!bgzf && inflateInit2(&stream,15+16) != Z_OK)
+      {
+        std::cerr << "microSNPscore::gzipDecoder::gzipDecoder\n";
+        std::cerr << " ==> Cannot initialize decompression of file: ";
+        std::cerr << path << std::endl;
+        std::cerr << "  --> no data will be read from the file\n";
+        failed = true;
+      }
+}
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to release the decompression state.
+    *********************************************************************/
+    gzipDecoder::~gzipDecoder() {
+      if(!bgzf)
+      {
+        inflateEnd(&stream);
+      }
+}
+
+    /*****************************************************************//**
+    * @brief data reading
+    *
+    * This method is used to get the next decompressed data.
+    * If the file is corrupt or truncated an error is raised.
+    *
+    * @param destination char pointer to the memory the data is written
+    *     to
+    * @param size size_t representing the maximal number of bytes to
+    *     write
+    *
+    * @return the number of bytes written, 0 at the end of the file or -1
+    *     on errors
+    *********************************************************************/
+    ssize_t gzipDecoder::read(char * destination, size_t size) {
+      if(!bgzf)
+      {
+        return failed ? -1 : read_stream(destination,size);
+      }
+       /************************************************************\ 
+      | Skip the blocks returned completely (decompressing the next  |
+      | batch when all are) and copy as much of the current block as |
+      | requested:                                                   |
+       \************************************************************/
+      while(block_index == batch.size() || block_position == batch[block_index].data.size())
+      {
+        if(block_index < batch.size())
+        {
+          ++block_index;
+          block_position = 0;
+        }
+        else if(!next_batch())
+        {
+          return failed ? -1 : 0;
+        }
+      }
+      const bgzfBlock & block(batch[block_index]);
+      const size_t copied(std::min(size,block.data.size()-block_position));
+      memcpy(destination,&block.data[block_position],copied);
+      block_position += copied;
+      return copied;
+}
+
+    /*****************************************************************//**
+    * @brief gzip detection
+    *
+    * This method is used to check whether a file starts with the gzip
+    * magic bytes (without changing its position).
+    *
+    * @param fd int representing the file descriptor of the file
+    *
+    * @return true if the file is a gzip file, false otherwise (or if
+    *     it cannot be checked, e.g. for pipes)
+    *********************************************************************/
+    bool gzipDecoder::is_gzip(int fd) {
+      unsigned char magic[2];
+      return fd >= 0 && pread(fd,magic,sizeof(magic),0) == ssize_t(sizeof(magic)) && magic[0] == 0x1f && magic[1] == 0x8b;
+}
+
+    /*****************************************************************//**
+    * @brief stream decompression
+    *
+    * This method is used to decompress the next data of a gzip file not
+    * in BGZF format.
+    *
+    * @param destination char pointer to the memory the data is written
+    *     to
+    * @param size size_t representing the maximal number of bytes to
+    *     write
+    *
+    * @return the number of bytes written, 0 at the end of the file or -1
+    *     on errors
+    *********************************************************************/
+    ssize_t gzipDecoder::read_stream(char * destination, size_t size) {
+       /***************************************************************\ 
+      | Inflate until some data was written, reading more of the file   |
+      | whenever the input is used up and starting over with the next   |
+      | member after the end of one (the file may only end after that): |
+       \***************************************************************/
+      stream.next_out = reinterpret_cast<Bytef *>(destination);
+      stream.avail_out = size;
+      while(stream.avail_out == size)
+      {
+        if(stream.avail_in == 0)
+        {
+          input.resize(stream_input_size);
+          const size_t bytes_read(input_end ? 0 : read_fully(&input[0],input.size()));
+          if(bytes_read == 0)
+          {
+            input_end = true;
+            if(member_complete)
+            {
+              return 0;
+            }
+            std::cerr << "microSNPscore::gzipDecoder::read_stream\n";
+            std::cerr << " ==> unexpected end of compressed file: ";
+            std::cerr << path << std::endl;
+            std::cerr << "  --> ignoring the rest of the file\n";
+            failed = true;
+            return -1;
+          }
+          stream.next_in = &input[0];
+          stream.avail_in = bytes_read;
+        }
+        const int status(inflate(&stream,Z_NO_FLUSH));
+        if(status == Z_STREAM_END)
+        {
+          member_complete = true;
+          inflateReset(&stream);
+        }
+        else if(status == Z_OK)
+        {
+          member_complete = false;
+        }
+        else
+        {
+          std::cerr << "microSNPscore::gzipDecoder::read_stream\n";
+          std::cerr << " ==> corrupt compressed file: ";
+          std::cerr << path << ": " << (stream.msg != NULL ? stream.msg : "invalid data") << std::endl;
+          std::cerr << "  --> ignoring the rest of the file\n";
+          failed = true;
+          return -1;
+        }
+      } // stream.avail_out == size
+      return size - stream.avail_out;
+}
+
+    /*****************************************************************//**
+    * @brief BGZF block reading
+    *
+    * This method is used to read the next blocks of a BGZF file (without
+    * decompressing them).
+    * If a block is truncated or not in BGZF format an error is raised
+    * and no more blocks are read.
+    *
+    * @param blocks std::vector reference the blocks are assigned to
+    *
+    * @return true if at least one block was read, false otherwise
+    *********************************************************************/
+    bool gzipDecoder::read_blocks(std::vector<bgzfBlock> & blocks) {
+       /****************************************************************\ 
+      | Read the headers of the blocks (gzip headers with only the extra |
+      | field holding the block size) and the data following them:       |
+       \****************************************************************/
+      blocks.resize(threads * blocks_per_thread);
+      size_t block_count(0);
+      while(!input_end && block_count != blocks.size())
+      {
+        unsigned char header[18];
+        const size_t header_size(read_fully(header,sizeof(header)));
+        if(header_size == 0)
+        {
+          input_end = true;
+          break;
+        }
+        const unsigned long block_size(little_endian(header+16,2) + 1);
+        if(header_size != sizeof(header) || header[0] != 0x1f || header[1] != 0x8b || header[2] != 8 || header[3] != 4 ||
+           little_endian(header+10,2) != 6 || header[12] != 'B' || header[13] != 'C' || little_endian(header+14,2) != 2 ||
+           block_size < sizeof(header) + 8 + 2)
+        {
+          std::cerr << "microSNPscore::gzipDecoder::read_blocks\n";
+          std::cerr << " ==> no valid BGZF block header in compressed file: ";
+          std::cerr << path << std::endl;
+          std::cerr << "  --> ignoring the rest of the file\n";
+          input_end = true;
+          failed = true;
+          break;
+        }
+        std::vector<unsigned char> & compressed(blocks[block_count].compressed);
+        compressed.resize(block_size - sizeof(header));
+        if(read_fully(&compressed[0],compressed.size()) != compressed.size())
+        {
+          std::cerr << "microSNPscore::gzipDecoder::read_blocks\n";
+          std::cerr << " ==> unexpected end of compressed file: ";
+          std::cerr << path << std::endl;
+          std::cerr << "  --> ignoring the rest of the file\n";
+          input_end = true;
+          failed = true;
+          break;
+        }
+        ++block_count;
+      } // !input_end && block_count != blocks.size()
+      blocks.resize(block_count);
+      return block_count != 0;
+}
+
+    /*****************************************************************//**
+    * @brief BGZF batch decompression
+    *
+    * This method is used to decompress the blocks read ahead on several
+    * threads while reading the blocks following them.
+    *
+    * @return true if a batch of blocks was decompressed, false at the
+    *     end of the file or on errors
+    *********************************************************************/
+    bool gzipDecoder::next_batch() {
+       /***********************************************************\ 
+      | Take the blocks read ahead (reading them first on the first |
+      | call) and start the threads decompressing them:             |
+       \***********************************************************/
+      batch.clear();
+      block_index = 0;
+      block_position = 0;
+      if(pending.empty() && !read_blocks(pending))
+      {
+        return false;
+      }
+      batch.swap(pending);
+      std::vector<bgzfJob> jobs(threads);
+      std::vector<pthread_t> thread_IDs(threads);
+      std::vector<bool> started(threads,false);
+      for(unsigned int thread_index(1);thread_index<threads;++thread_index)
+      {
+        jobs[thread_index].blocks = &batch;
+        jobs[thread_index].first = thread_index;
+        jobs[thread_index].step = threads;
+        started[thread_index] = pthread_create(&thread_IDs[thread_index],NULL,inflate_blocks,&jobs[thread_index]) == 0;
+      }
+       /***************************************************************\ 
+      | Read the next blocks meanwhile, decompress the share of threads |
+      | that could not be started here and wait for the others:         |
+       \***************************************************************/
+      if(!input_end)
+      {
+        read_blocks(pending);
+      }
+      jobs[0].blocks = &batch;
+      jobs[0].first = 0;
+      jobs[0].step = threads;
+      inflate_blocks(&jobs[0]);
+      for(unsigned int thread_index(1);thread_index<threads;++thread_index)
+      {
+        if(started[thread_index])
+        {
+          pthread_join(thread_IDs[thread_index],NULL);
+        }
+        else
+        {
+          inflate_blocks(&jobs[thread_index]);
+        }
+      }
+       /****************************************************************\ 
+      | Make sure all blocks were valid (returning only those before the |
+      | first invalid one) stating an error otherwise:                   |
+       \****************************************************************/
+      for(size_t checked_index(0);checked_index!=batch.size();++checked_index)
+      {
+        if(!batch[checked_index].valid)
+        {
+          std::cerr << "microSNPscore::gzipDecoder::next_batch\n";
+          std::cerr << " ==> corrupt BGZF block in compressed file: ";
+          std::cerr << path << std::endl;
+          std::cerr << "  --> ignoring the rest of the file\n";
+          batch.resize(checked_index);
+          pending.clear();
+          input_end = true;
+          failed = true;
+          break;
+        }
+      }
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief complete reading
+    *
+    * This method is used to read a given number of bytes from the file
+    * (retrying interrupted and partial reads).
+    *
+    * @param destination void pointer to the memory the data is written to
+    * @param size size_t representing the number of bytes to read
+    *
+    * @return the number of bytes read (less than @p size only at the end
+    *     of the file or on errors)
+    *********************************************************************/
+    size_t gzipDecoder::read_fully(void * destination, size_t size) {
+      size_t bytes_read(0);
+      while(bytes_read != size)
+      {
+        const ssize_t result(::read(fd,static_cast<char *>(destination)+bytes_read,size-bytes_read));
+        if(result < 0 && errno == EINTR)
+        {
+          continue;
+        }
+        if(result <= 0)
+        {
+          break;
+        }
+        bytes_read += result;
+      }
+      return bytes_read;
+}
+
+
+} // namespace microSNPscore
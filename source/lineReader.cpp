@@ -0,0 +1,337 @@
+#include <string.h>
+//for memchr and memmove (line splitting and buffer refill)
+#include <stdlib.h>
+//for strtod (score conversion)
+#include <limits>
+//for std::numeric_limits (position overflow)
+#include <unistd.h>
+//for read, lseek and close (file access)
+#include <fcntl.h>
+//for open (file access)
+#include <sys/stat.h>
+//for fstat (file size)
+#include <errno.h>
+//for errno (interrupted reads)
+#include "lineReader.h"
+#include "gzipDecoder.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a lineReader for a given file.
+    * If the file cannot be opened for reading the reader is created but
+    * won't return any lines (see @p is_open).
+    * If the file is a gzip file, its decompressed lines are returned.
+    *
+    * @param the_path filePath to the file to be read
+    * @param the_block_size (optional) size_t representing the number of
+    *     bytes to read at once - Defaults to 4 MiB
+    *
+    * @return lineReader for the given file
+    *
+    * @see is_open()
+    *********************************************************************/
+    lineReader::lineReader(const filePath & the_path, size_t the_block_size)
+    :fd(open(the_path.c_str(),O_RDONLY)),decoder(NULL),block_size(the_block_size),buffer(std::vector<char>(the_block_size+1)),position(0),filled(0),buffer_offset(0),range_end(-1),end_of_file(false) {
+      if(gzipDecoder::is_gzip(fd))
+      {
+        decoder = new gzipDecoder(fd,the_path);
+      }
+}
+
+    /*****************************************************************//**
+    * @brief constructor from file descriptor
+    *
+    * This is used to create a lineReader for an already opened file
+    * descriptor (e.g. a socket or pipe).
+    * The reader takes over the descriptor and closes it when it is
+    * destroyed.
+    *
+    * @param the_fd int representing the file descriptor to read from
+    * @param the_block_size (optional) size_t representing the maximal
+    *     number of bytes to read at once - Defaults to 4 MiB
+    *
+    * @return lineReader for the given file descriptor
+    *********************************************************************/
+    lineReader::lineReader(int the_fd, size_t the_block_size)
+    :fd(the_fd),decoder(NULL),block_size(the_block_size),buffer(std::vector<char>(the_block_size+1)),position(0),filled(0),buffer_offset(0),range_end(-1),end_of_file(false) {
+}
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to close the file read by the reader.
+    *********************************************************************/
+    lineReader::~lineReader() {
+      delete decoder;
+      if(fd >= 0)
+      {
+        close(fd);
+      }
+}
+
+    /*****************************************************************//**
+    * @brief next line
+    *
+    * This method is used to get the next line of the file.
+    * The returned line excludes the newline character which is replaced
+    * by a terminating null character in the buffer.
+    *
+    * @param line fieldView reference the line is assigned to
+    *
+    * @return true if a line was assigned, false at the end of the file
+    *     or if the file cannot be read
+    *********************************************************************/
+    bool lineReader::next_line(fieldView & line) {
+       /****************************************************************\ 
+      | Search the next newline in the unread part of the buffer reading |
+      | more of the file as long as there is none:                       |
+       \****************************************************************/
+      char * newline(NULL);
+      size_t searched(position);
+      while((newline = static_cast<char *>(memchr(&buffer[searched],'\n',filled-searched))) == NULL)
+      {
+        searched = filled - position;
+        if(!refill())
+        {
+          return false;
+        }
+      }
+       /**************************************************************\ 
+      | Stop at the end of the range, otherwise terminate the line and |
+      | move the read position behind it before returning it:          |
+       \**************************************************************/
+      if(range_end >= 0 && get_offset() >= range_end)
+      {
+        return false;
+      }
+      *newline = '\0';
+      line.begin = &buffer[position];
+      line.end = newline;
+      position = newline - &buffer[0] + 1;
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief range restriction
+    *
+    * This method is used to restrict the reader to the lines starting in
+    * a given byte range of the file.
+    * The reader continues at the first line starting at or behind
+    * @p begin and stops before the first line starting at or behind
+    * @p end, so consecutive ranges split the file into slices of
+    * complete lines.
+    *
+    * @param begin off_t representing the offset the range starts at
+    * @param end off_t representing the offset behind the range
+    *
+    * @return true if the reader could be positioned, false otherwise
+    *     (e.g. for compressed files)
+    *********************************************************************/
+    bool lineReader::set_range(off_t begin, off_t end) {
+       /*************************************************************\ 
+      | Position the file at the character before the range (a line   |
+      | starts at the range begin only if it is a newline) discarding |
+      | the buffer and skip the line it belongs to:                   |
+       \*************************************************************/
+      const off_t start(begin > 0 ? begin - 1 : 0);
+      if(fd < 0 || decoder != NULL || lseek(fd,start,SEEK_SET) != start)
+      {
+        return false;
+      }
+      buffer_offset = start;
+      position = 0;
+      filled = 0;
+      end_of_file = false;
+      range_end = -1;
+      fieldView skipped_line;
+      if(begin > 0)
+      {
+        next_line(skipped_line);
+      }
+      range_end = end;
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief get method for file size
+    *
+    * This method is used to access the size of the file read.
+    *
+    * @return the size of the file in bytes (or -1 if it is unknown, e.g.
+    *     for compressed files)
+    *********************************************************************/
+    off_t lineReader::get_size() const {
+      struct stat file_status;
+      return fd >= 0 && decoder == NULL && fstat(fd,&file_status) == 0 ? file_status.st_size : -1;
+}
+
+    /*****************************************************************//**
+    * @brief field splitting
+    *
+    * This method is used to split a line at tab characters into exactly
+    * the given number of fields.
+    * If @p first_takes_rest is set, additional tab characters are taken
+    * as part of the first field (like a greedy leading '(.+)\t' regular
+    * expression group would do), otherwise lines with additional tab
+    * characters are rejected.
+    *
+    * @param line const fieldView reference to the line to be split
+    * @param fields fieldView array the fields are assigned to (must hold
+    *     at least @p field_count fields)
+    * @param field_count unsigned short representing the number of fields
+    * @param first_takes_rest (optional) bool indicating whether
+    *     additional tab characters belong to the first field - Defaults
+    *     to false
+    *
+    * @return true if the line contains the requested number of fields,
+    *     false otherwise
+    *********************************************************************/
+    bool lineReader::split_fields(const fieldView & line, fieldView fields[], unsigned short field_count, bool first_takes_rest) {
+       /**************************************************************\ 
+      | Walk backwards from the line end assigning the fields from the |
+      | last to the second one at the tab characters found and assign  |
+      | the rest of the line to the first field:                       |
+       \**************************************************************/
+      const char * field_end(line.end);
+      for(unsigned short field_number(field_count-1);field_number!=0;--field_number)
+      {
+        const char * field_begin(field_end);
+        while(field_begin != line.begin && *(field_begin-1) != '\t')
+        {
+          --field_begin;
+        }
+        if(field_begin == line.begin)
+        {
+          return false;
+        }
+        fields[field_number].begin = field_begin;
+        fields[field_number].end = field_end;
+        field_end = field_begin - 1;
+      }
+      fields[0].begin = line.begin;
+      fields[0].end = field_end;
+      return first_takes_rest || memchr(line.begin,'\t',field_end-line.begin) == NULL;
+}
+
+    /*****************************************************************//**
+    * @brief position field conversion
+    *
+    * This method is used to convert a field consisting of decimal digits
+    * only to a chromosomePosition.
+    * Values exceeding the range of chromosomePosition are set to its
+    * maximum.
+    *
+    * @param field const fieldView reference to the field
+    * @param position chromosomePosition reference the value is assigned
+    *     to
+    *
+    * @return true if the field is a non-empty digit string, false
+    *     otherwise
+    *********************************************************************/
+    bool lineReader::parse_position(const fieldView & field, chromosomePosition & position) {
+       /***********************************************************\ 
+      | Accumulate the digits' values saturating on overflow and    |
+      | reject empty fields and fields containing other characters: |
+       \***********************************************************/
+      const chromosomePosition maximum(std::numeric_limits<chromosomePosition>::max());
+      if(field.begin == field.end)
+      {
+        return false;
+      }
+      position = 0;
+      for(const char * char_it(field.begin);char_it!=field.end;++char_it)
+      {
+        if(*char_it < '0' || *char_it > '9')
+        {
+          return false;
+        }
+        const chromosomePosition digit(*char_it - '0');
+        position = position > (maximum - digit) / 10 ? maximum : position * 10 + digit;
+      }
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief score field conversion
+    *
+    * This method is used to convert a field consisting of digits,
+    * decimal points, signs and exponent characters (e) only to a
+    * conservationScore.
+    * The field must be followed by a tab or a null character.
+    *
+    * @param field const fieldView reference to the field
+    * @param score conservationScore reference the value is assigned to
+    *
+    * @return true if the field is a non-empty string of valid
+    *     characters, false otherwise
+    *********************************************************************/
+    bool lineReader::parse_score(const fieldView & field, conservationScore & score) {
+       /************************************************************\ 
+      | Check the characters and let strtod convert the field (it    |
+      | stops at the following tab or null character at the latest): |
+       \************************************************************/
+      if(field.begin == field.end)
+      {
+        return false;
+      }
+      for(const char * char_it(field.begin);char_it!=field.end;++char_it)
+      {
+        if((*char_it < '0' || *char_it > '9') && *char_it != '-' && *char_it != '+' && *char_it != '.' && *char_it != 'e')
+        {
+          return false;
+        }
+      }
+      score = strtod(field.begin,NULL);
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief buffer refill
+    *
+    * This method is used to move the unread rest of the buffer to its
+    * front and to read the next block of the file behind it (growing
+    * the buffer if a single line does not fit).
+    *
+    * @return true if new data was read, false at the end of the file or
+    *     on errors
+    *********************************************************************/
+    bool lineReader::refill() {
+       /**************************************************************\ 
+      | Move the unread rest to the front, make room for another block |
+      | and read (or decompress) it (retrying interrupted reads):      |
+       \**************************************************************/
+      if(fd < 0 || end_of_file)
+      {
+        return false;
+      }
+      filled -= position;
+      memmove(&buffer[0],&buffer[position],filled);
+      buffer_offset += position;
+      position = 0;
+      if(buffer.size() < filled + block_size + 1)
+      {
+        buffer.resize(filled + block_size + 1);
+      }
+      ssize_t bytes_read(0);
+      if(decoder != NULL)
+      {
+        bytes_read = decoder->read(&buffer[filled],block_size);
+      }
+      else
+      {
+        while((bytes_read = read(fd,&buffer[filled],block_size)) < 0 && errno == EINTR) {/* nothing */}
+      }
+      if(bytes_read <= 0)
+      {
+        end_of_file = true;
+        return false;
+      }
+      filled += bytes_read;
+      return true;
+}
+
+
+} // namespace microSNPscore
@@ -2,7 +2,6 @@
 #include <algorithm>
 // for std::max and std::min (subsequence querying)
 #include "mRNA.h"
-#include "conservationList.h"
 #include "SNP.h"
 
 namespace microSNPscore {
@@ -27,8 +26,9 @@ namespace microSNPscore {
     * are treated as masked, respectively.
     *
     * @param the_ID sequenceID representing the ID of the mRNA
-    * @param sequence_string String representing the nucleotide sequence
-    *     (Adenine: A, Cytosine: C, Guanine: G, Uracil: U, Mask: X)
+    * @param sequence_string nucleotideText representing the nucleotide
+    *     sequence (Adenine: A, Cytosine: C, Guanine: G, Uracil: U,
+    *     Mask: X) which may be interrupted by newlines
     * @param the_chromosome chromosomeType representing the chromosome the
     *     mRNA is located on
     * @param the_strand strandType representing the strand (Plus/Minus) on
@@ -43,16 +43,14 @@ namespace microSNPscore {
     *     the 3' end of the + strand and accordingly the 5' end of
     *     the - strand) of the exons containing the mRNA as
     *     comma-separated list.
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the sequence
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return a mRNA containing the given nucleotides located on the
     *     given chromosome, strand and positions.
     *********************************************************************/
-    mRNA::mRNA(const sequenceID the_ID, std::string sequence_string, chromosomeType the_chromosome, strandType the_strand, std::string exons_starts, std::string exon_ends, const conservationList & conservations, bool verbose)
-    :sequence(the_ID,sequence_string,the_chromosome,the_strand,exons_starts,exon_ends,conservations,verbose) {
+    mRNA::mRNA(const sequenceID the_ID, nucleotideText sequence_string, chromosomeType the_chromosome, strandType the_strand, std::string exons_starts, std::string exon_ends, bool verbose)
+    :sequence(the_ID,sequence_string,the_chromosome,the_strand,exons_starts,exon_ends,verbose) {
 }
 
     /*****************************************************************//**
@@ -0,0 +1,136 @@
+#include <pthread.h>
+//for pthread_once, pthread_getspecific and pthread_setspecific (per-thread targets)
+#include "messageCapture.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief target key
+    *
+    * This is the key of the per-thread capture target.
+    *********************************************************************/
+    static pthread_key_t target_key;
+
+    /*****************************************************************//**
+    * @brief target key initialization flag
+    *
+    * This ensures the target key is created only once.
+    *********************************************************************/
+    static pthread_once_t target_key_once = PTHREAD_ONCE_INIT;
+
+    /*****************************************************************//**
+    * @brief target key creation
+    *
+    * This is used to create the key of the per-thread capture target.
+    *********************************************************************/
+    static void create_target_key() {
+      pthread_key_create(&target_key,NULL);
+}
+
+    /*****************************************************************//**
+    * @brief target access
+    *
+    * This is used to get the capture target of the calling thread.
+    *
+    * @return std::string pointer to the capture target (or NULL if
+    *     there is none)
+    *********************************************************************/
+    static std::string * get_target() {
+      pthread_once(&target_key_once,create_target_key);
+      return static_cast<std::string *>(pthread_getspecific(target_key));
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a messageCapture replacing the buffer of a
+    * given stream.
+    *
+    * @param the_stream std::ostream reference to the stream whose
+    *     messages should be captured
+    *
+    * @return messageCapture for the given stream
+    *********************************************************************/
+    messageCapture::messageCapture(std::ostream & the_stream)
+    :stream(the_stream),original(the_stream.rdbuf(this)) {
+}
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to give the stream its original buffer back.
+    *********************************************************************/
+    messageCapture::~messageCapture() {
+      stream.rdbuf(original);
+}
+
+    /*****************************************************************//**
+    * @brief capture target setting
+    *
+    * This method is used to set the string the messages written by the
+    * calling thread are appended to.
+    *
+    * @param target std::string pointer to the string the messages should
+    *     be appended to (or NULL to pass them on to the stream)
+    *********************************************************************/
+    void messageCapture::set_target(std::string * target) {
+      pthread_once(&target_key_once,create_target_key);
+      pthread_setspecific(target_key,target);
+}
+
+    /*****************************************************************//**
+    * @brief character output
+    *
+    * This method is used by the stream to write a single character.
+    *
+    * @param character int representing the character to write
+    *
+    * @return the character written or EOF on errors
+    *********************************************************************/
+    int messageCapture::overflow(int character) {
+      if(character == traits_type::eof())
+      {
+        return traits_type::not_eof(character);
+      }
+      std::string * target(get_target());
+      if(target != NULL)
+      {
+        target->push_back(traits_type::to_char_type(character));
+        return character;
+      }
+      return original->sputc(traits_type::to_char_type(character));
+}
+
+    /*****************************************************************//**
+    * @brief text output
+    *
+    * This method is used by the stream to write several characters.
+    *
+    * @param text const char pointer to the characters to write
+    * @param count std::streamsize representing the number of characters
+    *
+    * @return the number of characters written
+    *********************************************************************/
+    std::streamsize messageCapture::xsputn(const char * text, std::streamsize count) {
+      std::string * target(get_target());
+      if(target != NULL)
+      {
+        target->append(text,count);
+        return count;
+      }
+      return original->sputn(text,count);
+}
+
+    /*****************************************************************//**
+    * @brief synchronization
+    *
+    * This method is used by the stream to flush written characters.
+    *
+    * @return 0 on success, -1 on errors
+    *********************************************************************/
+    int messageCapture::sync() {
+      return get_target() != NULL ? 0 : original->pubsync();
+}
+
+
+} // namespace microSNPscore
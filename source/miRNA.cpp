@@ -43,8 +43,9 @@ namespace microSNPscore {
     * are treated as masked, respectively.
     *
     * @param the_ID sequenceID representing the ID of the miRNA
-    * @param sequence_string String representing the nucleotide sequence
-    *     (Adenine: A, Cytosine: C, Guanine: G, Uracil: U, Mask: X)
+    * @param sequence_string nucleotideText representing the nucleotide
+    *     sequence (Adenine: A, Cytosine: C, Guanine: G, Uracil: U,
+    *     Mask: X) which may be interrupted by newlines
     * @param the_chromosome chromosomeType representing the chromosome the
     *     miRNA is located on
     * @param the_strand strandType representing the strand (Plus/Minus) on
@@ -59,16 +60,14 @@ namespace microSNPscore {
     *     the 3' end of the + strand and accordingly the 5' end of
     *     the - strand) of the exons containing the miRNA as
     *     comma-separated list.
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the sequence
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return a miRNA containing the given nucleotides located on the
     *     given chromosome, strand and positions.
     *********************************************************************/
-    miRNA::miRNA(sequenceID the_id, std::string sequence_string, chromosomeType the_chromosome, strandType the_strand, std::string exon_starts, std::string exon_ends, const conservationList & conservations, bool verbose)
-    :sequence(the_id,sequence_string,the_chromosome,the_strand,exon_starts,exon_ends,conservations,verbose) {
+    miRNA::miRNA(sequenceID the_id, nucleotideText sequence_string, chromosomeType the_chromosome, strandType the_strand, std::string exon_starts, std::string exon_ends, bool verbose)
+    :sequence(the_id,sequence_string,the_chromosome,the_strand,exon_starts,exon_ends,verbose) {
 }
 
     /*****************************************************************//**
@@ -102,6 +101,8 @@ namespace microSNPscore {
     *     position 1) that is predicted to be the mRNA nucleotide that
     *     would bind the miRNA 5' end (if it would bind) (i.e. one base
     *     downstream (3') from the seed match region)
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
@@ -110,7 +111,7 @@ namespace microSNPscore {
     *
     * @see SNP::get_deregulation_score()
     *********************************************************************/
-    downregulationScore miRNA::get_downregulation_score(const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, bool verbose) const {
+    downregulationScore miRNA::get_downregulation_score(const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, const conservationList & conservations, bool verbose) const {
        /*********************************************************\ 
       | Calculate downregulation score candidates for all optimal |
       | alignments and return the maximum:                        |
@@ -136,10 +137,10 @@ namespace microSNPscore {
       }
       else
       {
-        downregulationScore downregulation_score(downregulation_score_candidate(the_mRNA,predicted_three_prime_position,*alignments.begin(),verbose));
+        downregulationScore downregulation_score(downregulation_score_candidate(the_mRNA,predicted_three_prime_position,*alignments.begin(),conservations,verbose));
         for(optimalAlignmentList::const_iterator alignment_it(alignments.begin()+1);alignment_it!=alignments.end();++alignment_it)
         {
-          downregulation_score=std::max(downregulation_score,downregulation_score_candidate(the_mRNA,predicted_three_prime_position,*alignment_it,verbose));
+          downregulation_score=std::max(downregulation_score,downregulation_score_candidate(the_mRNA,predicted_three_prime_position,*alignment_it,conservations,verbose));
         }
         if(verbose){std::cerr << "microSNPscore:        downregulation score calculation: ...final downregulation score: " << downregulation_score << std:: endl
                               << "microSNPscore:        downregulation score calculation: ...done" << std:: endl;}
@@ -179,6 +180,8 @@ namespace microSNPscore {
     *     downstream (3') from the seed match region)
     * @param the_alignment an alignment that is considered to be the best
     *     one for the miRNA-induced downregulation
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
@@ -188,7 +191,7 @@ namespace microSNPscore {
     *
     * @see get_downregulation_score()
     *********************************************************************/
-    downregulationScore miRNA::downregulation_score_candidate(const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, const alignment & the_alignment, bool verbose)
+    downregulationScore miRNA::downregulation_score_candidate(const mRNA & the_mRNA, chromosomePosition predicted_three_prime_position, const alignment & the_alignment, const conservationList & conservations, bool verbose)
     {
        /****************************************\ 
       | Define number and names of the features: |
@@ -378,7 +381,7 @@ namespace microSNPscore {
       downregulationScore features[feature_count];
       features[UTRLength]=the_mRNA.get_length();
       calculate_accessibility_features(&features[SS01],the_mRNA.get_subsequence_for_accessibility(predicted_three_prime_position),predicted_three_prime_position,verbose);
-      features[conservation]=calculate_conservation_feature(the_alignment);
+      features[conservation]=calculate_conservation_feature(the_alignment,the_mRNA.get_chromosome(),conservations);
       features[AU_content]=calculate_AU_content_feature(the_mRNA.get_subsequence_for_downstream_AU_content(predicted_three_prime_position),
                                                         the_mRNA.get_subsequence_for_upstream_AU_content(predicted_three_prime_position),
                                                         the_alignment.get_seed_type());
@@ -547,9 +550,15 @@ namespace microSNPscore {
     *
     * This method is used to calculate the conservation feature for the
     * downregulation score calculation.
+    * The conservation scores are only looked up for the mRNA nucleotides
+    * of the alignment.
     *
     * @param the_alignment an alignment that is considered to be the best
     *     one for the miRNA-induced downregulation
+    * @param the_chromosome const chromosomeType reference to the
+    *     chromosome the mRNA is located on
+    * @param conservations conservationList containing the conservation
+    *     ranges for the mRNA
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
@@ -558,19 +567,22 @@ namespace microSNPscore {
     *
     * @see downregulation_score_candidate()
     *********************************************************************/
-    downregulationScore miRNA::calculate_conservation_feature(const alignment & the_alignment, bool verbose)
+    downregulationScore miRNA::calculate_conservation_feature(const alignment & the_alignment, const chromosomeType & the_chromosome, const conservationList & conservations, bool verbose)
     {
-       /******************************************************************\ 
-      | Initialize empty score vector and add conservation scores for all  |
-      | non-gap mRNA-positions involved in the given mRNA:miRNA-alignment: |
-       \******************************************************************/
+       /*****************************************************************\ 
+      | Initialize empty score vector and add conservation scores for all |
+      | non-gap mRNA-positions involved in the given mRNA:miRNA-alignment |
+      | (walking the conservation ranges of the chromosome along them and |
+      | taking zero for nucleotides without conservation):                |
+       \*****************************************************************/
       std::vector<conservationScore> scores_raw;
+      conservationWalker conservation_walker(conservations,the_chromosome);
       for(alignment::const_iterator column_it(the_alignment.begin());column_it!=the_alignment.end();++column_it)
       {
         nucleotide mRNA_nucleotide(column_it->get_mRNA_nucleotide());
         if(mRNA_nucleotide.get_base() != Gap)
         {
-          scores_raw.push_back(mRNA_nucleotide.get_conservation());
+          scores_raw.push_back(mRNA_nucleotide.is_conserved() ? conservation_walker.get_score(mRNA_nucleotide.get_conservation_position()) : 0);
         }
       }
        /*****************************************************************\ 
@@ -1,53 +1,116 @@
 #include <string>
 #include <iostream>
-#include <fstream>
 #include <sstream>
-#include <map>
-#include <regex.h>
+#include <set>
+#include <vector>
+#include <algorithm>
+#include <deque>
+#include <cstdio>
+#include <unistd.h>
+#include <fcntl.h>
+#include <string.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <pthread.h>
 #include "mRNA.h"
 #include "miRNA.h"
 #include "sequenceFile.h"
+#include "sequenceFileIndex.h"
+#include "sequenceDatabase.h"
+#include "messageCapture.h"
 #include "alignment.h"
 #include "SNP.h"
 #include "conservationList.h"
 #include "filePath.h"
+#include "workerPool.h"
+#include "lineReader.h"
+#include "resultWriter.h"
+#include "entityTable.h"
+#include "SNPIndex.h"
+#include "socketService.h"
+#include "sequenceLoader.h"
 
 using namespace microSNPscore;
 
-void read_sequences(std::map<sequenceID,mRNA> & mRNA_map,filePath mRNA_path,
-                    std::map<sequenceID,miRNA> & miRNA_map,filePath miRNA_path,
-                    filePath conservations_path, bool verbose = false)
+struct predictionReferences
 {
-     /****************************************************************\ 
-    | Read the given files and insert the corresponing sequences into  |
-    | their maps reusing the sequenceFile object to hold only one file |
-    | at a time in memory:                                             |
-     \****************************************************************/
-    conservationList conservations(conservations_path);
-    sequenceFile the_file(mRNA_path);
-    the_file.read();
-    for(sequenceFile::const_iterator mRNA_it(the_file.begin());mRNA_it!=the_file.end();++mRNA_it)
-    {
-      mRNA the_mRNA(mRNA_it->get_mRNA(conservations,verbose));
-      mRNA_map.insert(std::pair<sequenceID,mRNA>(the_mRNA.get_ID(),the_mRNA));
-    }
-    the_file=sequenceFile(miRNA_path);
-    the_file.read();
-    for(sequenceFile::const_iterator miRNA_it(the_file.begin());miRNA_it!=the_file.end();++miRNA_it)
+  std::set<sequenceID> mRNAs;
+  std::set<sequenceID> miRNAs;
+  std::set<SNPID> SNPs;
+};
+
+bool split_prediction(const fieldView & line, fieldView fields[], chromosomePosition & three_prime, bool discover_SNPs)
+{
+   /**************************************************************\ 
+  | Split the line into the miRNA ID, the mRNA ID, the 3' position |
+  | and (unless the SNPs are discovered) the SNP ID:               |
+   \**************************************************************/
+  return lineReader::split_fields(line,fields,discover_SNPs ? 3 : 4) && fields[0].begin != fields[0].end && fields[1].begin != fields[1].end &&
+         lineReader::parse_position(fields[2],three_prime) && (discover_SNPs || fields[3].begin != fields[3].end);
+}
+
+struct predictionShard
+{
+  unsigned long index;
+  unsigned long count;
+  off_t resume_offset;
+};
+
+bool select_shard(lineReader & file, const predictionShard & shard)
+{
+   /*************************************************************\ 
+  | Restrict the reader to the lines starting in the shard's part |
+  | of the file (the whole file is a single shard) skipping those |
+  | scored before the checkpoint a run is resumed from:           |
+   \*************************************************************/
+  if(shard.count == 1 && shard.resume_offset == 0)
+  {
+    return true;
+  }
+  const off_t size(file.get_size());
+  return size >= 0 && file.set_range(std::max(size * off_t(shard.index - 1) / off_t(shard.count),shard.resume_offset),
+                                     size * off_t(shard.index) / off_t(shard.count));
+}
+
+bool scan_predictions(predictionReferences & references, filePath path, const predictionShard & shard, bool discover_SNPs = false)
+{
+   /**************************************************\ 
+  | Try to open a line reader for the given file path  |
+  | and collect the IDs of every valid prediction line |
+  | of the shard (invalid lines are reported when      |
+  | scoring):                                          |
+   \**************************************************/
+  lineReader file(path);
+  if(!file.is_open() || !select_shard(file,shard))
+  {
+    return false;
+  }
+  fieldView line;
+  fieldView fields[4];
+  while(file.next_line(line))
+  {
+    chromosomePosition three_prime;
+    if(split_prediction(line,fields,three_prime,discover_SNPs))
     {
-      miRNA the_miRNA(miRNA_it->get_miRNA(conservations,verbose));
-      miRNA_map.insert(std::pair<sequenceID,miRNA>(the_miRNA.get_ID(),the_miRNA));
-    }
+      references.miRNAs.insert(sequenceID(fields[0].begin,fields[0].end));
+      references.mRNAs.insert(sequenceID(fields[1].begin,fields[1].end));
+      if(!discover_SNPs)
+      {
+        references.SNPs.insert(SNPID(fields[3].begin,fields[3].end));
+      }
+    } // valid line
+  } // file.next_line(line)
+  return true;
 }
 
-void read_SNPs(std::map<SNPID,SNP> & map, filePath path)
+void read_SNPs(entityTable<SNPID,SNP> & table, filePath path, const predictionReferences * references = NULL)
 {
-   /********************************************************\ 
-  | Try to open an input file stream associated to the given |
-  | file path stating an error in the case of failure:       |
-   \********************************************************/
-  std::ifstream file(path.c_str());
-  if(file.fail())
+   /*************************************************\ 
+  | Try to open a line reader for the given file path |
+  | stating an error in the case of failure:          |
+   \*************************************************/
+  lineReader file(path);
+  if(!file.is_open())
   {
     std::cerr << "microSNPscore::read_SNPs\n";
     std::cerr << " ==> Cannot open file to read from: ";
@@ -56,72 +119,620 @@ void read_SNPs(std::map<SNPID,SNP> & map, filePath path)
   }
   else
   {
-     /********************************************************\ 
-    | Try to initialize extended regular expression matching a |
-    | valid SNP file line stating error in case of failure:    |
-     \********************************************************/
-    regex_t line_regex;
-    char line_pattern[] = "^(.+)\t(.+)\t(.*)\t(.+)\t([-+])\t([[:digit:]]+)$";
-    int error_code = regcomp(&line_regex,line_pattern,REG_EXTENDED);
-    if(error_code != 0)
+     /***********************************************************\ 
+    | Read the content of the file linewise and try to split each |
+    | line into its six fields stating error in case of failure:  |
+     \***********************************************************/
+    fieldView line;
+    fieldView fields[6];
+    while(file.next_line(line))
+    {
+      chromosomePosition position;
+      if(!lineReader::split_fields(line,fields,6,true) || fields[0].begin == fields[0].end || fields[1].begin == fields[1].end ||
+         fields[3].begin == fields[3].end || fields[4].end != fields[4].begin+1 || (*fields[4].begin != '+' && *fields[4].begin != '-') ||
+         !lineReader::parse_position(fields[5],position))
+      {
+            std::cerr << "microSNPscore::read_SNPs\n";
+            std::cerr << " ==> no valid SNP file line:\n";
+            std::cerr << line.begin << std::endl;
+            std::cerr << "     error message:\n";
+            std::cerr << "No match" << std::endl;
+            std::cerr << "  --> omitting line\n";
+      }
+      else
+      {
+         /*******************************************\ 
+        | Assign the fields to the corresponding      |
+        | parameters to create a SNP and insert it in |
+        | the table (unless it is not referenced):    |
+         \*******************************************/
+        SNPID ID(fields[0].begin,fields[0].end);
+        if(references != NULL && references->SNPs.count(ID) == 0)
+        {
+          continue;
+        }
+        std::string reference(fields[1].begin,fields[1].end);
+        std::string alternative(fields[2].begin,fields[2].end);
+        chromosomeType chromosome(fields[3].begin,fields[3].end);
+        strandType strand(*fields[4].begin == '+' ? Plus : Minus);
+        SNP line_SNP(ID,reference,alternative,chromosome,strand,position);
+        table.insert(ID,line_SNP);
+      } // valid line
+    } // file.next_line(line)
+  } // file.is_open()
+}
+
+struct targetSite
+{
+  entityID miRNA;
+  entityID mRNA;
+  chromosomePosition three_prime;
+
+  bool operator<(const targetSite & other) const
+  {
+    return miRNA != other.miRNA ? miRNA < other.miRNA :
+           mRNA != other.mRNA ? mRNA < other.mRNA : three_prime < other.three_prime;
+  }
+
+  bool operator==(const targetSite & other) const
+  {
+    return miRNA == other.miRNA && mRNA == other.mRNA && three_prime == other.three_prime;
+  }
+};
+
+struct wildtypeScoreTable
+{
+  std::vector<targetSite> sites;
+  std::vector<downregulationScore> scores;
+
+  bool find(const targetSite & site, downregulationScore & score) const
+  {
+    std::vector<targetSite>::const_iterator site_it(std::lower_bound(sites.begin(),sites.end(),site));
+    if(site_it == sites.end() || !(*site_it == site))
     {
-      std::cerr << "microSNPscore::read_SNPs\n";
-      std::cerr << " ==> compiling line regular expression failed:\n";
-      const size_t error_len(regerror(error_code,&line_regex,NULL,0));
-      char error_message[error_len];
-      regerror(error_code,&line_regex,error_message,error_len);
-      std::cerr << error_message << std::endl;
-      std::cerr << "  --> no SNPs will be read from the file\n";
+      return false;
     }
-    else
+    score = scores[site_it-sites.begin()];
+    return true;
+  }
+};
+
+void discover_SNPs(std::vector<entityID> & IDs, const SNPIndex & index, const entityTable<SNPID,SNP> & SNPs,
+                   const miRNA & the_miRNA, const mRNA & the_mRNA, chromosomePosition three_prime)
+{
+   /**************************************************************\ 
+  | Query the SNPs overlapping the miRNA and those overlapping the |
+  | chromosome range of the mRNA's accessibility window (+/- 80    |
+  | nucleotides around the site) and keep every SNP affecting the  |
+  | prediction once in order of the SNPs' IDs:                     |
+   \**************************************************************/
+  const sequenceLength window_size(80);
+  IDs.clear();
+  if(the_miRNA.exons_begin() != the_miRNA.exons_end())
+  {
+    index.find(the_miRNA.get_chromosome(),the_miRNA.exons_begin()->get_start(),(the_miRNA.exons_end()-1)->get_end(),IDs);
+  }
+  const sequence::const_iterator site(the_mRNA.get_nucleotide_chr(three_prime));
+  if(site != the_mRNA.end())
+  {
+    const chromosomePosition first(the_mRNA.get_nucleotide(std::max(1,site->get_sequence_position() - window_size))->get_chromosome_position());
+    const chromosomePosition last(the_mRNA.get_nucleotide(std::min<int>(the_mRNA.get_length(),site->get_sequence_position() + window_size))->get_chromosome_position());
+    index.find(the_mRNA.get_chromosome(),std::min(first,last),std::max(first,last),IDs);
+  }
+  std::sort(IDs.begin(),IDs.end());
+  IDs.erase(std::unique(IDs.begin(),IDs.end()),IDs.end());
+  std::vector<entityID>::iterator kept_end(IDs.begin());
+  for(std::vector<entityID>::const_iterator ID_it(IDs.begin());ID_it!=IDs.end();++ID_it)
+  {
+    if(SNPs[*ID_it].affects(the_miRNA,the_mRNA))
+    {
+      *kept_end++ = *ID_it;
+    }
+  }
+  IDs.erase(kept_end,IDs.end());
+}
+
+void collect_sites(wildtypeScoreTable & table, filePath path, const predictionShard & shard, const entityTable<sequenceID,mRNA> & mRNAs,
+                   const entityTable<sequenceID,miRNA> & miRNAs, const entityTable<SNPID,SNP> & SNPs,
+                   const SNPIndex * index = NULL)
+{
+   /************************************************************\ 
+  | Collect the target sites of all valid predictions with a SNP |
+  | affecting them (given or discovered by the index if there is |
+  | one; invalid lines are reported when scoring) and keep every |
+  | site only once:                                              |
+   \************************************************************/
+  lineReader file(path);
+  select_shard(file,shard);
+  fieldView line;
+  fieldView fields[4];
+  std::vector<entityID> SNP_IDs;
+  while(file.next_line(line))
+  {
+    targetSite site;
+    entityID SNP_ID;
+    if(split_prediction(line,fields,site.three_prime,index != NULL) &&
+       miRNAs.find(fields[0].begin,fields[0].end,site.miRNA) &&
+       mRNAs.find(fields[1].begin,fields[1].end,site.mRNA))
+    {
+      if(index != NULL)
+      {
+        discover_SNPs(SNP_IDs,*index,SNPs,miRNAs[site.miRNA],mRNAs[site.mRNA],site.three_prime);
+      }
+      if(index != NULL ? !SNP_IDs.empty() : SNPs.find(fields[3].begin,fields[3].end,SNP_ID) &&
+                                            SNPs[SNP_ID].affects(miRNAs[site.miRNA],mRNAs[site.mRNA]))
+      {
+        table.sites.push_back(site);
+      }
+    } // valid line
+  } // file.next_line(line)
+  std::sort(table.sites.begin(),table.sites.end());
+  table.sites.erase(std::unique(table.sites.begin(),table.sites.end()),table.sites.end());
+  table.scores.assign(table.sites.size(),0);
+}
+
+class wildtypeTask : public workerTask
+{
+  public:
+    wildtypeTask(const entityTable<sequenceID,mRNA> & the_mRNAs, const entityTable<sequenceID,miRNA> & the_miRNAs,
+                 const conservationList & the_conservations, const wildtypeScoreTable & the_table, bool the_verbose)
+    :mRNAs(the_mRNAs),miRNAs(the_miRNAs),conservations(the_conservations),table(the_table),verbose(the_verbose) {}
+
+    std::string process(const std::string & site_index)
     {
        /**************************************************************\ 
-      | Read the content of the file linewise into a string and try to |
-      | match the initialized regular expression stating error in case |
-      | of failure:                                                    |
+      | Score the site with the given index and return the score in    |
+      | its shortest exact representation (to be read back unchanged): |
        \**************************************************************/
-      std::string line_string;
-      size_t line_nmatch(7);
-      regmatch_t line_pmatch[line_nmatch];
-      while(getline(file,line_string).good())
+      const targetSite & site(table.sites[strtoul(site_index.c_str(),NULL,10)]);
+      std::string result;
+      resultWriter::append_score(result,miRNAs[site.miRNA].get_downregulation_score(mRNAs[site.mRNA],site.three_prime,conservations,verbose),true);
+      return result;
+    }
+
+  private:
+    const entityTable<sequenceID,mRNA> & mRNAs;
+    const entityTable<sequenceID,miRNA> & miRNAs;
+    const conservationList & conservations;
+    const wildtypeScoreTable & table;
+    const bool verbose;
+};
+
+class siteSource : public requestSource, public resultSink
+{
+  public:
+    siteSource(wildtypeScoreTable & the_table)
+    :table(the_table),requested(0),received(0) {}
+
+    bool next_request(std::string & site_index)
+    {
+      if(requested == table.sites.size())
+      {
+        return false;
+      }
+      site_index.clear();
+      resultWriter::append_position(site_index,requested++);
+      return true;
+    }
+
+    void put_result(const std::string & score)
+    {
+      table.scores[received++] = strtod(score.c_str(),NULL);
+    }
+
+  private:
+    wildtypeScoreTable & table;
+    chromosomePosition requested;
+    chromosomePosition received;
+};
+
+class predictionTask : public workerTask
+{
+  public:
+    predictionTask(const entityTable<sequenceID,mRNA> & the_mRNAs, const entityTable<sequenceID,miRNA> & the_miRNAs,
+                   const entityTable<SNPID,SNP> & the_SNPs, const conservationList & the_conservations,
+                   const wildtypeScoreTable & the_wildtype_scores, bool the_exact_scores, bool the_verbose,
+                   const SNPIndex * the_index = NULL)
+    :mRNAs(the_mRNAs),miRNAs(the_miRNAs),SNPs(the_SNPs),conservations(the_conservations),wildtype_scores(the_wildtype_scores),exact_scores(the_exact_scores),verbose(the_verbose),index(the_index) {}
+
+    std::string process(const std::string & line_string)
+    {
+       /*****************************************************************\ 
+      | Try to split the line into its four fields (three if the SNPs     |
+      | are discovered by the index) stating an error in case of failure: |
+       \*****************************************************************/
+      if(verbose){std::cerr << "microSNPscore: Reading prediction..." << std::endl;}
+      fieldView line = {line_string.data(),line_string.data()+line_string.size()};
+      fieldView fields[4];
+      chromosomePosition three_prime;
+      if(!split_prediction(line,fields,three_prime,index != NULL))
+      {
+            std::cerr << "microSNPscore::read_predictions\n";
+            std::cerr << " ==> no valid prediction file line:\n";
+            std::cerr << line_string << std::endl;
+            std::cerr << "     error message:\n";
+            std::cerr << "No match" << std::endl;
+            std::cerr << "  --> omitting line\n";
+            return "";
+      }
+      if(verbose){std::cerr << "microSNPscore: ...miRNA ID: " << sequenceID(fields[0].begin,fields[0].end) << std::endl
+                            << "microSNPscore: ...mRNA ID: " << sequenceID(fields[1].begin,fields[1].end) << std::endl
+                            << "microSNPscore: ...3' position: " << three_prime << std::endl;}
+       /*********************************************************\ 
+      | Resolve the IDs to the loaded entities (straight from the |
+      | fields of the line) stating an error for unknown ones     |
+      | instead of scoring against empty objects and discover the |
+      | SNPs affecting the prediction if requested:               |
+       \*********************************************************/
+      entityID miRNA_ID;
+      entityID mRNA_ID;
+      std::vector<entityID> SNP_IDs(1);
+      if(!miRNAs.find(fields[0].begin,fields[0].end,miRNA_ID))
+      {
+        report_unknown("miRNA",sequenceID(fields[0].begin,fields[0].end));
+        return "";
+      }
+      if(!mRNAs.find(fields[1].begin,fields[1].end,mRNA_ID))
+      {
+        report_unknown("mRNA",sequenceID(fields[1].begin,fields[1].end));
+        return "";
+      }
+      if(index != NULL)
+      {
+        discover_SNPs(SNP_IDs,*index,SNPs,miRNAs[miRNA_ID],mRNAs[mRNA_ID],three_prime);
+        if(verbose){std::cerr << "microSNPscore: ...discovered " << SNP_IDs.size() << " SNPs" << std::endl;}
+      }
+      else if(!SNPs.find(fields[3].begin,fields[3].end,SNP_IDs[0]))
+      {
+        report_unknown("SNP",SNPID(fields[3].begin,fields[3].end));
+        return "";
+      }
+       /************************************************************\ 
+      | Score the new prediction for every SNP (reusing the wildtype |
+      | score of its target site if it was calculated before) and    |
+      | return the result lines:                                     |
+       \************************************************************/
+      const targetSite site = {miRNA_ID,mRNA_ID,three_prime};
+      downregulationScore wildtype_score;
+      const bool wildtype_known(wildtype_scores.find(site,wildtype_score));
+      std::string result;
+      for(std::vector<entityID>::const_iterator SNP_it(SNP_IDs.begin());SNP_it!=SNP_IDs.end();++SNP_it)
+      {
+        if(verbose){std::cerr << "microSNPscore: Calculating deregulation score..." << std::endl;}
+        const deregulationScore score(wildtype_known ?
+                                      SNPs[*SNP_it].get_deregulation_score(miRNAs[miRNA_ID],mRNAs[mRNA_ID],three_prime,wildtype_score,conservations,verbose) :
+                                      SNPs[*SNP_it].get_deregulation_score(miRNAs[miRNA_ID],mRNAs[mRNA_ID],three_prime,conservations,verbose));
+        result.append(fields[0].begin,fields[0].end);
+        result += '\t';
+        result.append(fields[1].begin,fields[1].end);
+        result += '\t';
+        resultWriter::append_position(result,three_prime);
+        result += '\t';
+        result += SNPs[*SNP_it].get_ID();
+        result += '\t';
+        resultWriter::append_score(result,score,exact_scores);
+        result += '\n';
+        if(verbose){std::cerr << "microSNPscore: ...done" << std::endl;}
+      }
+      return result;
+    }
+
+  private:
+    void report_unknown(const std::string & kind, const std::string & ID) const
+    {
+      std::cerr << "microSNPscore::read_predictions\n";
+      std::cerr << " ==> unknown " << kind << " ID: ";
+      std::cerr << ID << std::endl;
+      std::cerr << "  --> omitting line\n";
+    }
+
+    const entityTable<sequenceID,mRNA> & mRNAs;
+    const entityTable<sequenceID,miRNA> & miRNAs;
+    const entityTable<SNPID,SNP> & SNPs;
+    const conservationList & conservations;
+    const wildtypeScoreTable & wildtype_scores;
+    const bool exact_scores;
+    const bool verbose;
+    const SNPIndex * index;
+};
+
+class lineSource : public requestSource
+{
+  public:
+    lineSource(lineReader & the_reader, std::deque<off_t> * the_line_ends = NULL)
+    :reader(the_reader),line_ends(the_line_ends) {}
+
+    bool next_request(std::string & line_string)
+    {
+      fieldView line;
+      if(!reader.next_line(line))
       {
-        error_code = regexec(&line_regex,line_string.c_str(),line_nmatch,line_pmatch,0);
-        if(error_code != 0)
+        return false;
+      }
+      line_string.assign(line.begin,line.end);
+      if(line_ends != NULL)
+      {
+        line_ends->push_back(reader.get_offset());
+      }
+      return true;
+    }
+
+  private:
+    lineReader & reader;
+    std::deque<off_t> * line_ends;
+};
+
+struct checkpoint
+{
+  off_t input_offset;
+  off_t output_length;
+  off_t input_size;
+};
+
+bool read_checkpoint(checkpoint & the_checkpoint, filePath path)
+{
+   /**********************************************************\ 
+  | Read the input offset, output length and input size stored |
+  | in the checkpoint file:                                    |
+   \**********************************************************/
+  lineReader file(path);
+  fieldView line;
+  if(!file.next_line(line))
+  {
+    return false;
+  }
+  std::istringstream stream_checkpoint(std::string(line.begin,line.end));
+  long long input_offset, output_length, input_size;
+  if(!(stream_checkpoint >> input_offset >> output_length >> input_size) || input_offset < 0 || output_length < 0)
+  {
+    return false;
+  }
+  the_checkpoint.input_offset = input_offset;
+  the_checkpoint.output_length = output_length;
+  the_checkpoint.input_size = input_size;
+  return true;
+}
+
+bool write_checkpoint(const checkpoint & the_checkpoint, filePath path)
+{
+   /*************************************************************\ 
+  | Write the checkpoint to a temporary file and rename it to the |
+  | checkpoint path so that a crash leaves either the old or the  |
+  | new checkpoint but never a partial one:                       |
+   \*************************************************************/
+  const filePath temporary_path(path+".tmp");
+  std::ostringstream stream_checkpoint;
+  stream_checkpoint << static_cast<long long>(the_checkpoint.input_offset) << '\t'
+                    << static_cast<long long>(the_checkpoint.output_length) << '\t'
+                    << static_cast<long long>(the_checkpoint.input_size) << '\n';
+  const std::string content(stream_checkpoint.str());
+  const int fd(open(temporary_path.c_str(),O_WRONLY | O_CREAT | O_TRUNC,0644));
+  if(fd < 0)
+  {
+    return false;
+  }
+  const bool written(write(fd,content.data(),content.size()) == ssize_t(content.size()) && fsync(fd) == 0);
+  return close(fd) == 0 && written && rename(temporary_path.c_str(),path.c_str()) == 0;
+}
+
+class checkpointSink : public resultSink
+{
+  public:
+    checkpointSink(resultWriter & the_writer, int the_output_fd, std::deque<off_t> & the_line_ends,
+                   const filePath & the_path, const checkpoint & the_start, unsigned long the_interval)
+    :writer(the_writer),output_fd(the_output_fd),line_ends(the_line_ends),path(the_path),
+     current(the_start),interval(the_interval),results(0),failed(false) {}
+
+    void put_result(const std::string & result)
+    {
+       /************************************************************\ 
+      | Pass the result on, remember the end of its prediction line  |
+      | and save a checkpoint after the given number of results (the |
+      | output length stays the one the run started with):           |
+       \************************************************************/
+      writer.put_result(result);
+      current.input_offset = line_ends.front();
+      line_ends.pop_front();
+      if(++results == interval)
+      {
+        save();
+      }
+    }
+
+    bool save()
+    {
+       /***********************************************************\ 
+      | Write all results up to the current line to disk before the |
+      | checkpoint referring to them stating an error on failure:   |
+       \***********************************************************/
+      results = 0;
+      bool saved(writer.flush() && fsync(output_fd) == 0);
+      if(saved)
+      {
+        checkpoint flushed(current);
+        flushed.output_length = current.output_length + writer.get_written();
+        saved = write_checkpoint(flushed,path);
+      }
+      if(!saved && !failed)
+      {
+        std::cerr << "microSNPscore::checkpointSink::save\n";
+        std::cerr << " ==> Cannot write checkpoint: ";
+        std::cerr << path << ": " << strerror(errno) << std::endl;
+        std::cerr << "  --> a resumed run may repeat more predictions\n";
+        failed = true;
+      }
+      return saved;
+    }
+
+  private:
+    resultWriter & writer;
+    const int output_fd;
+    std::deque<off_t> & line_ends;
+    const filePath path;
+    checkpoint current;
+    const unsigned long interval;
+    unsigned long results;
+    bool failed;
+};
+
+int merge_outputs(int path_count, char * paths[])
+{
+   /***************************************************************\ 
+  | Copy the shard outputs in the given order to STDOUT stating an  |
+  | error for outputs that cannot be read or end with an incomplete |
+  | line (e.g. of a shard that did not finish):                     |
+   \***************************************************************/
+  resultWriter writer;
+  bool complete(true);
+  for(int path_index(0);path_index<path_count;++path_index)
+  {
+    lineReader file(paths[path_index]);
+    fieldView line;
+    std::string line_string;
+    while(file.next_line(line))
+    {
+      line_string.assign(line.begin,line.end);
+      line_string += '\n';
+      writer.put_result(line_string);
+    }
+    if(!file.is_open() || file.get_offset() != file.get_size())
+    {
+      std::cerr << "microSNPscore::merge_outputs\n";
+      std::cerr << " ==> Cannot read complete shard output: ";
+      std::cerr << paths[path_index] << std::endl;
+      std::cerr << "  --> merged output is incomplete\n";
+      complete = false;
+    }
+  } // path_index
+  return writer.flush() && complete ? 0 : 1;
+}
+
+struct mutatedExport {
+  const entityTable<sequenceID,mRNA> * mRNAs;
+  const entityTable<SNPID,SNP> * SNPs;
+  const SNPIndex * index;
+  std::vector<std::string> * records;
+  std::vector<std::string> * messages;
+  entityID chunk_begin;
+  size_t first;
+  size_t step;
+};
+
+void * export_mutated(void * argument)
+{
+   /**************************************************************\ 
+  | Append the FASTA entries of every step-th transcript of the    |
+  | chunk mutated with each SNP matching it (in order of the SNPs' |
+  | IDs) to the transcript's record reserved for all of them at    |
+  | once, collecting the error messages of each one separately:    |
+   \**************************************************************/
+  const mutatedExport & job(*static_cast<mutatedExport *>(argument));
+  std::vector<entityID> SNP_IDs;
+  for(size_t slot(job.first);slot<job.records->size();slot+=job.step)
+  {
+    messageCapture::set_target(&(*job.messages)[slot]);
+    const mRNA & the_mRNA((*job.mRNAs)[job.chunk_begin+slot]);
+    SNP_IDs.clear();
+    if(the_mRNA.exons_begin() != the_mRNA.exons_end())
+    {
+      job.index->find(the_mRNA.get_chromosome(),the_mRNA.exons_begin()->get_start(),(the_mRNA.exons_end()-1)->get_end(),SNP_IDs);
+    }
+    std::sort(SNP_IDs.begin(),SNP_IDs.end());
+    SNP_IDs.erase(std::unique(SNP_IDs.begin(),SNP_IDs.end()),SNP_IDs.end());
+    std::vector<entityID>::iterator kept_end(SNP_IDs.begin());
+    for(std::vector<entityID>::const_iterator ID_it(SNP_IDs.begin());ID_it!=SNP_IDs.end();++ID_it)
+    {
+      if((*job.SNPs)[*ID_it].matches(the_mRNA))
+      {
+        *kept_end++ = *ID_it;
+      }
+    }
+    SNP_IDs.erase(kept_end,SNP_IDs.end());
+    const size_t record_size(the_mRNA.get_length() + the_mRNA.get_length() / 60 + the_mRNA.get_ID().size() +
+                             the_mRNA.get_chromosome().size() + (the_mRNA.exons_end()-the_mRNA.exons_begin()) * 24 + 64);
+    std::string & record((*job.records)[slot]);
+    record.reserve(SNP_IDs.size() * record_size);
+    for(std::vector<entityID>::const_iterator ID_it(SNP_IDs.begin());ID_it!=SNP_IDs.end();++ID_it)
+    {
+      sequenceFileEntry::append_FASTA(record,the_mRNA.sequence::mutate((*job.SNPs)[*ID_it]));
+    }
+  }
+  messageCapture::set_target(NULL);
+  return NULL;
+}
+
+int export_mutated_transcripts(filePath mRNA_path, filePath SNPs_path, filePath FASTA_path)
+{
+   /*****************************************************\ 
+  | Read the transcripts and the SNPs and index the SNPs: |
+   \*****************************************************/
+  entityTable<sequenceID,mRNA> mRNAs;
+  read_mRNAs(mRNAs,mRNA_path);
+  entityTable<SNPID,SNP> SNPs;
+  read_SNPs(SNPs,SNPs_path);
+  const SNPIndex index(SNPs);
+   /********************************************************\ 
+  | Try to open the output file stating an error in the case |
+  | of failure:                                              |
+   \********************************************************/
+  const int output_fd(open(FASTA_path.c_str(),O_WRONLY | O_CREAT | O_TRUNC,0644));
+  if(output_fd < 0)
+  {
+    std::cerr << "microSNPscore::export_mutated_transcripts\n";
+    std::cerr << " ==> Cannot open file to write to: ";
+    std::cerr << FASTA_path << std::endl;
+    std::cerr << "  --> mutated transcripts won't be written to the file\n";
+    return 1;
+  }
+   /*****************************************************************\ 
+  | Create the records of the transcripts in chunks on one thread per |
+  | processor (doing the share of threads that could not be started   |
+  | here) and write them and their messages in the transcripts' order |
+  | through a buffered writer:                                        |
+   \*****************************************************************/
+  const unsigned int threads(processor_count());
+  const entityID chunk_size(threads * 64);
+  messageCapture capture(std::cerr);
+  bool written(true);
+  {
+    resultWriter writer(output_fd);
+    std::vector<mutatedExport> jobs(threads);
+    std::vector<pthread_t> thread_IDs(threads);
+    for(entityID chunk_begin(0);chunk_begin<mRNAs.size();chunk_begin+=chunk_size)
+    {
+      std::vector<std::string> records(std::min(chunk_size,mRNAs.size()-chunk_begin));
+      std::vector<std::string> messages(records.size());
+      std::vector<bool> started(threads,false);
+      for(unsigned int thread_index(0);thread_index!=threads;++thread_index)
+      {
+        const mutatedExport job = {&mRNAs,&SNPs,&index,&records,&messages,chunk_begin,thread_index,threads};
+        jobs[thread_index] = job;
+        if(thread_index != 0)
         {
-              std::cerr << "microSNPscore::read_SNPs\n";
-              std::cerr << " ==> no valid SNP file line:\n";
-              std::cerr << line_string << std::endl;
-              std::cerr << "     error message:\n";
-              const size_t error_len(regerror(error_code,&line_regex,NULL,0));
-              char error_message[error_len];
-              regerror(error_code,&line_regex,error_message,error_len);
-              std::cerr << error_message << std::endl;
-              std::cerr << "  --> omitting line\n";
+          started[thread_index] = pthread_create(&thread_IDs[thread_index],NULL,export_mutated,&jobs[thread_index]) == 0;
+        }
+      }
+      export_mutated(&jobs[0]);
+      for(unsigned int thread_index(1);thread_index<threads;++thread_index)
+      {
+        if(started[thread_index])
+        {
+          pthread_join(thread_IDs[thread_index],NULL);
         }
         else
         {
-           /*****************************************************************\ 
-          | Extract the subsequences matching the regular expression's groups |
-          | from the line assigning them to the corresponding parameters      |
-          | (converting them via a stringstream) to create a SNP:             |
-           \*****************************************************************/
-          SNPID ID(line_string.substr(line_pmatch[1].rm_so,line_pmatch[1].rm_eo-line_pmatch[1].rm_so));
-          std::string reference(line_string.substr(line_pmatch[2].rm_so,line_pmatch[2].rm_eo-line_pmatch[2].rm_so));
-          std::string alternative(line_string.substr(line_pmatch[3].rm_so,line_pmatch[3].rm_eo-line_pmatch[3].rm_so));
-          chromosomeType chromosome(line_string.substr(line_pmatch[4].rm_so,line_pmatch[4].rm_eo-line_pmatch[4].rm_so));
-          strandType strand(line_string.substr(line_pmatch[5].rm_so,line_pmatch[5].rm_eo-line_pmatch[5].rm_so) == "+" ? Plus : Minus);
-          chromosomePosition position;
-          std::istringstream stream_position(line_string.substr(line_pmatch[6].rm_so,line_pmatch[6].rm_eo-line_pmatch[6].rm_so));
-          stream_position >> position;
-          SNP line_SNP(ID,reference,alternative,chromosome,strand,position);
-           /******************************\ 
-          | Insert the new SNP in the map: |
-           \******************************/
-          map.insert(std::pair<SNPID,SNP>(ID,line_SNP));
-        } // regexec(&line_regex,line_string.c_str(),line_nmatch,line_pmatch,0) == 0
-      } // getline(file,line_string).good()
-    } // regcomp(&line_regex,line_pattern,REG_EXTENDED) == 0
-  } // !file.fail()
+          export_mutated(&jobs[thread_index]);
+        }
+      }
+      for(size_t slot(0);slot!=records.size();++slot)
+      {
+        std::cerr << messages[slot];
+        writer.put_result(records[slot]);
+      }
+    } // chunk_begin
+    written = writer.flush();
+  }
+  return close(output_fd) == 0 && written ? 0 : 1;
 }
 
 int main(int argc, char * argv[])
@@ -129,8 +740,43 @@ int main(int argc, char * argv[])
    /*******************************\ 
   | Define help and usage messages: |
    \*******************************/
-  const std::string usage(std::string(argv[0])+" [mRNA file] [miRNA file] [conservation file] [SNP file] [prediction file]\n");
-  const std::string help(usage);
+  const std::string usage(std::string(argv[0])+" [mRNA file] [miRNA file] [conservation file] [SNP file] [prediction file] [options]\n"+
+                          std::string(argv[0])+" merge [shard output files in shard order]\n"+
+                          std::string(argv[0])+" index [mRNA or miRNA files]\n"+
+                          std::string(argv[0])+" build-db [mRNA or miRNA file] [database file]\n"+
+                          std::string(argv[0])+" convert-conservation [conservation file] [track file]\n"+
+                          std::string(argv[0])+" export [mRNA file] [SNP file] [FASTA file]\n"+
+                          std::string(argv[0])+" serve [mRNA file] [miRNA file] [conservation file] [SNP file] [socket] [options]\n"+
+                          std::string(argv[0])+" client [socket] [prediction file]\n");
+  const std::string help(usage+"options:\n"
+                               "  -v, --verbose    report progress to STDERR\n"
+                               "  --threads N      score predictions with N worker processes (default: 1)\n"
+                               "  --flush-every N  write the results at least every N predictions (default: when the buffer is full)\n"
+                               "  --exact-scores   print the shortest exact score representation (default: 6 significant digits)\n"
+                               "  --discover-SNPs  read predictions without SNP column and score every SNP on the miRNA\n"
+                               "                   or within the accessibility window (80 nt) around the site\n"
+                               "  --shard I/N      only score the lines starting in the I-th of N equal byte ranges of the prediction\n"
+                               "                   file (1 <= I <= N); merge the shard outputs to get the output of the whole file\n"
+                               "  --output FILE    write the results to FILE instead of STDOUT\n"
+                               "  --checkpoint FILE  record the scored part of the prediction file and the output written so far\n"
+                               "                   in FILE (needs --output)\n"
+                               "  --checkpoint-every N  save a checkpoint every N predictions (default: 1000)\n"
+                               "  --resume         continue from the checkpoint (if there is one) instead of starting over\n"
+                               "  --genome FILE    take the mRNA file as BED12 or GTF annotation of the transcripts and extract\n"
+                               "                   their spliced sequences from the genome FASTA FILE (indexed: FILE.fai)\n"
+                               "input files may be compressed with gzip or bgzip (BGZF blocks are decompressed on several\n"
+                               "threads); --shard, --resume and index need uncompressed files\n"
+                               "serve loads all sequences and SNPs once and answers the prediction lines sent by clients over\n"
+                               "the Unix domain socket (one process per connection) until it receives SIGINT or SIGTERM;\n"
+                               "--threads, --flush-every and --shard do not apply to it\n"
+                               "index writes an index next to each sequence file (FILE.idx), so only the sequences\n"
+                               "referenced by the predictions are read from it (rebuild it when the file changes)\n"
+                               "build-db compiles a sequence file into a binary database which can be given instead of the\n"
+                               "mRNA or miRNA file\n"
+                               "convert-conservation writes a binary track of a conservation file which can be given instead\n"
+                               "of it (the track is mapped instead of parsed, so only the scores looked up are read)\n"
+                               "export writes every mRNA mutated with each SNP matching it (in SNP file order) to a FASTA file\n"
+                               "(mRNA IDs extended by :SNP ID); the mutations are applied on one thread per processor\n");
    /*****************************\ 
   | Parse command line arguments: |
    \*****************************/
@@ -139,126 +785,326 @@ int main(int argc, char * argv[])
     std::cout << help;
     return 1;
   } // help requested
-  else if(argc < 6) // bad call
+  else if(argc >= 3 && std::string(argv[1]) == "index") // indexing requested
+  {
+    bool indexed(true);
+    for(int path_index(2);path_index<argc;++path_index)
+    {
+      indexed = sequenceFileIndex::build(argv[path_index]) && indexed;
+    }
+    return indexed ? 0 : 1;
+  } // indexing requested
+  else if(argc == 4 && std::string(argv[1]) == "build-db") // database creation requested
+  {
+    return sequenceDatabase::build(argv[2],argv[3]) ? 0 : 1;
+  } // database creation requested
+  else if(argc == 4 && std::string(argv[1]) == "convert-conservation") // track creation requested
+  {
+    return conservationList::convert(argv[2],argv[3]) ? 0 : 1;
+  } // track creation requested
+  else if(argc == 5 && std::string(argv[1]) == "export") // export requested
+  {
+    return export_mutated_transcripts(argv[2],argv[3],argv[4]);
+  } // export requested
+  else if(argc >= 2 && std::string(argv[1]) == "merge") // merge requested
+  {
+    return merge_outputs(argc-2,argv+2);
+  } // merge requested
+  else if(argc == 4 && std::string(argv[1]) == "client") // client requested
+  {
+     /************************************************************\ 
+    | Send the lines of the prediction file to the server printing |
+    | the answers in input order:                                  |
+     \************************************************************/
+    lineReader file(argv[3]);
+    if(!file.is_open())
+    {
+      std::cerr << "microSNPscore::\n";
+      std::cerr << " ==> Cannot open file to read from: ";
+      std::cerr << argv[3] << std::endl;
+      std::cerr << "  --> no predictions will be read from the file\n";
+      return 1;
+    }
+    socketClient client(argv[2]);
+    lineSource source(file);
+    resultWriter writer;
+    return client.run(source,writer) && writer.flush() ? 0 : 1;
+  } // client requested
+  else if(argc < (argc >= 2 && std::string(argv[1]) == "serve" ? 7 : 6)) // bad call
   {
     std::cerr << usage;
     return 0;
   } // bad call
   else // good call
   {
-    std::string mRNA_file_path(argv[1]);
-    std::string miRNA_file_path(argv[2]);
-    std::string conservation_file_path(argv[3]);
-    std::string SNP_file_path(argv[4]);
-    std::string prediction_file_path(argv[5]);
-    const bool verbose = (argc>6 && (std::string(argv[6]) == "-v" || std::string(argv[6]) == "--verbose"));
+    const bool serve(std::string(argv[1]) == "serve");
+    const int first_arg(serve ? 2 : 1);
+    std::string mRNA_file_path(argv[first_arg]);
+    std::string miRNA_file_path(argv[first_arg+1]);
+    std::string conservation_file_path(argv[first_arg+2]);
+    std::string SNP_file_path(argv[first_arg+3]);
+    std::string prediction_file_path(argv[first_arg+4]);
+    bool verbose(false);
+    unsigned short thread_count(1);
+    unsigned long flush_every(0);
+    bool exact_scores(false);
+    bool discover(false);
+    predictionShard shard = {1,1,0};
+    std::string output_file_path;
+    std::string checkpoint_file_path;
+    unsigned long checkpoint_every(1000);
+    bool resume(false);
+    std::string genome_file_path;
+    for(int arg_index(first_arg+5);arg_index<argc;++arg_index)
+    {
+      const std::string option(argv[arg_index]);
+      if(option == "-v" || option == "--verbose")
+      {
+        verbose = true;
+      }
+      else if(option == "--threads" && arg_index+1 < argc)
+      {
+         /**************************************************************\ 
+        | Accept digits only (an unsigned extraction would wrap negative |
+        | counts around) and use at most four workers per processor:     |
+         \**************************************************************/
+        const std::string thread_argument(argv[++arg_index]);
+        const unsigned long max_thread_count(4ul * processor_count());
+        const unsigned long requested_thread_count(thread_argument.find_first_not_of("0123456789") == std::string::npos ?
+                                                   strtoul(thread_argument.c_str(),NULL,10) : 0);
+        if(requested_thread_count == 0)
+        {
+          std::cerr << "microSNPscore::\n";
+          std::cerr << " ==> Invalid thread count: ";
+          std::cerr << thread_argument << std::endl;
+          std::cerr << "  --> it must be a positive integer\n";
+          std::cerr << usage;
+          return 0;
+        }
+        if(requested_thread_count > max_thread_count)
+        {
+          std::cerr << "microSNPscore::\n";
+          std::cerr << " ==> Thread count exceeds four per processor: ";
+          std::cerr << thread_argument << std::endl;
+          std::cerr << "  --> using " << max_thread_count << " threads instead\n";
+        }
+        thread_count = std::min(requested_thread_count,max_thread_count);
+      }
+      else if(option == "--flush-every" && arg_index+1 < argc)
+      {
+        std::istringstream stream_flush_every(argv[++arg_index]);
+        if(!(stream_flush_every >> flush_every))
+        {
+          std::cerr << "microSNPscore: invalid flush interval: " << argv[arg_index] << std::endl;
+          std::cerr << usage;
+          return 0;
+        }
+      }
+      else if(option == "--exact-scores")
+      {
+        exact_scores = true;
+      }
+      else if(option == "--discover-SNPs")
+      {
+        discover = true;
+      }
+      else if(option == "--shard" && arg_index+1 < argc)
+      {
+        std::istringstream stream_shard(argv[++arg_index]);
+        char separator(0);
+        if(!(stream_shard >> shard.index >> separator >> shard.count) || separator != '/' || !stream_shard.eof() ||
+           shard.index == 0 || shard.index > shard.count)
+        {
+          std::cerr << "microSNPscore: invalid shard: " << argv[arg_index] << std::endl;
+          std::cerr << usage;
+          return 0;
+        }
+      }
+      else if(option == "--output" && arg_index+1 < argc)
+      {
+        output_file_path = argv[++arg_index];
+      }
+      else if(option == "--checkpoint" && arg_index+1 < argc)
+      {
+        checkpoint_file_path = argv[++arg_index];
+      }
+      else if(option == "--checkpoint-every" && arg_index+1 < argc)
+      {
+        std::istringstream stream_checkpoint_every(argv[++arg_index]);
+        if(!(stream_checkpoint_every >> checkpoint_every))
+        {
+          std::cerr << "microSNPscore: invalid checkpoint interval: " << argv[arg_index] << std::endl;
+          std::cerr << usage;
+          return 0;
+        }
+      }
+      else if(option == "--resume")
+      {
+        resume = true;
+      }
+      else if(option == "--genome" && arg_index+1 < argc)
+      {
+        genome_file_path = argv[++arg_index];
+      }
+      else
+      {
+        std::cerr << "microSNPscore: unknown option: " << option << std::endl;
+        std::cerr << usage;
+        return 0;
+      }
+    } // arg_index
+    if((!checkpoint_file_path.empty() && output_file_path.empty()) || (resume && checkpoint_file_path.empty()))
+    {
+      std::cerr << "microSNPscore: --checkpoint needs --output and --resume needs --checkpoint" << std::endl;
+      std::cerr << usage;
+      return 0;
+    }
+     /*****************************************************************\ 
+    | Read the checkpoint to resume from (starting over if there is     |
+    | none yet) and open the output file cutting it to the length       |
+    | recorded, stating an error if they do not fit the prediction file |
+    | or cannot be used:                                                |
+     \*****************************************************************/
+    checkpoint start = {0,0,lineReader(prediction_file_path).get_size()};
+    if(resume && access(checkpoint_file_path.c_str(),F_OK) == 0)
+    {
+      const off_t input_size(start.input_size);
+      if(!read_checkpoint(start,checkpoint_file_path) || start.input_size != input_size || start.input_offset > input_size)
+      {
+        std::cerr << "microSNPscore::\n";
+        std::cerr << " ==> Cannot resume from checkpoint: ";
+        std::cerr << checkpoint_file_path << std::endl;
+        std::cerr << "  --> it is unreadable or does not belong to the prediction file\n";
+        return 1;
+      }
+      shard.resume_offset = start.input_offset;
+      if(verbose){std::cerr << "microSNPscore: Resuming at prediction file offset " << static_cast<long long>(start.input_offset) << std::endl;}
+    }
+    int output_fd(1);
+    if(!output_file_path.empty())
+    {
+      output_fd = open(output_file_path.c_str(),O_WRONLY | O_CREAT | (start.input_offset == 0 ? O_TRUNC : 0),0644);
+      if(output_fd < 0 || (start.input_offset != 0 && (lineReader(output_file_path).get_size() < start.output_length ||
+                                                       ftruncate(output_fd,start.output_length) != 0 || lseek(output_fd,0,SEEK_END) < 0)))
+      {
+        std::cerr << "microSNPscore::\n";
+        std::cerr << " ==> Cannot open output file to write to: ";
+        std::cerr << output_file_path << std::endl;
+        std::cerr << "  --> it cannot be created or is shorter than recorded in the checkpoint\n";
+        return 1;
+      }
+    }
      /***************************\ 
     | Read data from input files: |
      \***************************/
     if(verbose){std::cerr << "microSNPscore: Reading input files..." << std::endl;}
-    std::map<sequenceID,mRNA> mRNAs;
-    std::map<sequenceID,miRNA> miRNAs;
-    std::map<SNPID,SNP> SNPs;
+    entityTable<sequenceID,mRNA> mRNAs;
+    entityTable<sequenceID,miRNA> miRNAs;
+    entityTable<SNPID,SNP> SNPs;
     if(verbose){std::cerr << "microSNPscore: ...mRNA file: " << mRNA_file_path << std::endl
                           << "microSNPscore: ...miRNA file: " << miRNA_file_path << std::endl
                           << "microSNPscore: ...conservation file: " << conservation_file_path << std::endl
                           << "microSNPscore: ...SNP file: " << SNP_file_path << std::endl;}
-    read_sequences(mRNAs,mRNA_file_path,miRNAs,miRNA_file_path,conservation_file_path,verbose);
-    read_SNPs(SNPs,SNP_file_path);
+     /****************************************************************\ 
+    | Collect the IDs referenced by the predictions first to only load |
+    | the sequences and SNPs needed (everything is loaded if the file  |
+    | cannot be scanned, leaving the error to the prediction reading,  |
+    | or if predictions are served):                                   |
+     \****************************************************************/
+    predictionReferences references;
+    const bool scanned(!serve && scan_predictions(references,prediction_file_path,shard,discover));
+    if(verbose && scanned){std::cerr << "microSNPscore: ...prediction file references " << references.mRNAs.size() << " mRNAs, "
+                                     << references.miRNAs.size() << " miRNAs and " << references.SNPs.size() << " SNPs" << std::endl;}
+    read_sequences(mRNAs,mRNA_file_path,miRNAs,miRNA_file_path,verbose,scanned ? &references.mRNAs : NULL,scanned ? &references.miRNAs : NULL,genome_file_path);
+     /**************************************************************\ 
+    | Open the conservation keeping only the ranges overlapping the  |
+    | exons of the mRNAs read (its scores are only looked up for the |
+    | mRNA nucleotides of the alignments scored):                    |
+     \**************************************************************/
+    genomicRegions mRNA_regions;
+    for(entityID mRNA_ID(0);mRNA_ID!=mRNAs.size();++mRNA_ID)
+    {
+      mRNA_regions.add(mRNAs[mRNA_ID]);
+    }
+    const conservationList conservations(conservation_file_path,&mRNA_regions);
+    read_SNPs(SNPs,SNP_file_path,scanned && !discover ? &references : NULL);
     if(verbose){std::cerr << "microSNPscore: ...successfully read " << mRNAs.size() << " mRNA sequences" << std::endl
                           << "microSNPscore: ...successfully read " << miRNAs.size() << " miRNA sequences" << std::endl
                           << "microSNPscore: ...successfully read " << SNPs.size() << " SNP datasets" << std::endl;}
+    if(serve)
+    {
+       /***************************************************************\ 
+      | Answer the prediction lines sent to the socket keeping the data |
+      | loaded (wildtype scores are calculated per request):            |
+       \***************************************************************/
+      const SNPIndex * const index(discover ? new SNPIndex(SNPs) : NULL);
+      const wildtypeScoreTable no_wildtype_scores;
+      predictionTask task(mRNAs,miRNAs,SNPs,conservations,no_wildtype_scores,exact_scores,verbose,index);
+      socketServer server(task,prediction_file_path);
+      if(verbose){std::cerr << "microSNPscore: Serving predictions on socket " << prediction_file_path << "..." << std::endl;}
+      const bool served(server.run());
+      delete index;
+      return served ? 0 : 1;
+    } // serve
      /**************************************************\ 
     | Iterate over the predictions printing the original |
     | line followed by the deregulation score:           |
      \**************************************************/
-     /********************************************************\ 
-    | Try to open an input file stream associated to the given |
-    | file path stating an error in the case of failure:       |
-     \********************************************************/
-    std::ifstream file(prediction_file_path.c_str());
-    if(file.fail())
+     /*************************************************\ 
+    | Try to open a line reader for the given file path |
+    | stating an error in the case of failure:          |
+     \*************************************************/
+    lineReader file(prediction_file_path);
+    if(!file.is_open())
     {
       std::cerr << "microSNPscore::\n";
       std::cerr << " ==> Cannot open file to read from: ";
       std::cerr << prediction_file_path << std::endl;
       std::cerr << "  --> no predictions will be read from the file\n";
     }
+    else if(!select_shard(file,shard))
+    {
+      std::cerr << "microSNPscore::\n";
+      std::cerr << " ==> Cannot seek to shard " << shard.index << "/" << shard.count << " of file: ";
+      std::cerr << prediction_file_path << std::endl;
+      std::cerr << "  --> no predictions will be read from the file\n";
+      return 1;
+    }
     else
     {
-       /**************************************************************\ 
-      | Try to initialize extended regular expression matching a valid |
-      | prediction file line stating error in case of failure:         |
-       \**************************************************************/
-      regex_t line_regex;
-      char line_pattern[] = "^([^\t]+)\t([^\t]+)\t([[:digit:]]+)\t([^\t]+)$";
-      int error_code = regcomp(&line_regex,line_pattern,REG_EXTENDED);
-      if(error_code != 0)
+       /***************************************************************\ 
+      | Score every target site affected by a SNP once with a pool of   |
+      | workers first, then score the lines of the file reusing these   |
+      | wildtype scores so that only the mutants are left to be scored, |
+      | printing the results in input order (saving checkpoints on the  |
+      | way if requested):                                              |
+       \***************************************************************/
+      const SNPIndex * const index(discover ? new SNPIndex(SNPs) : NULL);
+      wildtypeScoreTable wildtype_scores;
+      collect_sites(wildtype_scores,prediction_file_path,shard,mRNAs,miRNAs,SNPs,index);
+      if(verbose){std::cerr << "microSNPscore: Calculating " << wildtype_scores.sites.size() << " wildtype scores..." << std::endl;}
+      wildtypeTask wildtype_task(mRNAs,miRNAs,conservations,wildtype_scores,verbose);
+      siteSource sites(wildtype_scores);
+      workerPool wildtype_pool(wildtype_task,thread_count);
+      if(!wildtype_pool.run(sites,sites))
       {
-        std::cerr << "microSNPscore::\n";
-        std::cerr << " ==> compiling line regular expression failed:\n";
-        const size_t error_len(regerror(error_code,&line_regex,NULL,0));
-        char error_message[error_len];
-        regerror(error_code,&line_regex,error_message,error_len);
-        std::cerr << error_message << std::endl;
-        std::cerr << "  --> no predictions will be read from the file\n";
+        delete index;
+        return 1;
       }
-      else
+      predictionTask task(mRNAs,miRNAs,SNPs,conservations,wildtype_scores,exact_scores,verbose,index);
+      std::deque<off_t> line_ends;
+      lineSource source(file,checkpoint_file_path.empty() ? NULL : &line_ends);
+      resultWriter writer(output_fd,flush_every);
+      checkpointSink checkpoints(writer,output_fd,line_ends,checkpoint_file_path,start,checkpoint_every);
+      workerPool pool(task,thread_count);
+      const bool scored(checkpoint_file_path.empty() ? pool.run(source,writer) && writer.flush() :
+                                                       pool.run(source,checkpoints) && checkpoints.save());
+      delete index;
+      if(!scored)
       {
-         /**************************************************************\ 
-        | Read the content of the file linewise into a string and try to |
-        | match the initialized regular expression stating error in case |
-        | of failure:                                                    |
-         \**************************************************************/
-        std::string line_string;
-        size_t line_nmatch(5);
-        regmatch_t line_pmatch[line_nmatch];
-        while(getline(file,line_string).good())
-        {
-          if(verbose){std::cerr << "microSNPscore: Reading prediction..." << std::endl;}
-          error_code = regexec(&line_regex,line_string.c_str(),line_nmatch,line_pmatch,0);
-          if(error_code != 0)
-          {
-                std::cerr << "microSNPscore::read_predictions\n";
-                std::cerr << " ==> no valid prediction file line:\n";
-                std::cerr << line_string << std::endl;
-                std::cerr << "     error message:\n";
-                const size_t error_len(regerror(error_code,&line_regex,NULL,0));
-                char error_message[error_len];
-                regerror(error_code,&line_regex,error_message,error_len);
-                std::cerr << error_message << std::endl;
-                std::cerr << "  --> omitting line\n";
-          }
-          else
-          {
-             /*****************************************************************\ 
-            | Extract the subsequences matching the regular expression's groups |
-            | from the line assigning them to the corresponding parameters      |
-            | (converting them via a stringstream) to create a prediction:      |
-             \*****************************************************************/
-            sequenceID miRNA(line_string.substr(line_pmatch[1].rm_so,line_pmatch[1].rm_eo-line_pmatch[1].rm_so));
-            sequenceID mRNA(line_string.substr(line_pmatch[2].rm_so,line_pmatch[2].rm_eo-line_pmatch[2].rm_so));
-            chromosomePosition three_prime;
-            std::istringstream stream_three_prime(line_string.substr(line_pmatch[3].rm_so,line_pmatch[3].rm_eo-line_pmatch[3].rm_so));
-            stream_three_prime >> three_prime;
-            SNPID SNP(line_string.substr(line_pmatch[4].rm_so,line_pmatch[4].rm_eo-line_pmatch[4].rm_so));
-            if(verbose){std::cerr << "microSNPscore: ...miRNA ID: " << miRNA << std::endl
-                                  << "microSNPscore: ...mRNA ID: " << mRNA << std::endl
-                                  << "microSNPscore: ...3' position: " << three_prime << std::endl;}
-             /******************************************\ 
-            | Score the new prediction and print result: |
-             \******************************************/
-            if(verbose){std::cerr << "microSNPscore: Calculating deregulation score..." << std::endl;}
-            std::cout << miRNA << '\t';
-            std::cout << mRNA << '\t';
-            std::cout << three_prime << '\t';
-            std::cout << SNP << '\t';
-            std::cout << SNPs[SNP].get_deregulation_score(miRNAs[miRNA],mRNAs[mRNA],three_prime,verbose) << std::endl;
-            if(verbose){std::cerr << "microSNPscore: ...done" << std::endl;}
-          } // regexec(&line_regex,line_string.c_str(),line_nmatch,line_pmatch,0) == 0
-        } // getline(file,line_string).good()
-      } // regcomp(&line_regex,line_pattern,REG_EXTENDED) == 0
-    } // !file.fail()
+        return 1;
+      }
+    } // file.is_open()
     return 0;
   } // good call
 } // int main
@@ -66,6 +66,8 @@ matchScore matchType::calculate_score(matchIdentifier the_identifier, matchPosit
   }
 }
 
+const conservationOffset nucleotide::unconserved;
+
 /*****************************************************************//**
 * @brief constructor - Do not call without parameter values!
 *
@@ -88,15 +90,18 @@ matchScore matchType::calculate_score(matchIdentifier the_identifier, matchPosit
 *     nucleotide, the 5' end of the + strand (i.e. the 3' end of
 *     the - strand) beeing position 1 (gaps should be given the
 *     position of their predecessor in the alignment) - Defaults to 0
-* @param the_conservation (pseudo-optional) conservation score of the
-*     nucleotide - Defaults to 0
+* @param the_conservation_offset (optional) conservationOffset that
+*     represents the distance between the position on the chromosome
+*     and the position whose conservation the nucleotide has (or
+*     @p unconserved for nucleotides without one, e.g. inserted by a
+*     SNP) - Defaults to 0
 *
 * @return a nucleotide containing the given nucleo base and located at
-*     the given positions on chromosome and in sequence with the given
-*     conservation score
+*     the given positions on chromosome and in sequence with the
+*     conservation of the given position
 *********************************************************************/
-nucleotide::nucleotide(nucleoBase the_base, sequencePosition the_sequence_position, chromosomePosition the_chromosome_position, conservationScore the_conservation)
-:base(the_base),sequence_position(the_sequence_position),chromosome_position(the_chromosome_position),conservation(the_conservation) {
+nucleotide::nucleotide(nucleoBase the_base, sequencePosition the_sequence_position, chromosomePosition the_chromosome_position, conservationOffset the_conservation_offset)
+:base(the_base),sequence_position(the_sequence_position),conservation_offset(the_conservation_offset),chromosome_position(the_chromosome_position) {
 }
 
     /*****************************************************************//**
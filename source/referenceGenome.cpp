@@ -0,0 +1,188 @@
+#include <iostream>
+//for std::cerr and std::endl (error stating)
+#include <algorithm>
+//for std::min (line rests)
+#include <string.h>
+//for strerror (error stating)
+#include <errno.h>
+//for errno (error stating)
+#include <unistd.h>
+//for close (file access)
+#include <fcntl.h>
+//for open (file access)
+#include <sys/mman.h>
+//for mmap, madvise and munmap (file mapping)
+#include <sys/stat.h>
+//for fstat (file size)
+#include "referenceGenome.h"
+#include "lineReader.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief offset field conversion
+    *
+    * This is used to convert a field consisting of decimal digits only
+    * to a file offset (which may exceed the range of a
+    * chromosomePosition for large genomes).
+    *
+    * @param field const fieldView reference to the field
+    * @param offset off_t reference the value is assigned to
+    *
+    * @return true if the field is a non-empty digit string of a value
+    *     not exceeding 2^62, false otherwise
+    *********************************************************************/
+    static bool parse_offset(const fieldView & field, off_t & offset) {
+      if(field.begin == field.end)
+      {
+        return false;
+      }
+      offset = 0;
+      for(const char * char_it(field.begin);char_it!=field.end;++char_it)
+      {
+        if(*char_it < '0' || *char_it > '9' || offset > (off_t(1) << 62) / 10)
+        {
+          return false;
+        }
+        offset = offset * 10 + (*char_it - '0');
+      }
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to open an indexed genome FASTA file.
+    * If the file or its index (the file path followed by .fai) cannot be
+    * read or they do not fit each other an error is raised and the
+    * genome is created but won't return any bases (see @p is_open).
+    *
+    * @param the_path filePath to the genome FASTA file
+    *
+    * @return referenceGenome for the given file
+    *
+    * @see is_open()
+    *********************************************************************/
+    referenceGenome::referenceGenome(const filePath & the_path)
+    :path(the_path),chromosomes(),mapping(NULL),mapping_size(0) {
+       /***************************************************************\ 
+      | Try to map the whole genome file read-only (expecting scattered |
+      | accesses) stating an error in the case of failure:              |
+       \***************************************************************/
+      const int fd(open(path.c_str(),O_RDONLY));
+      struct stat file_status;
+      void * the_mapping(MAP_FAILED);
+      const char * reason("empty file");
+      if(fd < 0 || fstat(fd,&file_status) != 0)
+      {
+        reason = strerror(errno);
+      }
+      else if(file_status.st_size > 0)
+      {
+        the_mapping = mmap(NULL,file_status.st_size,PROT_READ,MAP_SHARED,fd,0);
+        reason = strerror(errno);
+      }
+      if(the_mapping == MAP_FAILED)
+      {
+        std::cerr << "microSNPscore::referenceGenome::referenceGenome\n";
+        std::cerr << " ==> Cannot map genome: ";
+        std::cerr << path << ": " << reason << std::endl;
+        std::cerr << "  --> no sequences will be taken from the genome\n";
+        if(fd >= 0)
+        {
+          close(fd);
+        }
+        return;
+      }
+      close(fd);
+      madvise(the_mapping,file_status.st_size,MADV_RANDOM);
+      mapping = static_cast<const char *>(the_mapping);
+      mapping_size = file_status.st_size;
+       /****************************************************************\ 
+      | Read the index line by line making sure every chromosome lies    |
+      | inside the genome file and unmap the file if the index cannot be |
+      | read or does not fit it:                                         |
+       \****************************************************************/
+      lineReader index_file(path + ".fai");
+      bool valid(index_file.is_open());
+      fieldView line;
+      fieldView fields[5];
+      while(valid && index_file.next_line(line))
+      {
+        genomeIndexEntry entry;
+        valid = lineReader::split_fields(line,fields,5) && fields[0].begin != fields[0].end &&
+                lineReader::parse_position(fields[1],entry.length) && parse_offset(fields[2],entry.offset) &&
+                parse_offset(fields[3],entry.line_bases) && parse_offset(fields[4],entry.line_width) &&
+                entry.line_bases > 0 && entry.line_width > entry.line_bases &&
+                (entry.length == 0 || entry.offset + (entry.length - 1) / entry.line_bases * entry.line_width +
+                                      (entry.length - 1) % entry.line_bases < off_t(mapping_size));
+        if(valid)
+        {
+          chromosomes[chromosomeType(fields[0].begin,fields[0].end)] = entry;
+        }
+      }
+      if(!valid)
+      {
+        std::cerr << "microSNPscore::referenceGenome::referenceGenome\n";
+        std::cerr << " ==> no valid FASTA index of the genome: ";
+        std::cerr << path << ".fai" << std::endl;
+        std::cerr << "  --> no sequences will be taken from the genome (index it with samtools faidx)\n";
+        munmap(const_cast<char *>(mapping),mapping_size);
+        mapping = NULL;
+        mapping_size = 0;
+        chromosomes.clear();
+      }
+}
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to unmap the genome file.
+    *********************************************************************/
+    referenceGenome::~referenceGenome() {
+      if(mapping != NULL)
+      {
+        munmap(const_cast<char *>(mapping),mapping_size);
+      }
+}
+
+    /*****************************************************************//**
+    * @brief base extraction
+    *
+    * This method is used to append the (+ strand) bases of a range of a
+    * chromosome to a string as they are written in the genome file.
+    *
+    * @param bases std::string reference the bases are appended to
+    * @param chromosome const chromosomeType reference to the chromosome
+    * @param start chromosomePosition of the first base of the range
+    *     (counted from 1)
+    * @param end chromosomePosition of the last base of the range
+    *
+    * @return true if the bases were appended, false if the chromosome is
+    *     not in the genome or the range is not on it
+    *********************************************************************/
+    bool referenceGenome::append_bases(std::string & bases, const chromosomeType & chromosome, chromosomePosition start, chromosomePosition end) const {
+      const std::map<chromosomeType,genomeIndexEntry>::const_iterator chromosome_it(chromosomes.find(chromosome));
+      if(chromosome_it == chromosomes.end() || start == 0 || start > end || end > chromosome_it->second.length)
+      {
+        return false;
+      }
+       /***************************************************************\ 
+      | Copy the bases line by line from the mapping, starting with the |
+      | rest of the line containing the first base of the range:        |
+       \***************************************************************/
+      const genomeIndexEntry & entry(chromosome_it->second);
+      off_t base(start - 1);
+      off_t remaining(end - start + 1);
+      while(remaining != 0)
+      {
+        const off_t line_rest(std::min(remaining,entry.line_bases - base % entry.line_bases));
+        bases.append(mapping + entry.offset + base / entry.line_bases * entry.line_width + base % entry.line_bases,line_rest);
+        base += line_rest;
+        remaining -= line_rest;
+      }
+      return true;
+}
+
+
+} // namespace microSNPscore
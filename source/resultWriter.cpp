@@ -0,0 +1,521 @@
+#include <iostream>
+//for std::cerr and std::endl (error stating)
+#include <stdio.h>
+//for snprintf (score formatting)
+#include <stdint.h>
+//for uint32_t and uint64_t (shortest score digits)
+#include <string.h>
+//for memcpy and strerror (buffering and error stating)
+#include <unistd.h>
+//for write (output)
+#include <errno.h>
+//for errno (interrupted writes)
+#include "resultWriter.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief binary floating point number
+    *
+    * This represents the value significand * 2^exponent with a 64 bit
+    * significand. It is used to generate the shortest digits of scores.
+    *********************************************************************/
+    struct binaryFloat {
+        /*****************************************************************//**
+        * @brief significand
+        *********************************************************************/
+        uint64_t significand;
+
+        /*****************************************************************//**
+        * @brief binary exponent
+        *********************************************************************/
+        int exponent;
+
+    };
+
+    /*****************************************************************//**
+    * @brief cached power significands
+    *
+    * These are the normalized 64 bit significands of the powers of ten
+    * from 10^-348 to 10^340 in steps of 8 (rounded to nearest).
+    *********************************************************************/
+    static const uint64_t cached_power_significands[] = {
+      0xfa8fd5a0081c0288ULL,0xbaaee17fa23ebf76ULL,0x8b16fb203055ac76ULL,
+      0xcf42894a5dce35eaULL,0x9a6bb0aa55653b2dULL,0xe61acf033d1a45dfULL,
+      0xab70fe17c79ac6caULL,0xff77b1fcbebcdc4fULL,0xbe5691ef416bd60cULL,
+      0x8dd01fad907ffc3cULL,0xd3515c2831559a83ULL,0x9d71ac8fada6c9b5ULL,
+      0xea9c227723ee8bcbULL,0xaecc49914078536dULL,0x823c12795db6ce57ULL,
+      0xc21094364dfb5637ULL,0x9096ea6f3848984fULL,0xd77485cb25823ac7ULL,
+      0xa086cfcd97bf97f4ULL,0xef340a98172aace5ULL,0xb23867fb2a35b28eULL,
+      0x84c8d4dfd2c63f3bULL,0xc5dd44271ad3cdbaULL,0x936b9fcebb25c996ULL,
+      0xdbac6c247d62a584ULL,0xa3ab66580d5fdaf6ULL,0xf3e2f893dec3f126ULL,
+      0xb5b5ada8aaff80b8ULL,0x87625f056c7c4a8bULL,0xc9bcff6034c13053ULL,
+      0x964e858c91ba2655ULL,0xdff9772470297ebdULL,0xa6dfbd9fb8e5b88fULL,
+      0xf8a95fcf88747d94ULL,0xb94470938fa89bcfULL,0x8a08f0f8bf0f156bULL,
+      0xcdb02555653131b6ULL,0x993fe2c6d07b7facULL,0xe45c10c42a2b3b06ULL,
+      0xaa242499697392d3ULL,0xfd87b5f28300ca0eULL,0xbce5086492111aebULL,
+      0x8cbccc096f5088ccULL,0xd1b71758e219652cULL,0x9c40000000000000ULL,
+      0xe8d4a51000000000ULL,0xad78ebc5ac620000ULL,0x813f3978f8940984ULL,
+      0xc097ce7bc90715b3ULL,0x8f7e32ce7bea5c70ULL,0xd5d238a4abe98068ULL,
+      0x9f4f2726179a2245ULL,0xed63a231d4c4fb27ULL,0xb0de65388cc8ada8ULL,
+      0x83c7088e1aab65dbULL,0xc45d1df942711d9aULL,0x924d692ca61be758ULL,
+      0xda01ee641a708deaULL,0xa26da3999aef774aULL,0xf209787bb47d6b85ULL,
+      0xb454e4a179dd1877ULL,0x865b86925b9bc5c2ULL,0xc83553c5c8965d3dULL,
+      0x952ab45cfa97a0b3ULL,0xde469fbd99a05fe3ULL,0xa59bc234db398c25ULL,
+      0xf6c69a72a3989f5cULL,0xb7dcbf5354e9beceULL,0x88fcf317f22241e2ULL,
+      0xcc20ce9bd35c78a5ULL,0x98165af37b2153dfULL,0xe2a0b5dc971f303aULL,
+      0xa8d9d1535ce3b396ULL,0xfb9b7cd9a4a7443cULL,0xbb764c4ca7a44410ULL,
+      0x8bab8eefb6409c1aULL,0xd01fef10a657842cULL,0x9b10a4e5e9913129ULL,
+      0xe7109bfba19c0c9dULL,0xac2820d9623bf429ULL,0x80444b5e7aa7cf85ULL,
+      0xbf21e44003acdd2dULL,0x8e679c2f5e44ff8fULL,0xd433179d9c8cb841ULL,
+      0x9e19db92b4e31ba9ULL,0xeb96bf6ebadf77d9ULL,0xaf87023b9bf0ee6bULL
+    };
+
+    /*****************************************************************//**
+    * @brief cached power exponents
+    *
+    * These are the binary exponents belonging to the cached power
+    * significands.
+    *********************************************************************/
+    static const int cached_power_exponents[] = {
+      -1220,-1193,-1166,-1140,-1113,-1087,-1060,-1034,-1007,-980,-954,-927,
+      -901,-874,-847,-821,-794,-768,-741,-715,-688,-661,-635,-608,
+      -582,-555,-529,-502,-475,-449,-422,-396,-369,-343,-316,-289,
+      -263,-236,-210,-183,-157,-130,-103,-77,-50,-24,3,30,
+      56,83,109,136,162,189,216,242,269,295,322,348,
+      375,402,428,455,481,508,534,561,588,614,641,667,
+      694,720,747,774,800,827,853,880,907,933,960,986,
+      1013,1039,1066
+    };
+
+    /*****************************************************************//**
+    * @brief powers of ten
+    *
+    * These are the powers of ten fitting into 64 bits.
+    *********************************************************************/
+    static const uint64_t powers_of_ten[] = {
+      1ULL,10ULL,100ULL,1000ULL,10000ULL,100000ULL,1000000ULL,10000000ULL,100000000ULL,1000000000ULL,
+      10000000000ULL,100000000000ULL,1000000000000ULL,10000000000000ULL,100000000000000ULL,
+      1000000000000000ULL,10000000000000000ULL,100000000000000000ULL,1000000000000000000ULL,
+      10000000000000000000ULL
+    };
+
+    /*****************************************************************//**
+    * @brief binary floating point multiplication
+    *
+    * This is used to multiply two binary floating point numbers keeping
+    * the upper 64 bits of the product's significand (rounded).
+    *
+    * @param factor1 const binaryFloat reference to the first factor
+    * @param factor2 const binaryFloat reference to the second factor
+    *
+    * @return the rounded product
+    *********************************************************************/
+    static binaryFloat multiply(const binaryFloat & factor1, const binaryFloat & factor2) {
+       /*********************************************************\ 
+      | Multiply the 32 bit halves and sum up the upper part of   |
+      | the 128 bit product (rounding at the dropped lower part): |
+       \*********************************************************/
+      const uint64_t lower_mask(0xffffffffULL);
+      const uint64_t high1(factor1.significand >> 32);
+      const uint64_t low1(factor1.significand & lower_mask);
+      const uint64_t high2(factor2.significand >> 32);
+      const uint64_t low2(factor2.significand & lower_mask);
+      const uint64_t high_high(high1 * high2);
+      const uint64_t low_high(low1 * high2);
+      const uint64_t high_low(high1 * low2);
+      const uint64_t low_low(low1 * low2);
+      const uint64_t middle((low_low >> 32) + (high_low & lower_mask) + (low_high & lower_mask) + (1ULL << 31));
+      const binaryFloat product = {high_high + (high_low >> 32) + (low_high >> 32) + (middle >> 32),
+                                   factor1.exponent + factor2.exponent + 64};
+      return product;
+}
+
+    /*****************************************************************//**
+    * @brief last digit rounding
+    *
+    * This is used to move the last generated digit towards the exact
+    * value as long as the digits stay within the rounding interval.
+    *
+    * @param digits char pointer to the digits generated
+    * @param length int representing the number of digits generated
+    * @param delta uint64_t representing the width of the (scaled)
+    *     rounding interval
+    * @param rest uint64_t representing the distance of the digits from
+    *     the upper interval bound
+    * @param ten_kappa uint64_t representing the (scaled) value of one
+    *     unit in the last digit
+    * @param distance uint64_t representing the distance of the exact
+    *     value from the upper interval bound
+    *********************************************************************/
+    static void round_last_digit(char * digits, int length, uint64_t delta, uint64_t rest, uint64_t ten_kappa, uint64_t distance) {
+       /***********************************************************\ 
+      | Decrease the last digit while the result gets closer to the |
+      | exact value without leaving the interval:                   |
+       \***********************************************************/
+      while(rest < distance && delta - rest >= ten_kappa &&
+            (rest + ten_kappa < distance || distance - rest > rest + ten_kappa - distance))
+      {
+        --digits[length - 1];
+        rest += ten_kappa;
+      }
+}
+
+    /*****************************************************************//**
+    * @brief shortest digit generation
+    *
+    * This is used to generate the shortest decimal digits of a positive
+    * finite double that are read back as the same value with the Grisu2
+    * algorithm (F. Loitsch, Printing floating-point numbers quickly and
+    * accurately with integers, PLDI 2010). The digits are the shortest
+    * ones within a slightly narrowed rounding interval, which yields
+    * the shortest representation in nearly all cases and never one
+    * that is not read back exactly.
+    *
+    * @param value double to generate the digits of (positive and finite)
+    * @param digits char pointer to a buffer for at least 18 digits
+    * @param length int reference the number of digits is assigned to
+    * @param decimal_exponent int reference the decimal exponent of the
+    *     last digit is assigned to
+    *********************************************************************/
+    static void shortest_digits(double value, char * digits, int & length, int & decimal_exponent) {
+       /*******************************************************\ 
+      | Decompose the value and determine the boundaries of its |
+      | rounding interval (normalized to the same exponent):    |
+       \*******************************************************/
+      uint64_t bits;
+      memcpy(&bits,&value,sizeof(bits));
+      const uint64_t hidden_bit(1ULL << 52);
+      const int biased_exponent(int((bits >> 52) & 0x7ff));
+      binaryFloat exact = {bits & (hidden_bit - 1),biased_exponent == 0 ? -1074 : biased_exponent - 1075};
+      if(biased_exponent != 0)
+      {
+        exact.significand |= hidden_bit;
+      }
+      binaryFloat upper = {(exact.significand << 1) + 1,exact.exponent - 1};
+      while((upper.significand & (hidden_bit << 1)) == 0)
+      {
+        upper.significand <<= 1;
+        --upper.exponent;
+      }
+      upper.significand <<= 10;
+      upper.exponent -= 10;
+      const bool closer_lower(exact.significand == hidden_bit);
+      binaryFloat lower = {closer_lower ? (exact.significand << 2) - 1 : (exact.significand << 1) - 1,
+                           closer_lower ? exact.exponent - 2 : exact.exponent - 1};
+      lower.significand <<= lower.exponent - upper.exponent;
+      lower.exponent = upper.exponent;
+      while((exact.significand & (1ULL << 63)) == 0)
+      {
+        exact.significand <<= 1;
+        --exact.exponent;
+      }
+       /**************************************************************\ 
+      | Scale everything by a cached power of ten so that the upper    |
+      | bound's exponent lies within [-60,-32] and narrow the interval |
+      | by one unit on both sides to account for the rounding errors:  |
+       \**************************************************************/
+      const double approximate_k((-61 - upper.exponent) * 0.30102999566398114 + 347);
+      int k(static_cast<int>(approximate_k));
+      if(approximate_k - k > 0.0)
+      {
+        ++k;
+      }
+      const unsigned int power_index((k >> 3) + 1);
+      const binaryFloat cached_power = {cached_power_significands[power_index],cached_power_exponents[power_index]};
+      decimal_exponent = -(-348 + static_cast<int>(power_index) * 8);
+      const binaryFloat scaled(multiply(exact,cached_power));
+      binaryFloat scaled_upper(multiply(upper,cached_power));
+      binaryFloat scaled_lower(multiply(lower,cached_power));
+      ++scaled_lower.significand;
+      --scaled_upper.significand;
+       /************************************************************\ 
+      | Generate the digits of the upper bound (integral part first, |
+      | then the fractional part) until the rest is within the       |
+      | interval, then round the last digit towards the exact value: |
+       \************************************************************/
+      uint64_t delta(scaled_upper.significand - scaled_lower.significand);
+      const uint64_t distance(scaled_upper.significand - scaled.significand);
+      const int shift(-scaled_upper.exponent);
+      const uint64_t one(1ULL << shift);
+      uint32_t integral(static_cast<uint32_t>(scaled_upper.significand >> shift));
+      uint64_t fractional(scaled_upper.significand & (one - 1));
+      int kappa(1);
+      while(kappa < 10 && integral >= powers_of_ten[kappa])
+      {
+        ++kappa;
+      }
+      length = 0;
+      while(kappa > 0)
+      {
+        const uint32_t digit(static_cast<uint32_t>(integral / powers_of_ten[kappa - 1]));
+        integral %= powers_of_ten[kappa - 1];
+        if(digit != 0 || length != 0)
+        {
+          digits[length++] = char('0' + digit);
+        }
+        --kappa;
+        const uint64_t rest((static_cast<uint64_t>(integral) << shift) + fractional);
+        if(rest <= delta)
+        {
+          decimal_exponent += kappa;
+          round_last_digit(digits,length,delta,rest,powers_of_ten[kappa] << shift,distance);
+          return;
+        }
+      }
+      for(;;)
+      {
+        fractional *= 10;
+        delta *= 10;
+        const char digit(static_cast<char>(fractional >> shift));
+        if(digit != 0 || length != 0)
+        {
+          digits[length++] = char('0' + digit);
+        }
+        fractional &= one - 1;
+        --kappa;
+        if(fractional < delta)
+        {
+          decimal_exponent += kappa;
+          round_last_digit(digits,length,delta,fractional,one,-kappa < 20 ? distance * powers_of_ten[-kappa] : 0);
+          return;
+        }
+      }
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a resultWriter for a given file descriptor.
+    * The file descriptor is not closed by the writer.
+    *
+    * @param the_fd (optional) int representing the file descriptor to
+    *     write to - Defaults to 1 (STDOUT)
+    * @param the_flush_every (optional) unsigned long representing the
+    *     number of results after which the buffer is written even if it
+    *     is not full (0 means only full buffers are written) - Defaults
+    *     to 0
+    * @param the_buffer_size (optional) size_t representing the size of
+    *     the buffer - Defaults to 1 MiB
+    *
+    * @return resultWriter for the given file descriptor
+    *********************************************************************/
+    resultWriter::resultWriter(int the_fd, unsigned long the_flush_every, size_t the_buffer_size)
+    :fd(the_fd),flush_every(the_flush_every),buffer(std::vector<char>(the_buffer_size == 0 ? 1 : the_buffer_size)),filled(0),buffered_results(0),written(0),write_failed(false) {
+}
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to write the remaining buffer content before
+    * destroying the writer.
+    *********************************************************************/
+    resultWriter::~resultWriter() {
+      flush();
+}
+
+    /*****************************************************************//**
+    * @brief result insertion
+    *
+    * This method is used to append a result (one or more complete
+    * lines) to the buffer writing the buffer if it is full or if the
+    * number of results given at construction was reached.
+    * Empty results are ignored.
+    *
+    * @param result const std::string reference to the result
+    *********************************************************************/
+    void resultWriter::put_result(const std::string & result) {
+       /*************************************************************\ 
+      | Write the buffer first if the result does not fit (results    |
+      | larger than the whole buffer are written directly) and append |
+      | it to the buffer otherwise:                                   |
+       \*************************************************************/
+      if(result.empty())
+      {
+        return;
+      }
+      if(filled + result.size() > buffer.size())
+      {
+        flush();
+      }
+      if(result.size() > buffer.size())
+      {
+        write_block(result.data(),result.size());
+      }
+      else
+      {
+        memcpy(&buffer[filled],result.data(),result.size());
+        filled += result.size();
+      }
+      if(++buffered_results == flush_every)
+      {
+        flush();
+      }
+}
+
+    /*****************************************************************//**
+    * @brief buffer writing
+    *
+    * This method is used to write the buffer content to the file
+    * descriptor.
+    * If writing fails an error is raised (only once) and all further
+    * output is discarded.
+    *
+    * @return true if the buffer was written, false otherwise
+    *********************************************************************/
+    bool resultWriter::flush() {
+      write_block(&buffer[0],filled);
+      filled = 0;
+      buffered_results = 0;
+      return !write_failed;
+}
+
+    /*****************************************************************//**
+    * @brief block writing
+    *
+    * This method is used to write a block of characters to the file
+    * descriptor.
+    * If writing fails an error is raised (only once) and all further
+    * output is discarded.
+    *
+    * @param block const char pointer to the first character to write
+    * @param size size_t representing the number of characters to write
+    *
+    * @return true if the block was written, false otherwise
+    *********************************************************************/
+    bool resultWriter::write_block(const char * block, size_t size) {
+       /*********************************************************\ 
+      | Write the block (retrying interrupted and partial writes) |
+      | stating an error in case of failure:                      |
+       \*********************************************************/
+      size_t done(0);
+      while(!write_failed && done != size)
+      {
+        ssize_t bytes_written(write(fd,block+done,size-done));
+        if(bytes_written > 0)
+        {
+          done += bytes_written;
+        }
+        else if(errno != EINTR)
+        {
+          std::cerr << "microSNPscore::resultWriter::write_block\n";
+          std::cerr << " ==> Cannot write results: ";
+          std::cerr << strerror(errno) << std::endl;
+          std::cerr << "  --> discarding further results\n";
+          write_failed = true;
+        }
+      }
+      written += done;
+      return !write_failed;
+}
+
+    /*****************************************************************//**
+    * @brief position formatting
+    *
+    * This method is used to append the decimal representation of a
+    * chromosome position to a string.
+    *
+    * @param line std::string reference to append to
+    * @param position chromosomePosition to be appended
+    *********************************************************************/
+    void resultWriter::append_position(std::string & line, chromosomePosition position) {
+       /***********************************************************\ 
+      | Fill a small buffer with the digits from its end and append |
+      | the used part:                                              |
+       \***********************************************************/
+      char digits[16];
+      char * digit_it(digits + sizeof(digits));
+      do
+      {
+        *--digit_it = char('0' + position % 10);
+        position /= 10;
+      }
+      while(position != 0);
+      line.append(digit_it,digits + sizeof(digits));
+}
+
+    /*****************************************************************//**
+    * @brief score formatting
+    *
+    * This method is used to append the decimal representation of a
+    * score to a string.
+    * By default the score is represented like an output stream with
+    * default settings would do (6 significant digits) to keep the output
+    * compatible. Otherwise the shortest representation that is read back
+    * as exactly the same value is used (generated with the Grisu2
+    * algorithm, which may exceed the shortest one by a digit in rare
+    * cases).
+    *
+    * @param line std::string reference to append to
+    * @param score double to be appended
+    * @param shortest (optional) bool indicating whether the shortest
+    *     exact representation should be used - Defaults to false
+    *********************************************************************/
+    void resultWriter::append_score(std::string & line, double score, bool shortest) {
+       /************************************************************\ 
+      | Format with the stream default precision unless the shortest |
+      | representation is requested for a finite non-zero score      |
+      | (zero, infinity and NaN are represented alike anyway):       |
+       \************************************************************/
+      if(!shortest || score == 0 || score != score || score - score != 0)
+      {
+        char representation[32];
+        const int length(snprintf(representation,sizeof(representation),"%g",score));
+        line.append(representation,length);
+        return;
+      }
+       /**************************************************************\ 
+      | Generate the shortest digits (dropping trailing zeros) and lay |
+      | them out like printf's %g would with that many significant     |
+      | digits (scientific notation for very small or large scores):   |
+       \**************************************************************/
+      if(score < 0)
+      {
+        line += '-';
+        score = -score;
+      }
+      char digits[24];
+      int length(0);
+      int decimal_exponent(0);
+      shortest_digits(score,digits,length,decimal_exponent);
+      while(length > 1 && digits[length - 1] == '0')
+      {
+        --length;
+        ++decimal_exponent;
+      }
+      const int leading_exponent(length + decimal_exponent - 1);
+      if(leading_exponent < -4 || leading_exponent >= length)
+      {
+        line += digits[0];
+        if(length > 1)
+        {
+          line += '.';
+          line.append(digits + 1,length - 1);
+        }
+        line += 'e';
+        line += leading_exponent < 0 ? '-' : '+';
+        const int exponent_value(leading_exponent < 0 ? -leading_exponent : leading_exponent);
+        if(exponent_value < 10)
+        {
+          line += '0';
+        }
+        append_position(line,exponent_value);
+      }
+      else if(leading_exponent >= 0)
+      {
+        line.append(digits,leading_exponent + 1);
+        if(length > leading_exponent + 1)
+        {
+          line += '.';
+          line.append(digits + leading_exponent + 1,length - leading_exponent - 1);
+        }
+      }
+      else
+      {
+        line += "0.";
+        line.append(-leading_exponent - 1,'0');
+        line.append(digits,length);
+      }
+}
+
+} // namespace microSNPscore
@@ -4,13 +4,217 @@
 #include <sstream>
 //for std::istringstream (type conversion) and std::ostringstream (exon vector << operator)
 #include <algorithm>
-//for std::sort (exon sorting)
+//for std::sort (exon sorting), std::count and std::find (newline skipping) and std::min (block decoding)
+#if defined(__AVX2__)
+#include <immintrin.h>
+//for the AVX2 intrinsics (block decoding)
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+//for the SSE2 intrinsics (block decoding)
+#endif
 #include "sequence.h"
-#include "conservationList.h"
 #include "SNP.h"
 
 namespace microSNPscore {
 
+    /*****************************************************************//**
+    * @brief newline code
+    *
+    * This is the base code of newline characters (which are skipped).
+    * The codes of the valid characters are their nucleoBase values.
+    *********************************************************************/
+    static const unsigned char newline_code(6);
+
+    /*****************************************************************//**
+    * @brief illegal character code
+    *
+    * This is the base code of characters that are neither nucleo bases
+    * nor gaps or newlines.
+    *********************************************************************/
+    static const unsigned char illegal_code(7);
+
+    /*****************************************************************//**
+    * @brief end code
+    *
+    * This is the base code returned behind the end of a sequence.
+    *********************************************************************/
+    static const unsigned char end_code(8);
+
+    /*****************************************************************//**
+    * @brief decoding block size
+    *
+    * This is the number of characters decoded at once.
+    *********************************************************************/
+    static const size_t decoding_block_size(256);
+
+    /*****************************************************************//**
+    * @brief single base decoding
+    *
+    * This is used to convert a single character to its base code.
+    *
+    * @param character char to be converted
+    *
+    * @return the nucleoBase value of the character (Gap for dashes),
+    *     newline_code for newlines or illegal_code for other characters
+    *********************************************************************/
+    static unsigned char base_code(char character) {
+      switch(character)
+      {
+        case 'a':
+        case 'A':
+          return Adenine;
+        case 'c':
+        case 'C':
+          return Cytosine;
+        case 'g':
+        case 'G':
+          return Guanine;
+        case 't':
+        case 'T':
+        case 'u':
+        case 'U':
+          return Uracil;
+        case 'x':
+        case 'X':
+          return Mask;
+        case '-':
+          return Gap;
+        case '\n':
+          return newline_code;
+        default:
+          return illegal_code;
+      }
+}
+
+    /*****************************************************************//**
+    * @brief block decoding
+    *
+    * This is used to convert a range of characters to base codes.
+    * Depending on the instruction sets available at compile time 32
+    * (AVX2) or 16 (SSE2) characters are compared with all valid
+    * characters at once, the remaining characters one by one.
+    *
+    * @param begin const char pointer to the first character
+    * @param end const char pointer behind the last character
+    * @param codes unsigned char pointer to the memory the codes are
+    *     written to (one per character)
+    *********************************************************************/
+    static void decode_bases(const char * begin, const char * end, unsigned char * codes) {
+       /**************************************************************\ 
+      | Combine the codes of the characters matching each valid one    |
+      | (comparing letters in lower case) and set the illegal code for |
+      | those matching none:                                           |
+       \**************************************************************/
+      const char * char_it(begin);
+#if defined(__AVX2__)
+      const __m256i case_bit(_mm256_set1_epi8(0x20));
+      for(;end-char_it >= 32;char_it+=32,codes+=32)
+      {
+        const __m256i characters(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(char_it)));
+        const __m256i lower(_mm256_or_si256(characters,case_bit));
+        const __m256i is_A(_mm256_cmpeq_epi8(lower,_mm256_set1_epi8('a')));
+        const __m256i is_C(_mm256_cmpeq_epi8(lower,_mm256_set1_epi8('c')));
+        const __m256i is_G(_mm256_cmpeq_epi8(lower,_mm256_set1_epi8('g')));
+        const __m256i is_U(_mm256_or_si256(_mm256_cmpeq_epi8(lower,_mm256_set1_epi8('u')),_mm256_cmpeq_epi8(lower,_mm256_set1_epi8('t'))));
+        const __m256i is_X(_mm256_cmpeq_epi8(lower,_mm256_set1_epi8('x')));
+        const __m256i is_gap(_mm256_cmpeq_epi8(characters,_mm256_set1_epi8('-')));
+        const __m256i is_newline(_mm256_cmpeq_epi8(characters,_mm256_set1_epi8('\n')));
+        const __m256i is_valid(_mm256_or_si256(_mm256_or_si256(_mm256_or_si256(is_A,is_C),_mm256_or_si256(is_G,is_U)),
+                                               _mm256_or_si256(is_X,_mm256_or_si256(is_gap,is_newline))));
+        __m256i result(_mm256_andnot_si256(is_valid,_mm256_set1_epi8(illegal_code)));
+        result = _mm256_or_si256(result,_mm256_and_si256(is_C,_mm256_set1_epi8(Cytosine)));
+        result = _mm256_or_si256(result,_mm256_and_si256(is_G,_mm256_set1_epi8(Guanine)));
+        result = _mm256_or_si256(result,_mm256_and_si256(is_U,_mm256_set1_epi8(Uracil)));
+        result = _mm256_or_si256(result,_mm256_and_si256(is_X,_mm256_set1_epi8(Mask)));
+        result = _mm256_or_si256(result,_mm256_and_si256(is_gap,_mm256_set1_epi8(Gap)));
+        result = _mm256_or_si256(result,_mm256_and_si256(is_newline,_mm256_set1_epi8(newline_code)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(codes),result);
+      }
+#elif defined(__SSE2__)
+      const __m128i case_bit(_mm_set1_epi8(0x20));
+      for(;end-char_it >= 16;char_it+=16,codes+=16)
+      {
+        const __m128i characters(_mm_loadu_si128(reinterpret_cast<const __m128i *>(char_it)));
+        const __m128i lower(_mm_or_si128(characters,case_bit));
+        const __m128i is_A(_mm_cmpeq_epi8(lower,_mm_set1_epi8('a')));
+        const __m128i is_C(_mm_cmpeq_epi8(lower,_mm_set1_epi8('c')));
+        const __m128i is_G(_mm_cmpeq_epi8(lower,_mm_set1_epi8('g')));
+        const __m128i is_U(_mm_or_si128(_mm_cmpeq_epi8(lower,_mm_set1_epi8('u')),_mm_cmpeq_epi8(lower,_mm_set1_epi8('t'))));
+        const __m128i is_X(_mm_cmpeq_epi8(lower,_mm_set1_epi8('x')));
+        const __m128i is_gap(_mm_cmpeq_epi8(characters,_mm_set1_epi8('-')));
+        const __m128i is_newline(_mm_cmpeq_epi8(characters,_mm_set1_epi8('\n')));
+        const __m128i is_valid(_mm_or_si128(_mm_or_si128(_mm_or_si128(is_A,is_C),_mm_or_si128(is_G,is_U)),
+                                            _mm_or_si128(is_X,_mm_or_si128(is_gap,is_newline))));
+        __m128i result(_mm_andnot_si128(is_valid,_mm_set1_epi8(illegal_code)));
+        result = _mm_or_si128(result,_mm_and_si128(is_C,_mm_set1_epi8(Cytosine)));
+        result = _mm_or_si128(result,_mm_and_si128(is_G,_mm_set1_epi8(Guanine)));
+        result = _mm_or_si128(result,_mm_and_si128(is_U,_mm_set1_epi8(Uracil)));
+        result = _mm_or_si128(result,_mm_and_si128(is_X,_mm_set1_epi8(Mask)));
+        result = _mm_or_si128(result,_mm_and_si128(is_gap,_mm_set1_epi8(Gap)));
+        result = _mm_or_si128(result,_mm_and_si128(is_newline,_mm_set1_epi8(newline_code)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(codes),result);
+      }
+#endif
+      for(;char_it!=end;++char_it,++codes)
+      {
+        *codes = base_code(*char_it);
+      }
+}
+
+    /*****************************************************************//**
+    * @brief base code access
+    *
+    * This is used to get the base code of a character of a sequence
+    * decoding the block of characters starting at it if it is not part
+    * of the block decoded last.
+    *
+    * @param position const char pointer to the character
+    * @param end const char pointer behind the last character of the
+    *     sequence
+    * @param block_begin const char pointer reference to the first
+    *     character of the block decoded last (updated if a new block is
+    *     decoded)
+    * @param block_end const char pointer reference behind the last
+    *     character of the block decoded last (updated if a new block is
+    *     decoded)
+    * @param codes unsigned char pointer to the codes of the block
+    *     decoded last (holding at least decoding_block_size codes)
+    *
+    * @return the base code of the character or end_code if @p position
+    *     is the end of the sequence
+    *********************************************************************/
+    static unsigned char base_code_at(const char * position, const char * end, const char * & block_begin, const char * & block_end, unsigned char * codes) {
+      if(position == end)
+      {
+        return end_code;
+      }
+      if(position < block_begin || position >= block_end)
+      {
+        block_begin = position;
+        block_end = position + std::min<size_t>(decoding_block_size,end-position);
+        decode_bases(block_begin,block_end,codes);
+      }
+      return codes[position-block_begin];
+}
+
+    /*****************************************************************//**
+    * @brief conservation offset shifting
+    *
+    * This is used to calculate the conservation offset of a nucleotide
+    * moved along its chromosome (e.g. by an indel), so it keeps the
+    * conservation of its original position.
+    *
+    * @param the_nucleotide const nucleotide reference to the nucleotide
+    * @param shift short int representing the distance the nucleotide is
+    *     moved
+    *
+    * @return the conservation offset of the moved nucleotide
+    *     (nucleotide::unconserved if it has no conservation)
+    *********************************************************************/
+    static conservationOffset shifted_conservation_offset(const nucleotide & the_nucleotide, short int shift) {
+      return the_nucleotide.is_conserved() ? conservationOffset(the_nucleotide.get_conservation_offset() + shift) : nucleotide::unconserved;
+}
+
     /*****************************************************************//**
     * @brief constructor - Do not call without parameter values!
     *
@@ -66,6 +270,76 @@ namespace microSNPscore {
       return (get_end()-get_start()+1);
 }
 
+    /*****************************************************************//**
+    * @brief constructor from string
+    *
+    * This is used to create a nucleotideText referring to the characters
+    * of a given string.
+    *
+    * @param the_string const std::string reference to the nucleotides
+    *
+    * @return nucleotideText for the given string
+    *********************************************************************/
+    nucleotideText::nucleotideText(const std::string & the_string)
+    :first(the_string.data()),last(the_string.data()+the_string.size()) {
+}
+
+    /*****************************************************************//**
+    * @brief constructor from character range
+    *
+    * This is used to create a nucleotideText referring to a given range
+    * of characters.
+    *
+    * @param the_begin const char pointer to the first character
+    * @param the_end const char pointer behind the last character
+    *
+    * @return nucleotideText for the given character range
+    *********************************************************************/
+    nucleotideText::nucleotideText(const char * the_begin, const char * the_end)
+    :first(the_begin),last(the_end) {
+}
+
+    /*****************************************************************//**
+    * @brief length calculation
+    *
+    * This method is used to count the characters of the text (i.e.
+    * without newlines).
+    *
+    * @return the number of characters of the text
+    *********************************************************************/
+    std::string::size_type nucleotideText::get_length() const {
+      return (last - first) - std::count(first,last,'\n');
+}
+
+    /*****************************************************************//**
+    * @brief string conversion
+    *
+    * This method is used to copy a part of the text to a string
+    * (omitting newlines).
+    *
+    * @param from (optional) const char pointer to the first character of
+    *     the range to copy - Defaults to NULL (the begin of the text)
+    * @param to (optional) const char pointer behind the last character
+    *     of the range to copy - Defaults to NULL (the end of the text)
+    *
+    * @return string containing the characters of the given range
+    *********************************************************************/
+    std::string nucleotideText::get_string(const char * from, const char * to) const {
+       /**************************************************************\ 
+      | Append the lines of the range one after another to the string: |
+       \**************************************************************/
+      std::string text;
+      const char * line_begin(from != NULL ? from : first);
+      const char * const range_end(to != NULL ? to : last);
+      while(line_begin < range_end)
+      {
+        const char * line_end(std::find(line_begin,range_end,'\n'));
+        text.append(line_begin,line_end);
+        line_begin = line_end + 1;
+      }
+      return text;
+}
+
     /*****************************************************************//**
     * @brief constructor
     *
@@ -74,6 +348,7 @@ namespace microSNPscore {
     * T is understood as Thymine and is treated as Uracil (simulating
     * transscription).
     * Dashes (-) are understood as Gaps and are omitted.
+    * Newlines are skipped.
     * Other characters than A,a,C,c,G,g,U,u,T,t,X,x or - raise an error
     * and are treated as Mask.
     * The ordering of exon starts and ends does not matter.
@@ -86,8 +361,9 @@ namespace microSNPscore {
     * are treated as masked, respectively.
     *
     * @param the_ID sequenceID representing the ID of the sequence
-    * @param sequence_string String representing the nucleotide sequence
-    *     (Adenine: A, Cytosine: C, Guanine: G, Uracil: U, Mask: X)
+    * @param sequence_string nucleotideText representing the nucleotide
+    *     sequence (Adenine: A, Cytosine: C, Guanine: G, Uracil: U,
+    *     Mask: X) which may be interrupted by newlines
     * @param the_chromosome chromosomeType representing the chromosome the
     *     sequence is located on
     * @param the_strand strandType representing the strand (Plus/Minus) on
@@ -102,23 +378,20 @@ namespace microSNPscore {
     *     the 3' end of the + strand and accordingly the 5' end of
     *     the - strand) of the exons containing the sequence as
     *     comma-separated list.
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the sequence
     * @param verbose (optional) bool indicating wheter verbose output
     *     to STDERR should be done or not - Defaults to false
     *
     * @return a sequence containing the given nucleotides located on the
-    *     given chromosome, strand and positions with the given
-    *     conservation scores.
+    *     given chromosome, strand and positions.
     *********************************************************************/
-    sequence::sequence(sequenceID the_ID, std::string sequence_string, chromosomeType the_chromosome, strandType the_strand, std::string exon_starts, std::string exon_ends, const conservationList & conservations, bool verbose)
+    sequence::sequence(sequenceID the_ID, nucleotideText sequence_string, chromosomeType the_chromosome, strandType the_strand, std::string exon_starts, std::string exon_ends, bool verbose)
     :ID(the_ID),chromosome(the_chromosome),strand(the_strand),exons(initialize_exons(position_string_to_vector(exon_starts),position_string_to_vector(exon_ends)))
-    ,length(initialize_length(exons.begin(),exons.end())),nucleotides(initialize_nucleotides(sequence_string,the_chromosome,the_strand,exons.begin(),exons.end(),length,conservations)) {
+    ,length(initialize_length(exons.begin(),exons.end())),nucleotides(initialize_nucleotides(sequence_string,the_strand,exons.begin(),exons.end(),length)) {
       if(verbose){std::cerr << "microSNPscore:     sequence initialization: ID is " << the_ID << std::endl
-                            << "microSNPscore:     sequence initialization: sequence is " << sequence_string << std::endl
+                            << "microSNPscore:     sequence initialization: sequence is " << sequence_string.get_string() << std::endl
                             << "microSNPscore:     sequence initialization: location is " << exon_starts << "|" << exon_ends << std::endl
                             << "microSNPscore:     sequence initialization: location length is " << length << std::endl
-                            << "microSNPscore:     sequence initialization: sequence length is " << sequence_string.length() << std::endl;}
+                            << "microSNPscore:     sequence initialization: sequence length is " << sequence_string.get_length() << std::endl;}
 }
 
     /*****************************************************************//**
@@ -136,6 +409,15 @@ namespace microSNPscore {
     :ID(""),chromosome(""),strand(Plus),exons(std::vector<exon>()),length(0),nucleotides(std::vector<nucleotide>()) {
 }
 
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is virtual since sequences are derived from (mRNA, miRNA) and
+    * owned through pointers (e.g. by an entityTable).
+    *********************************************************************/
+    sequence::~sequence() {
+}
+
 /*****************************************************************//**
 * @brief get subsequence between sequence positions
 *
@@ -199,7 +481,7 @@ if(get_length()!=0 && from<to)
   for(const_iterator nucleotide_it(get_nucleotide(from));nucleotide_it<=get_nucleotide(to);++nucleotide_it)
   {
     nucleotide_vector.push_back(nucleotide(nucleotide_it->get_base(),++sequence_length,nucleotide_it->get_chromosome_position(),
-                                           nucleotide_it->get_conservation()));
+                                           nucleotide_it->get_conservation_offset()));
   }
    /*************************************************************\ 
   | Return a sequence on the same chromosome and strand, with the |
@@ -298,38 +580,42 @@ return get_subsequence_from_to(chromosome_position_to_sequence_position(from),
         | shifting the chromosome positions for - stranded sequences because |
         | the positions are counted from the 5' end of the + strand and thus |
         | the 5' end of the - strand has higher positions than the changing  |
-        | subsequence:                                                       |
+        | subsequence (keeping the position their conservation is taken      |
+        | from):                                                             |
          \******************************************************************/
         std::vector<nucleotide> the_nucleotides;
         sequencePosition position(0);
         for(const_iterator sequence_it(begin());sequence_it!=change_begin;++sequence_it)
         {
           the_nucleotides.push_back(nucleotide(sequence_it->get_base(),++position,sequence_it->get_chromosome_position() +
-                                                                                  (get_strand() == Plus ? 0 : shift),sequence_it->get_conservation()));
+                                                                                  (get_strand() == Plus ? 0 : shift),
+                                               shifted_conservation_offset(*sequence_it,get_strand() == Plus ? 0 : shift)));
         }
          /**************************************************************\ 
         | Iterate over the alternative sequence and insert it to the new |
         | vector counting the chromosome position up for + stranded      |
         | sequences or down for - stranded sequences, respectively,      |
-        | setting the consevation to zero:                               |
+        | without conservation:                                          |
          \**************************************************************/
         chromosomePosition position_on_chromosome(the_SNP.get_position(get_strand()));
         for(SNP::const_iterator alternative_it(alternative_begin);alternative_it!=alternative_end;
             ++alternative_it,position_on_chromosome += (get_strand() == Plus ? 1 : -1))
         {
-          the_nucleotides.push_back(nucleotide(*alternative_it,++position,position_on_chromosome,0));
+          the_nucleotides.push_back(nucleotide(*alternative_it,++position,position_on_chromosome,nucleotide::unconserved));
         } 
          /*****************************************************************\ 
         | Iterate over the 3' unchanging subsequence and copy it to the new |
         | vector shifting the chromosome positions for + stranded sequences |
         | because the positions are counted from the 5' end of the + strand |
         | and thus the 3' end of the + strand has higher positions than the |
-        | changed subsequence:                                              |
+        | changed subsequence (keeping the position their conservation is   |
+        | taken from):                                                      |
          \*****************************************************************/
         for(const_iterator sequence_it(change_end);sequence_it!=end();++sequence_it)
         {
           the_nucleotides.push_back(nucleotide(sequence_it->get_base(),++position,sequence_it->get_chromosome_position() +
-                                                                                  (get_strand() == Plus ? shift : 0),sequence_it->get_conservation()));
+                                                                                  (get_strand() == Plus ? shift : 0),
+                                               shifted_conservation_offset(*sequence_it,get_strand() == Plus ? shift : 0)));
         }
          /*****************************************************************\ 
         | Initialize exon vector for the mutated sequence, iterate over the |
@@ -364,6 +650,25 @@ return get_subsequence_from_to(chromosome_position_to_sequence_position(from),
       }
 }
 
+    /*****************************************************************//**
+    * @brief sequence exchange
+    *
+    * This method is used to exchange the content of two sequences
+    * without copying their nucleotides (e.g. to move a sequence into a
+    * container holding a default sequence).
+    *
+    * @param the_sequence sequence reference to the sequence to exchange
+    *     the content with
+    *********************************************************************/
+    void sequence::swap(sequence & the_sequence) {
+      ID.swap(the_sequence.ID);
+      chromosome.swap(the_sequence.chromosome);
+      std::swap(strand,the_sequence.strand);
+      exons.swap(the_sequence.exons);
+      std::swap(length,the_sequence.length);
+      nucleotides.swap(the_sequence.nucleotides);
+}
+
     /*****************************************************************//**
     * @brief internal constructor
     *
@@ -378,12 +683,17 @@ return get_subsequence_from_to(chromosome_position_to_sequence_position(from),
     * @param the_length sequenceLength representing the length of the
     *    sequence
     * @param the_nucleotides: std::vector<nucleotide> representing the
-    *     sequence's nucleotides
+    *     sequence's nucleotides (taken over by the sequence, leaving the
+    *     given vector empty, so they are not copied)
     *
     * @return a sequence with the given attributes
     *********************************************************************/
-    sequence::sequence(sequenceID the_ID, chromosomeType the_chromosome, strandType the_strand, std::vector<exon> the_exons, sequenceLength the_length, const std::vector<nucleotide> & the_nucleotides)
-    :ID(the_ID),chromosome(the_chromosome),strand(the_strand),exons(the_exons),length(the_length),nucleotides(the_nucleotides) {
+    sequence::sequence(sequenceID the_ID, chromosomeType the_chromosome, strandType the_strand, std::vector<exon> the_exons, sequenceLength the_length, std::vector<nucleotide> & the_nucleotides)
+    :ID(the_ID),chromosome(the_chromosome),strand(the_strand),exons(the_exons),length(the_length),nucleotides() {
+       /*************************************************\ 
+      | Take the nucleotides over by swapping the vectors: |
+       \*************************************************/
+      nucleotides.swap(the_nucleotides);
 }
 
     /*****************************************************************//**
@@ -476,17 +786,19 @@ return get_subsequence_from_to(chromosome_position_to_sequence_position(from),
     * T is understood as Thymine and is treated as Uracil (simulating
     * transscription).
     * Dashes (-) are understood as Gaps and are omitted.
-    * Other characters than A,a,C,c,G,g,U,u,T,t,X,x or - raise an error
-    * and are treated as Mask.
+    * Newlines are skipped.
+    * Other characters than A,a,C,c,G,g,U,u,T,t,X,x or - are treated as
+    * Mask and reported together (with their positions) in one error.
+    * The characters are decoded in blocks using SIMD instructions if
+    * available.
     * If the given sequence length does
     * not match the count of nucleotides an error message is raised and
     * the additional nucleotides are omitted or the missing nucleotides
     * are treated as masked, respectively.
     *
-    * @param the_sequence String representing the nucleotide sequence
-    *     (Adenine: A, Cytosine: C, Guanine: G, Uracil: U, Mask: X)
-    * @param the_chromosome chromosomeType representing the chromosome the
-    *     sequence is located on
+    * @param the_sequence nucleotideText representing the nucleotide
+    *     sequence (Adenine: A, Cytosine: C, Guanine: G, Uracil: U,
+    *     Mask: X) which may be interrupted by newlines
     * @param the_strand strandType representing the strand (Plus/Minus) on
     *     which the sequence is located
     * @param begin_of_exons const_exon_iterator pointing the sequence's
@@ -494,21 +806,30 @@ return get_subsequence_from_to(chromosome_position_to_sequence_position(from),
     * @param end_of_exons const_exon_iterator pointing behind the
     *     sequence's exon vector
     * @param the_length the requested length of the sequence
-    * @param conservations conservationList containing the conservaton
-    *     ranges for the sequence
     *
     * @return a vector containing the sequence's nucleotides
     *********************************************************************/
-    std::vector<nucleotide> sequence::initialize_nucleotides(const std::string & the_sequence, chromosomeType the_chromosome, strandType the_strand
-    , const sequence::const_exon_iterator & begin_of_exons, const sequence::const_exon_iterator & end_of_exons, sequenceLength the_length, const conservationList & conservations)
+    std::vector<nucleotide> sequence::initialize_nucleotides(const nucleotideText & the_sequence, strandType the_strand
+    , const sequence::const_exon_iterator & begin_of_exons, const sequence::const_exon_iterator & end_of_exons, sequenceLength the_length)
     {
-       /**************************************************************\ 
-      | Initialize empty nucleotide vector, counters and iterators and |
-      | loop up to requested length where the order the exons are      |
-      | iterated in depends on the strand (+: forward / -: backward):  |
-       \**************************************************************/
+       /***************************************************************\ 
+      | Initialize empty nucleotide vector (allocated for the requested |
+      | length at once), counters and iterators and loop up to the      |
+      | requested length where the order the exons are iterated in      |
+      | depends on the strand (+: forward / -: backward) - the          |
+      | characters are decoded to base codes block by block:            |
+       \***************************************************************/
       std::vector<nucleotide> nucleotide_vector;
-      std::string::const_iterator sequence_it(the_sequence.begin());
+      nucleotide_vector.reserve(the_length);
+      unsigned char codes[decoding_block_size];
+      const char * block_begin(the_sequence.begin());
+      const char * block_end(the_sequence.begin());
+      const char * sequence_it(the_sequence.begin());
+      unsigned char the_base_code(base_code_at(sequence_it,the_sequence.end(),block_begin,block_end,codes));
+      while(the_base_code == newline_code)
+      {
+        the_base_code = base_code_at(++sequence_it,the_sequence.end(),block_begin,block_end,codes);
+      }
       const_exon_iterator exon_it(the_strand == Plus ?
                                   begin_of_exons :
                                   end_of_exons - (begin_of_exons != end_of_exons ?
@@ -520,9 +841,7 @@ return get_subsequence_from_to(chromosome_position_to_sequence_position(from),
                                                  exon_it->get_end()) :
                                                 0);
       sequenceLength length_of_sequence(0);
-      char the_base_char(sequence_it != the_sequence.end() ?
-                         *sequence_it :
-                         '\0');
+      std::ostringstream illegal_characters;
       while(length_of_sequence != the_length &&
            ((the_strand == Plus && (position_on_chromosome <= exon_it->get_end() || exon_it != end_of_exons)) ||
             (the_strand == Minus && (position_on_chromosome >= exon_it->get_start() || exon_it != begin_of_exons))))
@@ -530,45 +849,24 @@ return get_subsequence_from_to(chromosome_position_to_sequence_position(from),
          /***************************************************\ 
         | Add nucleotide for every nucleobase that is no gap: |
          \***************************************************/
-        if(the_base_char != '-')
+        if(the_base_code != Gap)
         {
-          nucleoBase nucleo_base(Adenine);
-          switch(the_base_char)
+          nucleoBase nucleo_base(Mask);
+          if(the_base_code <= Mask)
+          {
+            nucleo_base = nucleoBase(the_base_code);
+          }
+          else if(the_base_code == end_code)
           {
-            case 'a':
-            case 'A':
-              break;
-            case 't':
-            case 'T':
-            case 'u':
-            case 'U':
-              nucleo_base=Uracil;
-              break;
-            case 'c':
-            case 'C':
-              nucleo_base=Cytosine;
-              break;
-            case 'g':
-            case 'G':
-              nucleo_base=Guanine;
-              break;
-            case '\0':
-              std::cerr << "microSNPscore::sequence::initialize_nucleotides\n";
-              std::cerr << " ==> missing nucleo base character\n";
-              std::cerr << "  --> assuming Mask\n";
-            case 'x':
-            case 'X':
-              nucleo_base=Mask;
-              break;
-            default:
-              std::cerr << "microSNPscore::sequence::initialize_nucleotides\n";
-              std::cerr << " ==> illegal nucleo base character: \n";
-              std::cerr << the_base_char << std::endl;
-              std::cerr << "  --> assuming Mask\n";
-              nucleo_base=Mask;
-          } // switch(the_base_char)
-          nucleotide_vector.push_back(nucleotide(nucleo_base,++length_of_sequence,position_on_chromosome,conservations.get_score(the_chromosome,
-                                                                                                                                 position_on_chromosome)));
+            std::cerr << "microSNPscore::sequence::initialize_nucleotides\n";
+            std::cerr << " ==> missing nucleo base character\n";
+            std::cerr << "  --> assuming Mask\n";
+          }
+          else // illegal character (reported with the others below)
+          {
+            illegal_characters << ' ' << *sequence_it << '@' << length_of_sequence + 1;
+          }
+          nucleotide_vector.push_back(nucleotide(nucleo_base,++length_of_sequence,position_on_chromosome));
            /***************************************************************\ 
           | Increment counters and if needed move on to next exon where the |
           | direction depends on the strand (+: forward / -:backward):      |
@@ -597,24 +895,37 @@ return get_subsequence_from_to(chromosome_position_to_sequence_position(from),
               position_on_chromosome = exon_it->get_end();
             }
           }
-        }  // if(the_base_char != '-')
+        }  // if(the_base_code != Gap)
         else
         {
           std::cerr << "microSNPscore::sequence::initialize_nucleotides\n";
           std::cerr << " ==> illegal nucleo base character: \n";
-          std::cerr << the_base_char << std::endl;
+          std::cerr << '-' << std::endl;
           std::cerr << "  --> assuming Gap --> omitting\n";
         }
-         /**************************************************************\ 
-        | Move on in given sequence and a append zero-chars if the given |
-        | sequece is too short:                                          |
-         \**************************************************************/
-        if(sequence_it != the_sequence.end()) // bases remaining?
+         /******************************************************\ 
+        | Move on in given sequence (skipping newlines) if there |
+        | are bases remaining:                                   |
+         \******************************************************/
+        if(the_base_code != end_code)
         {
-          ++sequence_it;
+          do
+          {
+            the_base_code = base_code_at(++sequence_it,the_sequence.end(),block_begin,block_end,codes);
+          } while(the_base_code == newline_code);
         }
-        the_base_char = (sequence_it != the_sequence.end() ? *sequence_it : '\0');
       } // while-loop
+       /**************************************************************\ 
+      | Report all illegal characters at once (with their positions in |
+      | the sequence):                                                 |
+       \**************************************************************/
+      if(!illegal_characters.str().empty())
+      {
+        std::cerr << "microSNPscore::sequence::initialize_nucleotides\n";
+        std::cerr << " ==> illegal nucleo base characters (character@position):\n";
+        std::cerr << illegal_characters.str().substr(1) << std::endl;
+        std::cerr << "  --> assuming Mask\n";
+      }
        /*****************************************************************\ 
       | Check for additional characters in given sequence that have to be |
       | omitted and return constructed nucleotide vector:                 |
@@ -624,8 +935,8 @@ return get_subsequence_from_to(chromosome_position_to_sequence_position(from),
             std::cerr << "microSNPscore::sequence::initialize_nucleotides\n";
             std::cerr << " ==> additional nucleo base characters: \n";
             std::cerr << (the_strand == Plus ?
-                          the_sequence.substr(sequence_it - the_sequence.begin(),the_sequence.end() - sequence_it +1) :
-                          the_sequence.substr(0,sequence_it - the_sequence.begin() + 1)) << std::endl;
+                          the_sequence.get_string(sequence_it,the_sequence.end()) :
+                          the_sequence.get_string(the_sequence.begin(),sequence_it + 1)) << std::endl;
             std::cerr << "  --> omitting\n";
       }
       return nucleotide_vector;
@@ -0,0 +1,507 @@
+#include <iostream>
+//for std::cerr and std::endl (error stating)
+#include <fstream>
+//for std::ofstream and std::ifstream (database writing and detection)
+#include <cstdio>
+//for std::rename and std::remove (database replacement)
+#include <string.h>
+//for memset, memcpy, memcmp and strerror (header writing, magic checking and error stating)
+#include <errno.h>
+//for errno (error stating)
+#include <stdint.h>
+//for uint32_t and uint64_t (file layout)
+#include <unistd.h>
+//for close (file access)
+#include <fcntl.h>
+//for open (file access)
+#include <sys/mman.h>
+//for mmap and munmap (file mapping)
+#include <sys/stat.h>
+//for fstat (file size)
+#include "sequenceDatabase.h"
+#include "sequenceFile.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief database header
+    *
+    * This is the layout of the first bytes of a database file.
+    *********************************************************************/
+    struct databaseHeader {
+      char magic[8];
+      uint64_t version;
+      uint64_t byte_order;
+      uint64_t record_count;
+      uint64_t records_offset;
+    };
+
+    /*****************************************************************//**
+    * @brief database record
+    *
+    * This is the layout of the entry of one sequence in the record table
+    * of a database file (offsets are relative to the file start).
+    *********************************************************************/
+    struct databaseRecord {
+      uint64_t ID_offset;
+      uint64_t ID_length;
+      uint64_t chromosome_offset;
+      uint64_t chromosome_length;
+      uint64_t strand;
+      uint64_t exons_offset;
+      uint64_t exon_count;
+      uint64_t length;
+      uint64_t bases_offset;
+      uint64_t mask_offset;
+    };
+
+    /*****************************************************************//**
+    * @brief database magic
+    *
+    * This identifies a file as sequence database.
+    *********************************************************************/
+    static const char database_magic[8] = {'m','S','N','P','s','d','b','\0'};
+
+    /*****************************************************************//**
+    * @brief database version
+    *
+    * This is the version of the file layout written and understood.
+    *********************************************************************/
+    static const uint64_t database_version(2);
+
+    /*****************************************************************//**
+    * @brief byte order mark
+    *
+    * This is written to detect databases built with another byte order.
+    *********************************************************************/
+    static const uint64_t database_byte_order(0x0102030405060708ULL);
+
+    /*****************************************************************//**
+    * @brief data appending
+    *
+    * This is used to append a block of data to a database file padding
+    * it to a multiple of 8 bytes (so all blocks are aligned).
+    *
+    * @param file std::ofstream reference to the database file
+    * @param offset uint64_t reference to the current end of the file
+    *     (moved behind the appended block)
+    * @param data const void pointer to the data
+    * @param size size_t representing the number of bytes to append
+    *
+    * @return the offset of the appended block in the file
+    *********************************************************************/
+    static uint64_t append_block(std::ofstream & file, uint64_t & offset, const void * data, size_t size) {
+      static const char padding[8] = {0,0,0,0,0,0,0,0};
+      const uint64_t block_offset(offset);
+      file.write(static_cast<const char *>(data),size);
+      file.write(padding,(8 - size % 8) % 8);
+      offset += size + (8 - size % 8) % 8;
+      return block_offset;
+}
+
+    /*****************************************************************//**
+    * @brief nucleotide position calculation
+    *
+    * This is used to calculate the chromosome positions of the
+    * nucleotides of a sequence from its exons like the sequence
+    * constructor does (walking the exons in 5' --> 3' direction of the
+    * given strand).
+    *
+    * @param exons const std::vector reference to the exons of the
+    *     sequence
+    * @param the_strand strandType of the sequence
+    * @param the_length sequenceLength of the sequence
+    * @param positions std::vector reference the positions are appended
+    *     to
+    *********************************************************************/
+    static void exon_positions(const std::vector<exon> & exons, strandType the_strand, sequenceLength the_length, std::vector<chromosomePosition> & positions) {
+      if(the_strand == Plus)
+      {
+        for(std::vector<exon>::const_iterator exon_it(exons.begin());exon_it!=exons.end();++exon_it)
+        {
+          for(chromosomePosition position(exon_it->get_start());position<=exon_it->get_end() && positions.size()<the_length;++position)
+          {
+            positions.push_back(position);
+          }
+        }
+      }
+      else
+      {
+        for(std::vector<exon>::const_reverse_iterator exon_it(exons.rbegin());exon_it!=exons.rend();++exon_it)
+        {
+          for(chromosomePosition position(exon_it->get_end());position>=exon_it->get_start() && positions.size()<the_length;--position)
+          {
+            positions.push_back(position);
+            if(position == 0)
+            {
+              break;
+            }
+          }
+        }
+      }
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to open an existing sequence database.
+    * If the file cannot be mapped or is no valid database of the current
+    * version an error is raised and the database is created but won't
+    * contain any sequences (see @p is_open).
+    *
+    * @param the_path filePath to the database file
+    *
+    * @return sequenceDatabase for the given file
+    *
+    * @see is_open()
+    *********************************************************************/
+    sequenceDatabase::sequenceDatabase(const filePath & the_path)
+    :path(the_path),mapping(NULL),mapping_size(0) {
+       /*******************************************************\ 
+      | Try to map the whole file read-only stating an error in |
+      | the case of failure:                                    |
+       \*******************************************************/
+      const int fd(open(path.c_str(),O_RDONLY));
+      struct stat file_status;
+      void * the_mapping(MAP_FAILED);
+      const char * reason("file too short");
+      if(fd < 0 || fstat(fd,&file_status) != 0)
+      {
+        reason = strerror(errno);
+      }
+      else if(file_status.st_size >= off_t(sizeof(databaseHeader)))
+      {
+        the_mapping = mmap(NULL,file_status.st_size,PROT_READ,MAP_SHARED,fd,0);
+        reason = strerror(errno);
+      }
+      if(the_mapping == MAP_FAILED)
+      {
+        std::cerr << "microSNPscore::sequenceDatabase::sequenceDatabase\n";
+        std::cerr << " ==> Cannot map database: ";
+        std::cerr << path << ": " << reason << std::endl;
+        std::cerr << "  --> no sequences will be read from the database\n";
+        if(fd >= 0)
+        {
+          close(fd);
+        }
+        return;
+      }
+      close(fd);
+      mapping = static_cast<const char *>(the_mapping);
+      mapping_size = file_status.st_size;
+       /**********************************************************\ 
+      | Make sure the header identifies a database of the current  |
+      | version and byte order and that all tables and blocks lie  |
+      | inside the file (aligned for access), unmapping it if not: |
+       \**********************************************************/
+      const databaseHeader & header(*reinterpret_cast<const databaseHeader *>(mapping));
+      bool valid(memcmp(header.magic,database_magic,sizeof(database_magic)) == 0 && header.version == database_version &&
+                 header.byte_order == database_byte_order &&
+                 header.records_offset % 8 == 0 && header.records_offset <= mapping_size &&
+                 header.record_count <= (mapping_size - header.records_offset) / sizeof(databaseRecord));
+      const databaseRecord * records(reinterpret_cast<const databaseRecord *>(mapping + header.records_offset));
+      for(uint64_t record_index(0);valid && record_index!=header.record_count;++record_index)
+      {
+        const databaseRecord & record(records[record_index]);
+        const uint64_t block_offsets[5] = {record.ID_offset,record.chromosome_offset,record.exons_offset,
+                                           record.bases_offset,record.mask_offset};
+        const uint64_t block_sizes[5] = {record.ID_length,record.chromosome_length,record.exon_count * 2 * sizeof(uint32_t),
+                                         (record.length + 3) / 4,(record.length + 7) / 8};
+        valid = record.strand <= 1 && record.exon_count < mapping_size && record.length <= sequenceLength(-1) &&
+                record.exons_offset % 8 == 0;
+        for(unsigned short block(0);valid && block!=5;++block)
+        {
+          valid = block_offsets[block] <= mapping_size && block_sizes[block] <= mapping_size - block_offsets[block];
+        }
+      }
+      if(!valid)
+      {
+        std::cerr << "microSNPscore::sequenceDatabase::sequenceDatabase\n";
+        std::cerr << " ==> no valid sequence database of version " << database_version << ": ";
+        std::cerr << path << std::endl;
+        std::cerr << "  --> no sequences will be read from the database (rebuild it)\n";
+        munmap(const_cast<char *>(mapping),mapping_size);
+        mapping = NULL;
+        mapping_size = 0;
+      }
+}
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to unmap the database file.
+    *********************************************************************/
+    sequenceDatabase::~sequenceDatabase() {
+      if(mapping != NULL)
+      {
+        munmap(const_cast<char *>(mapping),mapping_size);
+      }
+}
+
+    /*****************************************************************//**
+    * @brief get method for sequence count
+    *
+    * This method is used to access the number of sequences in the
+    * database.
+    *
+    * @return the number of sequences in the database
+    *********************************************************************/
+    unsigned long sequenceDatabase::size() const {
+      return mapping != NULL ? reinterpret_cast<const databaseHeader *>(mapping)->record_count : 0;
+}
+
+    /*****************************************************************//**
+    * @brief get method for sequence IDs
+    *
+    * This method is used to access the ID of a sequence without creating
+    * the sequence.
+    *
+    * @param index unsigned long representing the number of the sequence
+    *     in the database (less than its size)
+    *
+    * @return the ID of the sequence
+    *********************************************************************/
+    sequenceID sequenceDatabase::get_ID(unsigned long index) const {
+      const databaseRecord & record(reinterpret_cast<const databaseRecord *>(mapping + reinterpret_cast<const databaseHeader *>(mapping)->records_offset)[index]);
+      return sequenceID(mapping + record.ID_offset,record.ID_length);
+}
+
+    /*****************************************************************//**
+    * @brief mRNA object creation
+    *
+    * This method is used to create a mRNA object from a sequence of the
+    * database.
+    *
+    * @param index unsigned long representing the number of the sequence
+    *     in the database (less than its size)
+    *
+    * @return mRNA object corresponding to the sequence
+    *********************************************************************/
+    mRNA sequenceDatabase::get_mRNA(unsigned long index) const {
+       /**************************************************\ 
+      | Move the decoded nucleotides into an empty mRNA by |
+      | swapping instead of copying them into a new one:   |
+       \**************************************************/
+      mRNA the_mRNA;
+      sequence the_sequence(get_sequence(index));
+      the_mRNA.swap(the_sequence);
+      return the_mRNA;
+}
+
+    /*****************************************************************//**
+    * @brief miRNA object creation
+    *
+    * This method is used to create a miRNA object from a sequence of the
+    * database.
+    *
+    * @param index unsigned long representing the number of the sequence
+    *     in the database (less than its size)
+    *
+    * @return miRNA object corresponding to the sequence
+    *********************************************************************/
+    miRNA sequenceDatabase::get_miRNA(unsigned long index) const {
+       /***************************************************\ 
+      | Move the decoded nucleotides into an empty miRNA by |
+      | swapping instead of copying them into a new one:    |
+       \***************************************************/
+      miRNA the_miRNA;
+      sequence the_sequence(get_sequence(index));
+      the_miRNA.swap(the_sequence);
+      return the_miRNA;
+}
+
+    /*****************************************************************//**
+    * @brief database creation
+    *
+    * This method is used to create (or replace) the database of a
+    * sequence file.
+    * Errors in the file are stated like when reading it directly.
+    * If the file cannot be read or the database cannot be written an
+    * error is raised.
+    *
+    * @param sequence_path filePath to the sequence file
+    * @param database_path filePath to the database file to be written
+    *
+    * @return true if the database was written, false otherwise
+    *********************************************************************/
+    bool sequenceDatabase::build(const filePath & sequence_path, const filePath & database_path) {
+       /*************************************************************\ 
+      | Try to open the sequence file and a temporary database file   |
+      | stating an error in the case of failure and reserve the space |
+      | for the header:                                               |
+       \*************************************************************/
+      sequenceFileReader reader(sequence_path,true);
+      if(!reader.is_open())
+      {
+        std::cerr << "microSNPscore::sequenceDatabase::build\n";
+        std::cerr << " ==> Cannot open file to read from: ";
+        std::cerr << sequence_path << std::endl;
+        std::cerr << "  --> no database will be created\n";
+        return false;
+      }
+      const filePath temporary_path(database_path+".tmp");
+      std::ofstream database(temporary_path.c_str(),std::ios::out | std::ios::binary | std::ios::trunc);
+      if(database.fail())
+      {
+        std::cerr << "microSNPscore::sequenceDatabase::build\n";
+        std::cerr << " ==> Cannot open file to write to: ";
+        std::cerr << temporary_path << std::endl;
+        std::cerr << "  --> no database will be created\n";
+        return false;
+      }
+      databaseHeader header;
+      memset(&header,0,sizeof(header));
+      uint64_t offset(0);
+      append_block(database,offset,&header,sizeof(header));
+       /***************************************************************\ 
+      | Create every sequence like when reading the sequence file, make |
+      | sure its nucleotides lie where the exons say and append its     |
+      | blocks (packing the bases and masking) to the file:             |
+       \***************************************************************/
+      std::vector<databaseRecord> records;
+      sequenceFileEntry entry;
+      bool valid(true);
+      while(valid && reader.next(entry))
+      {
+        const sequence the_sequence(entry.get_sequence());
+        std::vector<exon> exons(the_sequence.exons_begin(),the_sequence.exons_end());
+        std::vector<chromosomePosition> positions;
+        exon_positions(exons,the_sequence.get_strand(),the_sequence.get_length(),positions);
+        const sequenceLength length(the_sequence.end() - the_sequence.begin());
+        valid = positions.size() == length && length == the_sequence.get_length();
+        std::vector<uint32_t> exon_bounds;
+        for(std::vector<exon>::const_iterator exon_it(exons.begin());exon_it!=exons.end();++exon_it)
+        {
+          exon_bounds.push_back(exon_it->get_start());
+          exon_bounds.push_back(exon_it->get_end());
+        }
+        std::vector<unsigned char> bases((length + 3) / 4,0);
+        std::vector<unsigned char> mask((length + 7) / 8,0);
+        for(sequenceLength index(0);valid && index!=length;++index)
+        {
+          const nucleotide & the_nucleotide(*(the_sequence.begin() + index));
+          valid = the_nucleotide.get_chromosome_position() == positions[index] && the_nucleotide.get_base() != Gap;
+          if(the_nucleotide.get_base() == Mask)
+          {
+            mask[index / 8] |= 1 << (index % 8);
+          }
+          else
+          {
+            bases[index / 4] |= (the_nucleotide.get_base() & 3) << (2 * (index % 4));
+          }
+        } // index
+        if(!valid)
+        {
+          std::cerr << "microSNPscore::sequenceDatabase::build\n";
+          std::cerr << " ==> nucleotides of sequence " << the_sequence.get_ID() << " do not match its exons\n";
+          std::cerr << "  --> no database will be created\n";
+          break;
+        }
+        databaseRecord record;
+        record.ID_offset = append_block(database,offset,the_sequence.get_ID().data(),the_sequence.get_ID().size());
+        record.ID_length = the_sequence.get_ID().size();
+        record.chromosome_offset = append_block(database,offset,the_sequence.get_chromosome().data(),the_sequence.get_chromosome().size());
+        record.chromosome_length = the_sequence.get_chromosome().size();
+        record.strand = the_sequence.get_strand() == Plus ? 0 : 1;
+        record.exons_offset = append_block(database,offset,exon_bounds.empty() ? NULL : &exon_bounds[0],exon_bounds.size() * sizeof(uint32_t));
+        record.exon_count = exons.size();
+        record.length = length;
+        record.bases_offset = append_block(database,offset,bases.empty() ? NULL : &bases[0],bases.size());
+        record.mask_offset = append_block(database,offset,mask.empty() ? NULL : &mask[0],mask.size());
+        records.push_back(record);
+      } // valid && reader.next(entry)
+       /***********************************************************\ 
+      | Append the record table, fill in the header and replace the |
+      | database by the temporary one if all went well stating an   |
+      | error otherwise:                                            |
+       \***********************************************************/
+      memcpy(header.magic,database_magic,sizeof(database_magic));
+      header.version = database_version;
+      header.byte_order = database_byte_order;
+      header.record_count = records.size();
+      header.records_offset = append_block(database,offset,records.empty() ? NULL : &records[0],records.size() * sizeof(databaseRecord));
+      database.seekp(0);
+      database.write(reinterpret_cast<const char *>(&header),sizeof(header));
+      database.close();
+      if(!valid || database.fail() || std::rename(temporary_path.c_str(),database_path.c_str()) != 0)
+      {
+        if(valid)
+        {
+          std::cerr << "microSNPscore::sequenceDatabase::build\n";
+          std::cerr << " ==> Cannot write database: ";
+          std::cerr << database_path << std::endl;
+          std::cerr << "  --> no database will be created\n";
+        }
+        std::remove(temporary_path.c_str());
+        return false;
+      }
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief database detection
+    *
+    * This method is used to check whether a given file is a sequence
+    * database (and not e.g. a sequence file).
+    *
+    * @param the_path filePath to the file
+    *
+    * @return true if the file starts like a sequence database, false
+    *     otherwise
+    *********************************************************************/
+    bool sequenceDatabase::is_database(const filePath & the_path) {
+      std::ifstream the_file(the_path.c_str(),std::ios::in | std::ios::binary);
+      char magic[sizeof(database_magic)];
+      return the_file.read(magic,sizeof(magic)).good() && memcmp(magic,database_magic,sizeof(magic)) == 0;
+}
+
+    /*****************************************************************//**
+    * @brief sequence object creation
+    *
+    * This method is used to create a sequence object from a sequence of
+    * the database.
+    *
+    * @param index unsigned long representing the number of the sequence
+    *     in the database (less than its size)
+    *
+    * @return sequence object corresponding to the sequence
+    *********************************************************************/
+    sequence sequenceDatabase::get_sequence(unsigned long index) const {
+       /***************************************************************\ 
+      | Restore the exons and calculate the nucleotides' positions from |
+      | them:                                                           |
+       \***************************************************************/
+      const databaseHeader & header(*reinterpret_cast<const databaseHeader *>(mapping));
+      const databaseRecord & record(reinterpret_cast<const databaseRecord *>(mapping + header.records_offset)[index]);
+      const uint32_t * exon_bounds(reinterpret_cast<const uint32_t *>(mapping + record.exons_offset));
+      std::vector<exon> exons;
+      exons.reserve(record.exon_count);
+      for(uint64_t exon_index(0);exon_index!=record.exon_count;++exon_index)
+      {
+        exons.push_back(exon(exon_bounds[2 * exon_index],exon_bounds[2 * exon_index + 1]));
+      }
+      const strandType the_strand(record.strand == 0 ? Plus : Minus);
+      const sequenceLength length(record.length);
+      std::vector<chromosomePosition> positions;
+      exon_positions(exons,the_strand,length,positions);
+      positions.resize(length,0);
+       /*********************************\ 
+      | Unpack the bases (unless masked): |
+       \*********************************/
+      const unsigned char * bases(reinterpret_cast<const unsigned char *>(mapping + record.bases_offset));
+      const unsigned char * mask(reinterpret_cast<const unsigned char *>(mapping + record.mask_offset));
+      std::vector<nucleotide> nucleotides;
+      nucleotides.reserve(length);
+      for(sequenceLength nucleotide_index(0);nucleotide_index!=length;++nucleotide_index)
+      {
+        const nucleoBase the_base((mask[nucleotide_index / 8] >> (nucleotide_index % 8)) & 1 ?
+                                  Mask :
+                                  nucleoBase((bases[nucleotide_index / 4] >> (2 * (nucleotide_index % 4))) & 3));
+        nucleotides.push_back(nucleotide(the_base,nucleotide_index + 1,positions[nucleotide_index]));
+      }
+      return sequence(sequenceID(mapping + record.ID_offset,record.ID_length),chromosomeType(mapping + record.chromosome_offset,record.chromosome_length),
+                      the_strand,exons,length,nucleotides);
+}
+
+
+} // namespace microSNPscore
@@ -1,17 +1,148 @@
 
-#include <regex.h>
-// for regex_t, regmatch_t, regcomp and regexec (regular expressions)
 #include <sstream>
-//for std::istringstream (newline omitting & FASTA string composition)
+//for std::ostringstream (unknown nucleotide letters)
+#include <string.h>
+//for memchr and memmove (header splitting, sequence line checking and line wrapping)
+#include <unistd.h>
+//for pread and close (file access)
+#include <fcntl.h>
+//for open (file access)
+#include <sys/mman.h>
+//for mmap, madvise and munmap (file mapping)
+#include <sys/stat.h>
+//for fstat (file size)
 #include <iostream>
 //for std::cerr and std::endl (error stating)
 #include <fstream>
-//for std::ofstream and std::ifstream (file access)
+//for std::ofstream (file access)
+#include <algorithm>
+//for std::sort and std::max (indexed reading)
+#include <errno.h>
+//for errno (interrupted reads)
 #include "sequenceFile.h"
-#include "conservationList.h"
+#include "sequenceFileIndex.h"
+#include "gzipDecoder.h"
+#include "resultWriter.h"
 
 namespace microSNPscore {
 
+    /*****************************************************************//**
+    * @brief nucleotide letter code
+    *
+    * This is used to get the letter a nucleotide is represented by in
+    * FASTA entries (the one inserted by the nucleotide output stream
+    * operator).
+    *
+    * @param the_nucleotide const nucleotide reference to the nucleotide
+    *
+    * @return the letter code of the nucleotide
+    *********************************************************************/
+    static char letter_code(const nucleotide & the_nucleotide) {
+       /*************************************************************\ 
+      | Return the common letters directly and leave unknown bases to |
+      | the output stream operator (stating the error):               |
+       \*************************************************************/
+      switch(the_nucleotide.get_base())
+      {
+        case Adenine: return 'A';
+        case Uracil: return 'U';
+        case Cytosine: return 'C';
+        case Guanine: return 'G';
+        case Gap: return '-';
+        case Mask: return 'X';
+        default:
+          std::ostringstream letter_stream;
+          letter_stream << the_nucleotide;
+          return letter_stream.str()[0];
+      }
+}
+
+    /*****************************************************************//**
+    * @brief FASTA header appending
+    *
+    * This is used to append a FASTA header line to a string.
+    *
+    * @param FASTA std::string reference the header is appended to
+    * @param ID const sequenceID reference to the sequence ID
+    * @param exon_starts const std::string reference to the
+    *     comma-separated list of exon starts
+    * @param exon_ends const std::string reference to the
+    *     comma-separated list of exon ends
+    * @param strand strandType of the sequence
+    * @param chromosome const chromosomeType reference to the chromosome
+    *********************************************************************/
+    static void append_header(std::string & FASTA, const sequenceID & ID, const std::string & exon_starts,
+                              const std::string & exon_ends, strandType strand, const chromosomeType & chromosome) {
+      FASTA += '>';
+      FASTA += ID;
+      FASTA += '|';
+      FASTA += exon_starts;
+      FASTA += '|';
+      FASTA += exon_ends;
+      FASTA += strand == Plus ? "|1|" : "|-1|";
+      FASTA += chromosome;
+      FASTA += '\n';
+}
+
+    /*****************************************************************//**
+    * @brief exon list appending
+    *
+    * This is used to append the comma-separated lists of exon starts
+    * and ends of a sequence to two strings.
+    *
+    * @param exon_starts std::string reference the exon starts are
+    *     appended to
+    * @param exon_ends std::string reference the exon ends are appended
+    *     to
+    * @param the_sequence const sequence reference to the sequence
+    *********************************************************************/
+    static void append_exons(std::string & exon_starts, std::string & exon_ends, const sequence & the_sequence) {
+      for(sequence::const_exon_iterator exon_it(the_sequence.exons_begin());exon_it!=the_sequence.exons_end();++exon_it)
+      {
+        if(exon_it != the_sequence.exons_begin())
+        {
+          exon_starts += ',';
+          exon_ends += ',';
+        }
+        resultWriter::append_position(exon_starts,exon_it->get_start());
+        resultWriter::append_position(exon_ends,exon_it->get_end());
+      }
+}
+
+    /*****************************************************************//**
+    * @brief sequence line wrapping
+    *
+    * This is used to break the nucleotides at the end of a string into
+    * lines of a given length each followed by a newline.
+    * The string is grown once and the lines are moved in place starting
+    * with the last one.
+    *
+    * @param FASTA std::string reference ending with the nucleotides
+    * @param begin std::string::size_type of the first nucleotide in the
+    *     string
+    * @param nucleotides_per_line sequenceLength of one line
+    *********************************************************************/
+    static void wrap_lines(std::string & FASTA, std::string::size_type begin, sequenceLength nucleotides_per_line) {
+      const std::string::size_type length(FASTA.size()-begin);
+      if(length == 0)
+      {
+        return;
+      }
+      const std::string::size_type line_length(nucleotides_per_line);
+      std::string::size_type source(FASTA.size());
+      FASTA.resize(FASTA.size()+(length+line_length-1)/line_length);
+      std::string::size_type target(FASTA.size());
+      std::string::size_type current_length(length-(length-1)/line_length*line_length);
+      while(source != begin)
+      {
+        FASTA[--target] = '\n';
+        target -= current_length;
+        source -= current_length;
+        memmove(&FASTA[target],&FASTA[source],current_length);
+        current_length = line_length;
+      }
+}
+
     /*****************************************************************//**
     * @brief constructor from FASTA entry
     *
@@ -40,55 +171,54 @@ namespace microSNPscore {
     *********************************************************************/
     
     sequenceFileEntry::sequenceFileEntry(std::string FASTA_entry):
-    ID(""),chromosome(""),strand(Plus),exon_starts(""),exon_ends(""),nucleotide_sequence("") {
-       /******************************************************************\ 
-      | Try to initialize extended regular expression matching valid FASTA |
-      | entry stating error in case of failure:                            |
-       \******************************************************************/
-      regex_t regex_FASTA;
-      char pattern_FASTA[] = "^>([^\n]*)[|]([^|\n]*)[|]([^|\n]*)[|](-?1)[|]([^|\n]*)\n(.*)$";
-      if(regcomp(&regex_FASTA,pattern_FASTA,REG_EXTENDED) != 0)
+    ID(""),chromosome(""),strand(Plus),exon_starts(""),exon_ends(""),nucleotide_sequence(""),mapped_begin(NULL),mapped_end(NULL) {
+       /**************************************************************\ 
+      | Split the given FASTA entry into header line and sequence and  |
+      | try to parse the header stating an error in case of failure or |
+      | if the sequence contains a > sign:                             |
+       \**************************************************************/
+      const std::string::size_type header_end(FASTA_entry.find('\n'));
+      if(FASTA_entry.empty() || FASTA_entry[0] != '>' || header_end == std::string::npos ||
+         FASTA_entry.find('>',header_end) != std::string::npos ||
+         !set_header(FASTA_entry.data()+1,FASTA_entry.data()+header_end))
       {
         std::cerr << "microSNPscore::sequenceFileEntry::sequenceFileEntry\n";
-        std::cerr << " ==> compiling FASTA regular expression failed\n";
+        std::cerr << " ==> no valid FASTA entry:\n";
+        std::cerr << FASTA_entry << std::endl;
         std::cerr << "  --> creating empty default sequence\n";
       }
       else
       {
-         /**************************************************************\ 
-        | Try to match the initialized regular expression on given FASTA |
-        | entry stating error in case of failure:                        |
-         \**************************************************************/
-        size_t nmatch_FASTA(7);
-        regmatch_t pmatch_FASTA[nmatch_FASTA];
-        const char * string_FASTA = FASTA_entry.c_str();
-        if(regexec(&regex_FASTA,string_FASTA,nmatch_FASTA,pmatch_FASTA,0) != 0)
+         /**************************************************\ 
+        | Append the sequence lines omitting their newlines: |
+         \**************************************************/
+        nucleotide_sequence.reserve(FASTA_entry.size()-header_end);
+        for(std::string::size_type line_begin(header_end+1);line_begin<FASTA_entry.size();)
         {
-          std::cerr << "microSNPscore::sequenceFileEntry::sequenceFileEntry\n";
-          std::cerr << " ==> no valid FASTA entry:\n";
-          std::cerr << FASTA_entry << std::endl;
-          std::cerr << "  --> creating empty default sequence\n";
-        }
-        else
-        {
-           /*****************************************************************\ 
-          | Extract the subsequences matching the regular expression's groups |
-          | from the given FASTA entry assigning them to the corresponding    |
-          | attributes (omitting newlines in the nucleotide sequence):        |
-           \*****************************************************************/
-          ID = FASTA_entry.substr(pmatch_FASTA[1].rm_so,pmatch_FASTA[1].rm_eo - pmatch_FASTA[1].rm_so);
-          exon_starts = FASTA_entry.substr(pmatch_FASTA[2].rm_so,pmatch_FASTA[2].rm_eo - pmatch_FASTA[2].rm_so);
-          exon_ends = FASTA_entry.substr(pmatch_FASTA[3].rm_so,pmatch_FASTA[3].rm_eo - pmatch_FASTA[3].rm_so);
-          strand = FASTA_entry.substr(pmatch_FASTA[4].rm_so,pmatch_FASTA[4].rm_eo - pmatch_FASTA[4].rm_so) == "1" ? Plus : Minus;
-          chromosome = FASTA_entry.substr(pmatch_FASTA[5].rm_so,pmatch_FASTA[5].rm_eo - pmatch_FASTA[5].rm_so);
-          std::istringstream nucleotide_stream(FASTA_entry.substr(pmatch_FASTA[6].rm_so,pmatch_FASTA[6].rm_eo - pmatch_FASTA[6].rm_so));
-          std::string nucleotide_line;
-          while(std::getline(nucleotide_stream,nucleotide_line))
+          std::string::size_type line_end(FASTA_entry.find('\n',line_begin));
+          if(line_end == std::string::npos)
           {
-            nucleotide_sequence += nucleotide_line;
+            line_end = FASTA_entry.size();
           }
-        } // regexec(&regex_FASTA,FASTA_entry,nmatch_FASTA,pmatch_FASTA_FASTA) == 0
-      } // regcomp(&regex_FASTA,patter_FASTA,REG_EXTEND) == 0
+          nucleotide_sequence.append(FASTA_entry,line_begin,line_end-line_begin);
+          line_begin = line_end + 1;
+        }
+      } // valid FASTA entry
+}
+
+    /*****************************************************************//**
+    * @brief default constructor
+    *
+    * This is used to create the empty default sequenceFileEntry (i.e.
+    * the one corresponding to the FASTA entry ">|||1|\n\n").
+    * It is intended to be filled by a sequenceFileReader.
+    *
+    * @return empty default sequenceFileEntry
+    *
+    * @see sequenceFileReader::next()
+    *********************************************************************/
+    sequenceFileEntry::sequenceFileEntry()
+    :ID(""),chromosome(""),strand(Plus),exon_starts(""),exon_ends(""),nucleotide_sequence(""),mapped_begin(NULL),mapped_end(NULL) {
 }
 
     /*****************************************************************//**
@@ -101,30 +231,19 @@ namespace microSNPscore {
     * @return sequenceFileEntry corresponding to the sequence
     *********************************************************************/
     sequenceFileEntry::sequenceFileEntry(const sequence & the_sequence)
-    :ID(the_sequence.get_ID()),chromosome(the_sequence.get_chromosome()),strand(the_sequence.get_strand()),exon_starts(""),exon_ends(""),nucleotide_sequence("") {
+    :ID(the_sequence.get_ID()),chromosome(the_sequence.get_chromosome()),strand(the_sequence.get_strand()),exon_starts(""),exon_ends(""),nucleotide_sequence(""),mapped_begin(NULL),mapped_end(NULL) {
        /****************************************************************\ 
-      | If required create output string streams for the exon starts and |
-      | end lists, iterate over the sequnece's exons inserting their     |
-      | start and end to the stream, get the nucleotide sequence by      |
-      | inserting the sequence to another output string stream and get   |
-      | the final string values from the streams:                        |
+      | If required append the sequence's exon starts and ends to their  |
+      | lists and the letters of its nucleotides to the sequence string: |
        \****************************************************************/
       if(the_sequence.get_length() != 0)
       {
-        std::ostringstream exon_starts_stream;
-        std::ostringstream exon_ends_stream;
-        exon_starts_stream << the_sequence.exons_begin()->get_start();
-        exon_ends_stream << the_sequence.exons_begin()->get_end();
-        for(sequence::const_exon_iterator exon_it(the_sequence.exons_begin()+1);exon_it!=the_sequence.exons_end();++exon_it)
+        append_exons(exon_starts,exon_ends,the_sequence);
+        nucleotide_sequence.reserve(the_sequence.get_length());
+        for(sequence::const_iterator sequence_it(the_sequence.begin());sequence_it!=the_sequence.end();++sequence_it)
         {
-          exon_starts_stream << "," << exon_it->get_start();
-          exon_ends_stream << "," << exon_it->get_end();
+          nucleotide_sequence += letter_code(*sequence_it);
         }
-        std::ostringstream nucleotide_stream;
-        nucleotide_stream << the_sequence;
-        exon_starts = exon_starts_stream.str();
-        exon_ends = exon_ends_stream.str();
-        nucleotide_sequence = nucleotide_stream.str();
       }
 }
 
@@ -142,32 +261,378 @@ namespace microSNPscore {
     *********************************************************************/
     
     std::string sequenceFileEntry::get_FASTA(sequenceLength nucleotides_per_line) const {
-       /******************************************************************\ 
-      | Create an output string stream for the FASTA entry composition and |
-      | insert the header informations into it. Then create an input       |
-      | string stream from the nucleotide sequence to read lines of the    |
-      | desired length from it inserting them (followed by a newline) into |
-      | the output stream before converting it to a string for return:     |
-       \******************************************************************/
-      std::ostringstream FASTA_stream;
-      FASTA_stream << ">" << ID << "|" << exon_starts << "|" << exon_ends << "|";
-      FASTA_stream << (strand == Plus ? "1" : "-1") << "|" << chromosome << std::endl;
-      std::istringstream sequence_stream(nucleotide_sequence);
-      char sequence_line[nucleotides_per_line+2];
-      sequence_line[nucleotides_per_line] = '\n';
-      sequence_line[nucleotides_per_line+1] = '\0';
-      while(sequence_stream.read(sequence_line,nucleotides_per_line).good())
+       /****************************************************************\ 
+      | Reserve a string for the whole entry and append the entry to it: |
+       \****************************************************************/
+      const std::string::size_type length(get_nucleotides().get_length());
+      std::string FASTA;
+      FASTA.reserve(ID.size()+exon_starts.size()+exon_ends.size()+chromosome.size()+8+length+length/nucleotides_per_line+1);
+      append_FASTA(FASTA,nucleotides_per_line);
+      return FASTA;
+}
+
+    /*****************************************************************//**
+    * @brief FASTA entry appending
+    *
+    * This method is used to append the FASTA entry corresponding to the
+    * sequence file entry to a string (e.g. an output buffer reserved
+    * for several entries).
+    *
+    * @param FASTA std::string reference the FASTA entry is appended to
+    * @param nucleotides_per_line (optional) sequenceLength of one line
+    * in the FASTA output (a newline will be insterted after every that
+    * number of nucleotides) - Defaults to 60
+    *
+    * @see get_FASTA()
+    *********************************************************************/
+    void sequenceFileEntry::append_FASTA(std::string & FASTA, sequenceLength nucleotides_per_line) const {
+       /****************************************************************\ 
+      | Append the header and the lines of the nucleotide text (without  |
+      | their newlines) and break them into lines of the desired length: |
+       \****************************************************************/
+      append_header(FASTA,ID,exon_starts,exon_ends,strand,chromosome);
+      const std::string::size_type nucleotides_begin(FASTA.size());
+      const nucleotideText nucleotides(get_nucleotides());
+      for(const char * line_begin(nucleotides.begin());line_begin<nucleotides.end();)
+      {
+        const char * line_end(static_cast<const char *>(memchr(line_begin,'\n',nucleotides.end()-line_begin)));
+        if(line_end == NULL)
+        {
+          line_end = nucleotides.end();
+        }
+        FASTA.append(line_begin,line_end);
+        line_begin = line_end + 1;
+      }
+      wrap_lines(FASTA,nucleotides_begin,nucleotides_per_line);
+}
+
+    /*****************************************************************//**
+    * @brief sequence FASTA entry appending
+    *
+    * This method is used to append the FASTA entry of a given sequence
+    * to a string without creating a sequence file entry for it first.
+    * The entry is the same @p get_FASTA would return for an entry
+    * created from the sequence.
+    *
+    * @param FASTA std::string reference the FASTA entry is appended to
+    * @param the_sequence const sequence reference to the sequence the
+    *     entry should be created for
+    * @param nucleotides_per_line (optional) sequenceLength of one line
+    * in the FASTA output (a newline will be insterted after every that
+    * number of nucleotides) - Defaults to 60
+    *********************************************************************/
+    void sequenceFileEntry::append_FASTA(std::string & FASTA, const sequence & the_sequence, sequenceLength nucleotides_per_line) {
+       /*****************************************************************\ 
+      | Append the header (with empty exon lists for empty sequences like |
+      | the constructor from a sequence) and the nucleotide letters       |
+      | written straight into the grown string and break them into lines  |
+      | of the desired length:                                            |
+       \*****************************************************************/
+      std::string exon_starts;
+      std::string exon_ends;
+      if(the_sequence.get_length() != 0)
+      {
+        append_exons(exon_starts,exon_ends,the_sequence);
+      }
+      append_header(FASTA,the_sequence.get_ID(),exon_starts,exon_ends,the_sequence.get_strand(),the_sequence.get_chromosome());
+      const std::string::size_type nucleotides_begin(FASTA.size());
+      FASTA.resize(nucleotides_begin+(the_sequence.end()-the_sequence.begin()));
+      std::string::iterator letter_it(FASTA.begin()+nucleotides_begin);
+      for(sequence::const_iterator sequence_it(the_sequence.begin());sequence_it!=the_sequence.end();++sequence_it,++letter_it)
+      {
+        *letter_it = letter_code(*sequence_it);
+      }
+      wrap_lines(FASTA,nucleotides_begin,nucleotides_per_line);
+}
+
+    /*****************************************************************//**
+    * @brief FASTA header parsing
+    *
+    * This method is used to assign the sequence ID, exon starts, exon
+    * ends, strand and chromosome given in a FASTA header line (without
+    * the leading > sign and the newline) to the entry.
+    * The line must contain at least four pipe (|) characters, additional
+    * ones are taken as part of the sequence ID.
+    * If the line is not a valid header the entry is not changed.
+    *
+    * @param begin const char pointer to the first character of the line
+    * @param end const char pointer behind the last character of the line
+    *
+    * @return true if the line is a valid FASTA header, false otherwise
+    *********************************************************************/
+    bool sequenceFileEntry::set_header(const char * begin, const char * end) {
+       /*****************************************************************\ 
+      | Find the last four pipe characters (the ID may contain more) and  |
+      | make sure the line contains no newline and a valid strand between |
+      | them:                                                             |
+       \*****************************************************************/
+      if(memchr(begin,'\n',end-begin) != NULL)
+      {
+        return false;
+      }
+      const char * pipes[4];
+      const char * field_end(end);
+      for(unsigned short pipe(4);pipe!=0;--pipe)
       {
-        FASTA_stream << sequence_line;
+        while(field_end != begin && *(field_end-1) != '|')
+        {
+          --field_end;
+        }
+        if(field_end == begin)
+        {
+          return false;
+        }
+        pipes[pipe-1] = --field_end;
       }
-      sequenceLength last_line_length(sequence_stream.gcount());
-      if(last_line_length > 0)
+      const std::string strand_field(pipes[2]+1,pipes[3]);
+      if(strand_field != "1" && strand_field != "-1")
       {
-        sequence_line[last_line_length] = '\n';
-        sequence_line[++last_line_length] = '\0';
-        FASTA_stream << sequence_line;
+        return false;
       }
-      return FASTA_stream.str();
+       /**************************************************\ 
+      | Assign the fields to the corresponding attributes: |
+       \**************************************************/
+      ID.assign(begin,pipes[0]);
+      exon_starts.assign(pipes[0]+1,pipes[1]);
+      exon_ends.assign(pipes[1]+1,pipes[2]);
+      strand = strand_field == "1" ? Plus : Minus;
+      chromosome.assign(pipes[3]+1,end);
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a sequenceFileReader for a given file.
+    * If the file cannot be opened for reading the reader is created but
+    * won't return any entries (see @p is_open).
+    * If the file should be mapped but cannot be (e.g. because it is a
+    * pipe or compressed), it is read instead.
+    * Files compressed with gzip are decompressed transparently.
+    * The nucleotides of the entries returned by a reader mapping its
+    * file are only valid as long as the reader exists.
+    *
+    * @param the_path filePath to the sequence file
+    * @param map_file (optional) bool indicating whether the file should
+    *     be memory-mapped - Defaults to false
+    *
+    * @return sequenceFileReader for the given file
+    *
+    * @see is_open()
+    *********************************************************************/
+    sequenceFileReader::sequenceFileReader(const filePath & the_path, bool map_file)
+    :path(the_path),lines(NULL),mapping(NULL),mapping_end(NULL),mapped_position(NULL),line_number(0),read_offset(0),header(""),header_line_number(0),header_offset(0),entry_offset(0),entry_end(0),end_of_file(false) {
+       /***********************************************************\ 
+      | If requested try to map the whole (non-empty, regular and   |
+      | uncompressed) file read-only, telling the system it will be |
+      | read sequentially, otherwise (or if this fails) create a    |
+      | line reader for it (decompressing gzip files):              |
+       \***********************************************************/
+      if(map_file)
+      {
+        const int fd(open(path.c_str(),O_RDONLY));
+        struct stat file_status;
+        if(fd >= 0 && fstat(fd,&file_status) == 0 && S_ISREG(file_status.st_mode) && file_status.st_size > 0 && !gzipDecoder::is_gzip(fd))
+        {
+          void * the_mapping(mmap(NULL,file_status.st_size,PROT_READ,MAP_SHARED,fd,0));
+          if(the_mapping != MAP_FAILED)
+          {
+            madvise(the_mapping,file_status.st_size,MADV_SEQUENTIAL);
+            mapping = static_cast<const char *>(the_mapping);
+            mapping_end = mapping + file_status.st_size;
+            mapped_position = mapping;
+          }
+        }
+        if(fd >= 0)
+        {
+          close(fd);
+        }
+      }
+      if(mapping == NULL)
+      {
+        lines = new lineReader(path);
+      }
+}
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to unmap or close the file read by the reader.
+    *********************************************************************/
+    sequenceFileReader::~sequenceFileReader() {
+      if(mapping != NULL)
+      {
+        munmap(const_cast<char *>(mapping),mapping_end-mapping);
+      }
+      delete lines;
+}
+
+    /*****************************************************************//**
+    * @brief next entry
+    *
+    * This method is used to read the next valid FASTA entry of the file.
+    * A valid FASTA entry starts with the > sign followed by the sequence
+    * ID, a pipe (|) character, a comma-separated list of exon starts,
+    * another pipe character, a comma-separated list of exon ends, another
+    * pipe character, 1 or -1 representing the strand (+ or -,
+    * respectively), a last pipe character, the chromosome name and
+    * linebreak followed by the sequence which may contain newlines but
+    * no > signs.
+    * If the header line containes more than four pipe characters, the
+    * additional one are taken as part of the sequence ID.
+    * Invalid entries and lines outside of any entry are skipped stating
+    * an error.
+    *
+    * @param entry sequenceFileEntry reference the entry is assigned to
+    *
+    * @return true if an entry was assigned, false at the end of the file
+    *     or if the file cannot be read
+    *********************************************************************/
+    bool sequenceFileReader::next(sequenceFileEntry & entry) {
+      fieldView line;
+      while(true)
+      {
+         /*************************************************************\ 
+        | Unless the header was already read with the previous entry,   |
+        | find the next header line stating an error for the first line |
+        | skipped on the way:                                           |
+         \*************************************************************/
+        if(header.empty())
+        {
+          bool skipping(false);
+          while(true)
+          {
+            if(!next_line(line))
+            {
+              return false;
+            }
+            if(line.begin != line.end && *line.begin == '>')
+            {
+              break;
+            }
+            if(!skipping)
+            {
+              std::cerr << "microSNPscore::sequenceFileReader::next\n";
+              std::cerr << " ==> line " << line_number << " of " << path;
+              std::cerr << " does not belong to any FASTA entry\n";
+              std::cerr << "  --> skipping lines up to the next header\n";
+              skipping = true;
+            }
+          }
+          header.assign(line.begin,line.end);
+          header_line_number = line_number;
+          header_offset = read_offset - (line.end - line.begin) - 1;
+        }
+         /***************************************************************\ 
+        | Parse the header and append the following lines to the entry's  |
+        | sequence (or extend the entry's view of the mapping over them)  |
+        | until the next header (which is kept for the next entry) or the |
+        | end of the file, checking for > signs on the way:               |
+         \***************************************************************/
+        const unsigned long entry_line_number(header_line_number);
+        entry_offset = header_offset;
+        entry_end = read_offset;
+        bool valid(entry.set_header(header.data()+1,header.data()+header.size()));
+        const std::string invalid_header(valid ? "" : header);
+        header.clear();
+        entry.nucleotide_sequence.clear();
+        entry.mapped_begin = NULL;
+        entry.mapped_end = NULL;
+        while(next_line(line))
+        {
+          if(line.begin != line.end && *line.begin == '>')
+          {
+            header.assign(line.begin,line.end);
+            header_line_number = line_number;
+            header_offset = read_offset - (line.end - line.begin) - 1;
+            break;
+          }
+          entry_end = read_offset;
+          if(valid && memchr(line.begin,'>',line.end-line.begin) != NULL)
+          {
+            std::cerr << "microSNPscore::sequenceFileReader::next\n";
+            std::cerr << " ==> line " << line_number << " of " << path;
+            std::cerr << " contains a > sign inside a sequence\n";
+            std::cerr << "  --> skipping FASTA entry starting in line " << entry_line_number << std::endl;
+            valid = false;
+          }
+          if(valid && mapping != NULL)
+          {
+            if(entry.mapped_begin == NULL)
+            {
+              entry.mapped_begin = line.begin;
+            }
+            entry.mapped_end = line.end;
+          }
+          else if(valid)
+          {
+            entry.nucleotide_sequence.append(line.begin,line.end);
+          }
+        }
+        if(valid)
+        {
+          return true;
+        }
+        if(!invalid_header.empty())
+        {
+          std::cerr << "microSNPscore::sequenceFileReader::next\n";
+          std::cerr << " ==> no valid FASTA header in line " << entry_line_number << " of " << path << ":\n";
+          std::cerr << invalid_header << std::endl;
+          std::cerr << "  --> skipping FASTA entry\n";
+        }
+      } // true
+}
+
+    /*****************************************************************//**
+    * @brief next line
+    *
+    * This method is used to get the next line of the file counting the
+    * lines read.
+    * At the end of the file an error is stated if its last line is not
+    * terminated by a newline (since the line is ignored).
+    *
+    * @param line fieldView reference the line is assigned to
+    *
+    * @return true if a line was assigned, false at the end of the file
+    *********************************************************************/
+    bool sequenceFileReader::next_line(fieldView & line) {
+      if(end_of_file)
+      {
+        return false;
+      }
+       /***************************************************************\ 
+      | Take the next line from the mapping or the line reader stating  |
+      | an error if the end of the file is reached before its last line |
+      | is terminated:                                                  |
+       \***************************************************************/
+      if(mapping != NULL)
+      {
+        const char * newline(static_cast<const char *>(memchr(mapped_position,'\n',mapping_end-mapped_position)));
+        if(newline != NULL)
+        {
+          line.begin = mapped_position;
+          line.end = newline;
+          mapped_position = newline + 1;
+          read_offset = mapped_position - mapping;
+          ++line_number;
+          return true;
+        }
+      }
+      else if(lines->next_line(line))
+      {
+        read_offset = lines->get_offset();
+        ++line_number;
+        return true;
+      }
+      end_of_file = true;
+      if(mapping != NULL ? mapped_position != mapping_end : lines->is_open() && !lines->at_end())
+      {
+        std::cerr << "microSNPscore::sequenceFileReader::next\n";
+        std::cerr << " ==> line " << line_number + 1 << " of " << path;
+        std::cerr << " is not terminated by a newline\n";
+        std::cerr << "  --> ignoring the line\n";
+      }
+      return false;
 }
 
     /*****************************************************************//**
@@ -201,24 +666,20 @@ namespace microSNPscore {
     * file to the sequence file's entries.
     * If the file does not exist or does not contain any valid FASTA
     * entires an error is raised and no sequence file entry is created.
-    * A valid FASTA entry starts with the > sign followed by the sequence
-    * ID, a pipe (|) character, a comma-separated list of exon starts,
-    * another pipe character, a comma-separated list of exon ends, another
-    * pipe character, 1 or -1 representing the strand (+ or -,
-    * respectively), a last pipe character, the chromosome name and
-    * linebreak followed by the sequence which may contain newlines but
-    * must end with a newline.
-    * If the header line containes more than four pipe characters, the
-    * additional one are taken as part of the sequence ID.
+    * Invalid entries are skipped stating an error (see
+    * sequenceFileReader::next() for the valid format).
+    *
+    * @see sequenceFileReader
     *********************************************************************/
     void sequenceFile::read() {
-       /**********************************************************\ 
-      | Try to open an input file stream associated to the file    |
-      | corresponding to the sequence file's path stating an error |
-      | in the case of failure:                                    |
-       \**********************************************************/
-      std::ifstream FASTA_file(path.c_str());
-      if(FASTA_file.fail())
+       /********************************************************\ 
+      | Try to open a reader for the file corresponding to the   |
+      | sequence file's path stating an error in the case of     |
+      | failure and append its entries one after another stating |
+      | an error if there is none:                               |
+       \********************************************************/
+      sequenceFileReader reader(path);
+      if(!reader.is_open())
       {
         std::cerr << "microSNPscore::sequenceFile::sequenceFile\n";
         std::cerr << " ==> Cannot open file to read from: ";
@@ -227,74 +688,100 @@ namespace microSNPscore {
       }
       else
       {
-         /******************************************************************\ 
-        | Try to initialize extended regular expression matching a valid     |
-        | FASTA file stating error in case of failure:                       |
-         \******************************************************************/
-        regex_t regex_FASTA_file;
-        char pattern_FASTA_file[] = "^(>[^\n]*[|][^|\n]*[|][^|\n]*[|]-?1[|][^|\n]*\n[^>]*)+$";
-        if(regcomp(&regex_FASTA_file,pattern_FASTA_file,REG_EXTENDED|REG_NOSUB) != 0)
+        const std::vector<sequenceFileEntry>::size_type previous_size(entries.size());
+        sequenceFileEntry entry;
+        while(reader.next(entry))
+        {
+          entries.push_back(entry);
+        }
+        if(entries.size() == previous_size)
         {
           std::cerr << "microSNPscore::sequenceFile::read\n";
-          std::cerr << " ==> compiling FASTA file regular expression failed\n";
+          std::cerr << " ==> no valid FASTA entries in file: ";
+          std::cerr << path << std::endl;
           std::cerr << "  --> no sequences will be read from the file\n";
         }
-        else
+      } // reader.is_open()
+}
+
+    /*****************************************************************//**
+    * @brief read requested entries using the index
+    *
+    * This method is used to read only the entries of the sequences with
+    * the given IDs using the index of the file (see sequenceFileIndex),
+    * appending them to the sequence file's entries in file order.
+    * IDs not contained in the index are ignored.
+    * If the file has no up to date index nothing is read, so the caller
+    * may read the whole file instead.
+    *
+    * @param IDs const std::set reference to the IDs of the sequences to
+    *     be read
+    *
+    * @return true if the index was used, false otherwise
+    *
+    * @see sequenceFileIndex::build()
+    *********************************************************************/
+    bool sequenceFile::read(const std::set<sequenceID> & IDs) {
+       /*************************************************************\ 
+      | Look up the locations of the requested entries in the index   |
+      | (if there is an up to date one) and sort them by their offset |
+      | to read the file in one direction:                            |
+       \*************************************************************/
+      sequenceFileIndex index(path);
+      if(!index.is_loaded())
+      {
+        return false;
+      }
+      std::vector<std::pair<off_t,off_t> > locations;
+      for(std::set<sequenceID>::const_iterator ID_it(IDs.begin());ID_it!=IDs.end();++ID_it)
+      {
+        off_t offset(0);
+        off_t size(0);
+        if(index.find(*ID_it,offset,size))
         {
-           /****************************************************************\ 
-          | Read the content of the file into string stream, convert it to a |
-          | string and a c-type string and try to match the initialized      |
-          | regular expression stating error in case of failure:             |
-           \****************************************************************/
-          std::stringstream FASTA_file_stream;
-          FASTA_file_stream << FASTA_file.rdbuf();
-          FASTA_file.close();
-          std::string FASTA_file_string(FASTA_file_stream.str());
-          const char * FASTA_file_cstring = FASTA_file_string.c_str();
-          if(regexec(&regex_FASTA_file,FASTA_file_cstring,(size_t) 0,NULL,0) != 0)
+          locations.push_back(std::make_pair(offset,size));
+        }
+      }
+      std::sort(locations.begin(),locations.end());
+       /************************************************************\ 
+      | Try to open the file stating an error in the case of failure |
+      | and read and parse the requested entries one after another:  |
+       \************************************************************/
+      const int fd(open(path.c_str(),O_RDONLY));
+      if(fd < 0)
+      {
+        std::cerr << "microSNPscore::sequenceFile::read\n";
+        std::cerr << " ==> Cannot open file to read from: ";
+        std::cerr << path << std::endl;
+        std::cerr << "  --> no sequences will be read from the file\n";
+        return true;
+      }
+      std::string FASTA_entry;
+      for(std::vector<std::pair<off_t,off_t> >::const_iterator location_it(locations.begin());location_it!=locations.end();++location_it)
+      {
+        FASTA_entry.resize(location_it->second);
+        off_t bytes_read(0);
+        while(bytes_read < location_it->second)
+        {
+          const ssize_t bytes(pread(fd,&FASTA_entry[bytes_read],location_it->second-bytes_read,location_it->first+bytes_read));
+          if(bytes <= 0 && !(bytes < 0 && errno == EINTR))
           {
-            std::cerr << "microSNPscore::sequenceFile::read\n";
-            std::cerr << " ==> no valid FASTA file:\n";
-            std::cerr << FASTA_file_string << std::endl;
-            std::cerr << "  --> creating empty default sequence\n";
+            break;
           }
-          else
-          {
-             /******************************************************************\ 
-            | Try to initialize extended regular expression matching a valid     |
-            | FASTA entry stating error in case of failure:                      |
-             \******************************************************************/
-            regex_t regex_FASTA_entry;
-            char pattern_FASTA_entry[] = "^>[^\n]*[|][^|\n]*[|][^|\n]*[|]-?1[|][^|\n]*\n[^>]*";
-            if(regcomp(&regex_FASTA_entry,pattern_FASTA_entry,REG_EXTENDED) != 0)
-            {
-              std::cerr << "microSNPscore::sequenceFile::read\n";
-              std::cerr << " ==> compiling FASTA entry regular expression failed\n";
-              std::cerr << "  --> no sequences will be read from the file\n";
-            }
-            else
-            {
-               /*************************************************************\ 
-              | Match the initialized regular expression as often as possible |
-              | (at least one time because it matches valid FAST file regex)  |
-              | inserting a sequence file entry for every match found:        |
-               \*************************************************************/
-              size_t nmatch_FASTA_entry(1);
-              regmatch_t pmatch_FASTA_entry[nmatch_FASTA_entry];
-              regoff_t start(0);
-              regoff_t end(0);
-              regexec(&regex_FASTA_entry,FASTA_file_cstring,nmatch_FASTA_entry,pmatch_FASTA_entry,0);
-              do
-              {
-                start = end + pmatch_FASTA_entry[0].rm_so;
-                end += pmatch_FASTA_entry[0].rm_eo;
-                entries.push_back(sequenceFileEntry(FASTA_file_string.substr(start,end-start)));
-              }
-              while(regexec(&regex_FASTA_entry,FASTA_file_cstring+end,nmatch_FASTA_entry,pmatch_FASTA_entry,0) == 0);
-            } // regcomp(&regex_FASTA_entry,pattern_FASTA_entry,REG_EXTENDED) == 0
-          } // regexec(&regex_FASTA_file,FASTA_file_cstring,(size_t) 0,NULL,0) == 0
-        } // regcomp(&regex_FASTA_file,pattern_FASTA_file,REG_EXTENDED|REG_NOSUB) == 0
-      } // ! FASTA_file.fail()
+          bytes_read += std::max<ssize_t>(bytes,0);
+        }
+        if(bytes_read != location_it->second)
+        {
+          std::cerr << "microSNPscore::sequenceFile::read\n";
+          std::cerr << " ==> Cannot read indexed entry at offset " << location_it->first << " of file: ";
+          std::cerr << path << std::endl;
+          std::cerr << "  --> skipping entry\n";
+          continue;
+        }
+        entries.push_back(sequenceFileEntry(FASTA_entry));
+      }
+      close(fd);
+      return true;
 }
 
     /*****************************************************************//**
@@ -318,8 +805,9 @@ namespace microSNPscore {
        /*****************************************************************\ 
       | Try to open an outut file stream associated to the file           |
       | corresponding to the sequence file's path stating an error in the |
-      | case of failure and iterate over the entries inserting each one   |
-      | into the output stream before closing the output file stream:     |
+      | case of failure and iterate over the entries appending each one   |
+      | to a buffer reused for all of them and writing it to the output   |
+      | stream before closing the output file stream:                     |
        \*****************************************************************/
       std::ofstream the_file(path.c_str());
       if(the_file.fail())
@@ -331,9 +819,12 @@ namespace microSNPscore {
       }
       else
       {
+        std::string FASTA;
         for(const_iterator entry_it(begin());entry_it!=end();++entry_it)
         {
-          the_file << *entry_it;
+          FASTA.clear();
+          entry_it->append_FASTA(FASTA);
+          the_file.write(FASTA.data(),FASTA.size());
         }
         the_file.close();
       }
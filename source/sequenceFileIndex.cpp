@@ -0,0 +1,249 @@
+#include <iostream>
+//for std::cerr and std::endl (error stating)
+#include <fstream>
+//for std::ofstream (index writing)
+#include <sstream>
+//for std::ostringstream (signature composition)
+#include <set>
+//for std::set (duplicate ID detection)
+#include <cstdio>
+//for std::rename (index replacement)
+#include <sys/stat.h>
+//for stat (file signature)
+#include "sequenceFileIndex.h"
+#include "sequenceFile.h"
+#include "lineReader.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief offset field conversion
+    *
+    * This is used to convert a field consisting of decimal digits only
+    * to a file offset or size.
+    *
+    * @param field const fieldView reference to the field
+    * @param value off_t reference the value is assigned to
+    *
+    * @return true if the field is a non-empty digit string not exceeding
+    *     the range of off_t, false otherwise
+    *********************************************************************/
+    static bool parse_offset(const fieldView & field, off_t & value) {
+      if(field.begin == field.end)
+      {
+        return false;
+      }
+      value = 0;
+      for(const char * digit(field.begin);digit!=field.end;++digit)
+      {
+        if(*digit < '0' || *digit > '9' || value > (off_t(1) << (sizeof(off_t) * 8 - 5)))
+        {
+          return false;
+        }
+        value = value * 10 + (*digit - '0');
+      }
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to load the index of a given sequence file.
+    * If there is no index the sequenceFileIndex is created but not
+    * loaded (see @p is_loaded).
+    * If the index is out of date or invalid an error is raised and it is
+    * not loaded either.
+    *
+    * @param the_path filePath to the sequence file (not to the index)
+    *
+    * @return sequenceFileIndex for the given sequence file
+    *
+    * @see is_loaded()
+    *********************************************************************/
+    sequenceFileIndex::sequenceFileIndex(const filePath & the_path)
+    :loaded(false) {
+       /***************************************************************\ 
+      | If there is an index, make sure its header matches the sequence |
+      | file's current signature stating an error if it does not:       |
+       \***************************************************************/
+      lineReader index_file(get_path(the_path));
+      fieldView line;
+      if(!index_file.is_open() || !index_file.next_line(line))
+      {
+        return;
+      }
+      std::string signature;
+      if(!get_signature(the_path,signature) || signature != std::string(line.begin,line.end))
+      {
+        std::cerr << "microSNPscore::sequenceFileIndex::sequenceFileIndex\n";
+        std::cerr << " ==> index is out of date: ";
+        std::cerr << get_path(the_path) << std::endl;
+        std::cerr << "  --> not using the index (rebuild it to use it again)\n";
+        return;
+      }
+       /**************************************************************\ 
+      | Read the locations of the entries (an ID may contain tabs) and |
+      | drop the whole index if a line is invalid stating an error:    |
+       \**************************************************************/
+      unsigned long line_number(1);
+      while(index_file.next_line(line))
+      {
+        ++line_number;
+        fieldView fields[3];
+        off_t offset(0);
+        off_t size(0);
+        if(!lineReader::split_fields(line,fields,3,true) || !parse_offset(fields[1],offset) || !parse_offset(fields[2],size))
+        {
+          std::cerr << "microSNPscore::sequenceFileIndex::sequenceFileIndex\n";
+          std::cerr << " ==> no valid index line in line " << line_number << " of ";
+          std::cerr << get_path(the_path) << ":\n";
+          std::cerr << std::string(line.begin,line.end) << std::endl;
+          std::cerr << "  --> not using the index (rebuild it to use it again)\n";
+          locations.clear();
+          return;
+        }
+        locations.insert(std::make_pair(sequenceID(fields[0].begin,fields[0].end),std::make_pair(offset,size)));
+      }
+      loaded = true;
+}
+
+    /*****************************************************************//**
+    * @brief entry location
+    *
+    * This method is used to find the location of the entry of a given
+    * sequence in the sequence file.
+    *
+    * @param ID const sequenceID reference to the ID of the sequence
+    * @param offset off_t reference the entry's offset is assigned to
+    * @param size off_t reference the entry's size is assigned to
+    *
+    * @return true if the sequence is contained in the index, false
+    *     otherwise
+    *********************************************************************/
+    bool sequenceFileIndex::find(const sequenceID & ID, off_t & offset, off_t & size) const {
+      std::map<sequenceID,std::pair<off_t,off_t> >::const_iterator location_it(locations.find(ID));
+      if(location_it == locations.end())
+      {
+        return false;
+      }
+      offset = location_it->second.first;
+      size = location_it->second.second;
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief index creation
+    *
+    * This method is used to create (or replace) the index of a given
+    * sequence file.
+    * Like a sequenceFile, the index keeps the first entry for IDs
+    * occurring more than once, invalid entries are skipped.
+    * If the sequence file cannot be read, is compressed or the index
+    * cannot be written an error is raised.
+    *
+    * @param the_path filePath to the sequence file
+    *
+    * @return true if the index was written, false otherwise
+    *********************************************************************/
+    bool sequenceFileIndex::build(const filePath & the_path) {
+       /************************************************************\ 
+      | Try to map the sequence file and to create a temporary index |
+      | stating an error in the case of failure:                     |
+       \************************************************************/
+      sequenceFileReader reader(the_path,true);
+      std::string signature;
+      if(!reader.is_open() || !get_signature(the_path,signature))
+      {
+        std::cerr << "microSNPscore::sequenceFileIndex::build\n";
+        std::cerr << " ==> Cannot open file to read from: ";
+        std::cerr << the_path << std::endl;
+        std::cerr << "  --> no index will be created\n";
+        return false;
+      }
+      if(reader.is_compressed())
+      {
+        std::cerr << "microSNPscore::sequenceFileIndex::build\n";
+        std::cerr << " ==> Cannot index compressed file: ";
+        std::cerr << the_path << std::endl;
+        std::cerr << "  --> no index will be created (decompress it to index it)\n";
+        return false;
+      }
+      const filePath temporary_path(get_path(the_path)+".tmp");
+      std::ofstream index_file(temporary_path.c_str());
+      if(index_file.fail())
+      {
+        std::cerr << "microSNPscore::sequenceFileIndex::build\n";
+        std::cerr << " ==> Cannot open file to write to: ";
+        std::cerr << temporary_path << std::endl;
+        std::cerr << "  --> no index will be created\n";
+        return false;
+      }
+       /***************************************************************\ 
+      | Write the signature and the location of the first entry of each |
+      | ID and replace the index by the temporary one if all went well: |
+       \***************************************************************/
+      index_file << signature << '\n';
+      std::set<sequenceID> IDs;
+      sequenceFileEntry entry;
+      while(reader.next(entry))
+      {
+        if(IDs.insert(entry.get_ID()).second)
+        {
+          index_file << entry.get_ID() << '\t' << reader.get_entry_offset() << '\t' << reader.get_entry_size() << '\n';
+        }
+      }
+      index_file.close();
+      if(index_file.fail() || std::rename(temporary_path.c_str(),get_path(the_path).c_str()) != 0)
+      {
+        std::cerr << "microSNPscore::sequenceFileIndex::build\n";
+        std::cerr << " ==> Cannot write index: ";
+        std::cerr << get_path(the_path) << std::endl;
+        std::cerr << "  --> no index will be created\n";
+        std::remove(temporary_path.c_str());
+        return false;
+      }
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief index path
+    *
+    * This method is used to get the path of the index of a given
+    * sequence file (i.e. the path of the sequence file followed by
+    * ".idx").
+    *
+    * @param the_path filePath to the sequence file
+    *
+    * @return filePath to the index of the sequence file
+    *********************************************************************/
+    filePath sequenceFileIndex::get_path(const filePath & the_path) {
+      return the_path + ".idx";
+}
+
+    /*****************************************************************//**
+    * @brief file signature
+    *
+    * This method is used to create the header line of the index of a
+    * given sequence file from its current size and modification time.
+    *
+    * @param the_path filePath to the sequence file
+    * @param signature std::string reference the header line (without
+    *     newline) is assigned to
+    *
+    * @return true if the sequence file's status could be read, false
+    *     otherwise
+    *********************************************************************/
+    bool sequenceFileIndex::get_signature(const filePath & the_path, std::string & signature) {
+      struct stat file_status;
+      if(stat(the_path.c_str(),&file_status) != 0)
+      {
+        return false;
+      }
+      std::ostringstream signature_stream;
+      signature_stream << "#microSNPscore sequence file index\t" << file_status.st_size << '\t' << file_status.st_mtime;
+      signature = signature_stream.str();
+      return true;
+}
+
+
+} // namespace microSNPscore
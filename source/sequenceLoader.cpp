@@ -0,0 +1,367 @@
+#include <string>
+//for std::string (capture targets)
+#include <iostream>
+//for std::cerr and std::endl (error stating)
+#include <set>
+//for std::set (requested IDs)
+#include <vector>
+//for std::vector (chunks of entries)
+#include <algorithm>
+//for std::min (database reservation)
+#include <unistd.h>
+//for sysconf (processor count)
+#include <pthread.h>
+//for pthread_create and pthread_join (sequence creation threads)
+#include "sequenceFile.h"
+#include "sequenceDatabase.h"
+#include "referenceGenome.h"
+#include "transcriptAnnotation.h"
+#include "messageCapture.h"
+#include "sequenceLoader.h"
+
+namespace microSNPscore {
+
+/*****************************************************************//**
+* @brief processor count
+*
+* This is used to get the number of processors online (at least one).
+*
+* @return unsigned int representing the number of processors
+*********************************************************************/
+unsigned int processor_count()
+{
+  const long processors(sysconf(_SC_NPROCESSORS_ONLN));
+  return processors < 1 ? 1 : processors;
+}
+
+template<class T>
+struct sequenceCreation {
+  const std::vector<const sequenceFileEntry *> * entries;
+  std::vector<T> * sequences;
+  std::vector<std::string> * messages;
+  T (sequenceFileEntry::*create)(bool) const;
+  bool verbose;
+  size_t first;
+  size_t step;
+};
+
+template<class T>
+void * create_sequences(void * argument)
+{
+   /***************************************************************\ 
+  | Create every step-th sequence of the chunk collecting the error |
+  | messages of each one separately and swap it into its slot:      |
+   \***************************************************************/
+  const sequenceCreation<T> & job(*static_cast<sequenceCreation<T> *>(argument));
+  for(size_t entry_index(job.first);entry_index<job.entries->size();entry_index+=job.step)
+  {
+    messageCapture::set_target(&(*job.messages)[entry_index]);
+    T created(((*(*job.entries)[entry_index]).*job.create)(job.verbose));
+    (*job.sequences)[entry_index].swap(created);
+  }
+  messageCapture::set_target(NULL);
+  return NULL;
+}
+
+template<class T>
+void create_sequence_chunk(entityTable<sequenceID,T> & table, const std::vector<const sequenceFileEntry *> & entries,
+                           std::vector<std::string> & messages, T (sequenceFileEntry::*create)(bool) const,
+                           bool verbose, unsigned int threads)
+{
+   /**************************************************************\ 
+  | Create the sequences of the chunk on the given number of       |
+  | threads (doing the share of threads that could not be started  |
+  | here) and hand them over to the table printing the messages of |
+  | each one in the order of the entries:                          |
+   \**************************************************************/
+  std::vector<T> sequences(entries.size());
+  std::vector<sequenceCreation<T> > jobs(threads);
+  std::vector<pthread_t> thread_IDs(threads);
+  std::vector<bool> started(threads,false);
+  for(unsigned int thread_index(0);thread_index!=threads;++thread_index)
+  {
+    const sequenceCreation<T> job = {&entries,&sequences,&messages,create,verbose,thread_index,threads};
+    jobs[thread_index] = job;
+    if(thread_index != 0)
+    {
+      started[thread_index] = pthread_create(&thread_IDs[thread_index],NULL,create_sequences<T>,&jobs[thread_index]) == 0;
+    }
+  }
+  create_sequences<T>(&jobs[0]);
+  for(unsigned int thread_index(1);thread_index<threads;++thread_index)
+  {
+    if(started[thread_index])
+    {
+      pthread_join(thread_IDs[thread_index],NULL);
+    }
+    else
+    {
+      create_sequences<T>(&jobs[thread_index]);
+    }
+  }
+  for(size_t entry_index(0);entry_index!=entries.size();++entry_index)
+  {
+    std::cerr << messages[entry_index];
+    table.adopt(sequences[entry_index].get_ID(),sequences[entry_index]);
+  }
+}
+
+template<class T>
+void read_sequence_file(entityTable<sequenceID,T> & table, const filePath & path,
+                        T (sequenceFileEntry::*create)(bool) const,
+                        bool verbose,
+                        const std::set<sequenceID> * IDs)
+{
+   /**************************************************************\ 
+  | Capture the messages of all threads while creating the         |
+  | sequences in chunks of entries on one thread per processor, so |
+  | they can be printed as if the sequences were created one after |
+  | another:                                                       |
+   \**************************************************************/
+  const unsigned int threads(processor_count());
+  const size_t chunk_size(threads * 64);
+  messageCapture capture(std::cerr);
+  std::vector<const sequenceFileEntry *> chunk;
+  std::vector<std::string> messages(1);
+   /**************************************************************\ 
+  | If only the given sequences are needed and the file is indexed |
+  | read just their entries, otherwise map the file (sharing its   |
+  | pages with other processes), read it entry by entry decoding   |
+  | the nucleotides directly from the mapping and insert the       |
+  | sequences (only those requested if IDs are given):             |
+   \**************************************************************/
+  sequenceFile indexed_file(path);
+  if(IDs != NULL && indexed_file.read(*IDs))
+  {
+    for(sequenceFile::const_iterator entry_it(indexed_file.begin());entry_it!=indexed_file.end();++entry_it)
+    {
+      chunk.push_back(&*entry_it);
+      if(chunk.size() == chunk_size)
+      {
+        messages.assign(chunk_size,std::string());
+        create_sequence_chunk(table,chunk,messages,create,verbose,threads);
+        chunk.clear();
+      }
+    }
+    messages.assign(chunk.size(),std::string());
+    create_sequence_chunk(table,chunk,messages,create,verbose,threads);
+    return;
+  }
+  sequenceFileReader file(path,true);
+  if(!file.is_open())
+  {
+    std::cerr << "microSNPscore::read_sequence_file\n";
+    std::cerr << " ==> Cannot open file to read from: ";
+    std::cerr << path << std::endl;
+    std::cerr << "  --> no sequences will be read from the file\n";
+  }
+   /***************************************************************\ 
+  | Collect the messages of reading an entry (including those of    |
+  | the entries skipped before) in the slot of the entry's sequence |
+  | and create the sequences whenever a chunk is complete:          |
+   \***************************************************************/
+  std::vector<sequenceFileEntry> entries(chunk_size);
+  messageCapture::set_target(&messages[0]);
+  while(file.next(entries[chunk.size()]))
+  {
+    if(IDs == NULL || IDs->count(entries[chunk.size()].get_ID()) != 0)
+    {
+      chunk.push_back(&entries[chunk.size()]);
+      messages.push_back(std::string());
+      if(chunk.size() == chunk_size)
+      {
+        messageCapture::set_target(NULL);
+        create_sequence_chunk(table,chunk,messages,create,verbose,threads);
+        chunk.clear();
+        messages.erase(messages.begin(),messages.end()-1);
+      }
+      messageCapture::set_target(&messages.back());
+    }
+  }
+  messageCapture::set_target(NULL);
+  create_sequence_chunk(table,chunk,messages,create,verbose,threads);
+  std::cerr << messages.back();
+}
+
+template<class T>
+void read_annotated_sequences(entityTable<sequenceID,T> & table, const filePath & annotation_path, const filePath & genome_path,
+                              T (sequenceFileEntry::*create)(bool) const,
+                              bool verbose,
+                              const std::set<sequenceID> * IDs)
+{
+   /***************************************************************\ 
+  | Read the annotation and map the genome, take the entries of the |
+  | transcripts (only those requested if IDs are given, checking    |
+  | the ID before extracting a sequence) from the genome and create |
+  | the sequences in chunks like those of a sequence file:          |
+   \***************************************************************/
+  const transcriptAnnotation annotation(annotation_path);
+  const referenceGenome genome(genome_path);
+  const unsigned int threads(processor_count());
+  const size_t chunk_size(threads * 64);
+  messageCapture capture(std::cerr);
+  std::vector<sequenceFileEntry> entries(chunk_size);
+  std::vector<const sequenceFileEntry *> chunk;
+  std::vector<std::string> messages(1);
+  messageCapture::set_target(&messages[0]);
+  for(unsigned long index(0);index!=annotation.size() && genome.is_open();++index)
+  {
+    if((IDs == NULL || IDs->count(annotation.get_ID(index)) != 0) && annotation.get_entry(index,genome,entries[chunk.size()]))
+    {
+      chunk.push_back(&entries[chunk.size()]);
+      messages.push_back(std::string());
+      if(chunk.size() == chunk_size)
+      {
+        messageCapture::set_target(NULL);
+        create_sequence_chunk(table,chunk,messages,create,verbose,threads);
+        chunk.clear();
+        messages.erase(messages.begin(),messages.end()-1);
+      }
+      messageCapture::set_target(&messages.back());
+    }
+  }
+  messageCapture::set_target(NULL);
+  create_sequence_chunk(table,chunk,messages,create,verbose,threads);
+  std::cerr << messages.back();
+}
+
+template<class T>
+void read_sequence_database(entityTable<sequenceID,T> & table, const filePath & path,
+                            T (sequenceDatabase::*create)(unsigned long) const,
+                            const std::set<sequenceID> * IDs)
+{
+   /**************************************************************\ 
+  | Map the database, make room for the sequences and insert them  |
+  | (only those requested if IDs are given, checking the ID before |
+  | decoding a sequence):                                          |
+   \**************************************************************/
+  sequenceDatabase database(path);
+  table.reserve(table.size() + (IDs != NULL ? std::min<unsigned long>(IDs->size(),database.size()) : database.size()));
+  for(unsigned long index(0);index!=database.size();++index)
+  {
+    if(IDs == NULL || IDs->count(database.get_ID(index)) != 0)
+    {
+      T the_sequence((database.*create)(index));
+      table.adopt(the_sequence.get_ID(),the_sequence);
+    }
+  }
+}
+
+/*****************************************************************//**
+* @brief mRNA reading
+*
+* This is used to read the mRNAs from the given file into their table.
+* The file may be a FASTA file (indexed or not, possibly compressed) or
+* a sequence database, or a transcript annotation if a genome is given.
+*
+* @param table entityTable reference to the table the mRNAs should be
+*     inserted into
+* @param path filePath of the mRNA file
+* @param verbose bool indicating whether the mRNAs should be created
+*     verbosely
+* @param IDs std::set pointer to the IDs of the mRNAs needed (or NULL
+*     to read all of them)
+* @param genome_path filePath of the genome the annotated mRNAs are
+*     taken from (or empty if the file is no annotation)
+*********************************************************************/
+void read_mRNAs(entityTable<sequenceID,mRNA> & table, const filePath & path,
+                bool verbose,
+                const std::set<sequenceID> * IDs,
+                const filePath & genome_path)
+{
+     /**************************************************************\ 
+    | Take the mRNAs from the genome if an annotation is given, else |
+    | decode them from the database or create them from the file:    |
+     \**************************************************************/
+    if(!genome_path.empty())
+    {
+      read_annotated_sequences(table,path,genome_path,&sequenceFileEntry::get_mRNA,verbose,IDs);
+    }
+    else if(sequenceDatabase::is_database(path))
+    {
+      read_sequence_database(table,path,&sequenceDatabase::get_mRNA,IDs);
+    }
+    else
+    {
+      read_sequence_file(table,path,&sequenceFileEntry::get_mRNA,verbose,IDs);
+    }
+}
+
+/*****************************************************************//**
+* @brief miRNA reading
+*
+* This is used to read the miRNAs from the given file into their table.
+* The file may be a FASTA file (indexed or not, possibly compressed) or
+* a sequence database.
+*
+* @param table entityTable reference to the table the miRNAs should be
+*     inserted into
+* @param path filePath of the miRNA file
+* @param verbose bool indicating whether the miRNAs should be created
+*     verbosely
+* @param IDs std::set pointer to the IDs of the miRNAs needed (or NULL
+*     to read all of them)
+*********************************************************************/
+void read_miRNAs(entityTable<sequenceID,miRNA> & table, const filePath & path,
+                 bool verbose,
+                 const std::set<sequenceID> * IDs)
+{
+     /**************************************************\ 
+    | Decode the miRNAs from the database or create them |
+    | from the file:                                     |
+     \**************************************************/
+    if(sequenceDatabase::is_database(path))
+    {
+      read_sequence_database(table,path,&sequenceDatabase::get_miRNA,IDs);
+    }
+    else
+    {
+      read_sequence_file(table,path,&sequenceFileEntry::get_miRNA,verbose,IDs);
+    }
+}
+
+/*****************************************************************//**
+* @brief sequence reading
+*
+* This is used to read the mRNAs and miRNAs from the given files into
+* their tables.
+* Each file may be a FASTA file (indexed or not, possibly compressed)
+* or a sequence database, the mRNA file is a transcript annotation if
+* a genome is given.
+* The sequences of FASTA files and annotations are created on one
+* thread per processor, the messages are printed in the order of the
+* entries nonetheless.
+*
+* @param mRNA_table entityTable reference to the table the mRNAs
+*     should be inserted into
+* @param mRNA_path filePath of the mRNA file
+* @param miRNA_table entityTable reference to the table the miRNAs
+*     should be inserted into
+* @param miRNA_path filePath of the miRNA file
+* @param verbose bool indicating whether the sequences should be
+*     created verbosely
+* @param mRNA_IDs std::set pointer to the IDs of the mRNAs needed (or
+*     NULL to read all of them)
+* @param miRNA_IDs std::set pointer to the IDs of the miRNAs needed (or
+*     NULL to read all of them)
+* @param genome_path filePath of the genome the annotated mRNAs are
+*     taken from (or empty if the mRNA file is no annotation)
+*********************************************************************/
+void read_sequences(entityTable<sequenceID,mRNA> & mRNA_table, const filePath & mRNA_path,
+                    entityTable<sequenceID,miRNA> & miRNA_table, const filePath & miRNA_path,
+                    bool verbose,
+                    const std::set<sequenceID> * mRNA_IDs,
+                    const std::set<sequenceID> * miRNA_IDs,
+                    const filePath & genome_path)
+{
+     /***************************************************************\ 
+    | Read the given files and insert the corresponing sequences into |
+    | their tables (if IDs are given, only the sequences requested    |
+    | are created) - the mRNA file is an annotation if a genome is    |
+    | given:                                                          |
+     \***************************************************************/
+    read_mRNAs(mRNA_table,mRNA_path,verbose,mRNA_IDs,genome_path);
+    read_miRNAs(miRNA_table,miRNA_path,verbose,miRNA_IDs);
+}
+
+} // namespace microSNPscore
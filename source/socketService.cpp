@@ -0,0 +1,384 @@
+#include <iostream>
+//for std::cerr and std::endl (error stating)
+#include <unistd.h>
+//for fork, read, write, close and unlink (connections)
+#include <fcntl.h>
+//for fcntl (non-blocking client socket)
+#include <poll.h>
+//for poll (waiting for the client socket)
+#include <signal.h>
+//for sigaction (stopping the server and reaping connection processes)
+#include <sys/socket.h>
+//for socket, bind, listen, accept, connect and shutdown (socket access)
+#include <sys/un.h>
+//for sockaddr_un (Unix domain socket addresses)
+#include <sys/stat.h>
+//for lstat (stale socket detection)
+#include <sys/wait.h>
+//for waitpid (connection process termination)
+#include <errno.h>
+//for errno (error stating)
+#include <string.h>
+//for strerror, strncpy and memset (error stating and addresses)
+#include "socketService.h"
+#include "lineReader.h"
+#include "resultWriter.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief stop flag
+    *
+    * This is set by the signal handler when the server should stop.
+    *********************************************************************/
+    static volatile sig_atomic_t stop_requested(0);
+
+    /*****************************************************************//**
+    * @brief stop signal handler
+    *
+    * This is used to request the server to stop.
+    *
+    * @param the_signal int representing the signal received
+    *********************************************************************/
+    static void request_stop(int /* the_signal */) {
+      stop_requested = 1;
+}
+
+    /*****************************************************************//**
+    * @brief child signal handler
+    *
+    * This is used to interrupt waiting for connections when a connection
+    * process terminates so it can be reaped.
+    *
+    * @param the_signal int representing the signal received
+    *********************************************************************/
+    static void notice_child(int /* the_signal */) {
+}
+
+    /*****************************************************************//**
+    * @brief socket address creation
+    *
+    * This is used to fill a Unix domain socket address for a given path.
+    *
+    * @param address sockaddr_un reference to fill
+    * @param path const filePath reference to the socket path
+    *
+    * @return true if the path fits into the address, false otherwise
+    *********************************************************************/
+    static bool make_address(sockaddr_un & address, const filePath & path) {
+      memset(&address,0,sizeof(address));
+      address.sun_family = AF_UNIX;
+      if(path.empty() || path.size() >= sizeof(address.sun_path))
+      {
+        errno = ENAMETOOLONG;
+        return false;
+      }
+      strncpy(address.sun_path,path.c_str(),sizeof(address.sun_path)-1);
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a socketServer for a given task and socket
+    * path.
+    * The socket is not created before the server is run.
+    *
+    * @param the_task workerTask reference to process the requests with
+    * @param the_path filePath of the socket to listen on
+    *
+    * @return socketServer for the given task and socket path
+    *********************************************************************/
+    socketServer::socketServer(workerTask & the_task, const filePath & the_path)
+    :task(the_task),path(the_path) {
+}
+
+    /*****************************************************************//**
+    * @brief request serving
+    *
+    * This method is used to create the socket and to serve connections
+    * until the server receives SIGINT or SIGTERM.
+    * A stale socket left at the path is replaced, other files are not.
+    * If the socket cannot be created an error is raised.
+    * The socket is removed when the server stops.
+    *
+    * @return true if the server was stopped by a signal, false if the
+    *     socket could not be created or accepting connections failed
+    *********************************************************************/
+    bool socketServer::run() {
+       /*************************************************************\ 
+      | Replace a stale socket and create, bind and listen on the new |
+      | one stating an error in the case of failure:                  |
+       \*************************************************************/
+      struct stat path_status;
+      if(lstat(path.c_str(),&path_status) == 0 && S_ISSOCK(path_status.st_mode))
+      {
+        unlink(path.c_str());
+      }
+      sockaddr_un address;
+      const int listen_fd(make_address(address,path) ? socket(AF_UNIX,SOCK_STREAM,0) : -1);
+      if(listen_fd < 0 || bind(listen_fd,reinterpret_cast<sockaddr *>(&address),sizeof(address)) != 0 || listen(listen_fd,64) != 0)
+      {
+        std::cerr << "microSNPscore::socketServer::run\n";
+        std::cerr << " ==> Cannot listen on socket " << path << ": ";
+        std::cerr << strerror(errno) << std::endl;
+        std::cerr << "  --> no requests will be served\n";
+        if(listen_fd >= 0)
+        {
+          close(listen_fd);
+        }
+        return false;
+      }
+       /*************************************************************\ 
+      | Stop on SIGINT and SIGTERM, notice terminated connection      |
+      | processes and ignore SIGPIPE (broken connections are detected |
+      | by the failing write instead) remembering the old handlers:   |
+       \*************************************************************/
+      struct sigaction stop_action;
+      memset(&stop_action,0,sizeof(stop_action));
+      stop_action.sa_handler = request_stop;
+      sigemptyset(&stop_action.sa_mask);
+      struct sigaction child_action(stop_action);
+      child_action.sa_handler = notice_child;
+      struct sigaction ignore_action(stop_action);
+      ignore_action.sa_handler = SIG_IGN;
+      struct sigaction previous_int, previous_term, previous_child, previous_pipe;
+      stop_requested = 0;
+      sigaction(SIGINT,&stop_action,&previous_int);
+      sigaction(SIGTERM,&stop_action,&previous_term);
+      sigaction(SIGCHLD,&child_action,&previous_child);
+      sigaction(SIGPIPE,&ignore_action,&previous_pipe);
+       /**************************************************************\ 
+      | Accept connections and serve each in its own process (which    |
+      | restores the default stop handlers) until a stop is requested, |
+      | reaping terminated connection processes on the way:            |
+       \**************************************************************/
+      bool success(true);
+      while(!stop_requested)
+      {
+        while(waitpid(-1,NULL,WNOHANG) > 0) {/* nothing */}
+        const int connection_fd(accept(listen_fd,NULL,NULL));
+        if(connection_fd < 0)
+        {
+          if(errno != EINTR && errno != ECONNABORTED)
+          {
+            std::cerr << "microSNPscore::socketServer::run\n";
+            std::cerr << " ==> Cannot accept connection: ";
+            std::cerr << strerror(errno) << std::endl;
+            std::cerr << "  --> stopping server\n";
+            success = false;
+            break;
+          }
+          continue;
+        }
+        const pid_t pid(fork());
+        if(pid == 0)
+        {
+          close(listen_fd);
+          sigaction(SIGINT,&previous_int,NULL);
+          sigaction(SIGTERM,&previous_term,NULL);
+          sigaction(SIGCHLD,&previous_child,NULL);
+          serve_connection(connection_fd);
+          _exit(0);
+        }
+        if(pid < 0)
+        {
+          std::cerr << "microSNPscore::socketServer::run\n";
+          std::cerr << " ==> Cannot start connection process: ";
+          std::cerr << strerror(errno) << std::endl;
+          std::cerr << "  --> closing connection\n";
+        }
+        close(connection_fd);
+      } // !stop_requested
+       /**********************************************************\ 
+      | Remove the socket and restore the previous signal handlers |
+      | (running connections are finished by their processes):     |
+       \**********************************************************/
+      close(listen_fd);
+      unlink(path.c_str());
+      sigaction(SIGINT,&previous_int,NULL);
+      sigaction(SIGTERM,&previous_term,NULL);
+      sigaction(SIGCHLD,&previous_child,NULL);
+      sigaction(SIGPIPE,&previous_pipe,NULL);
+      return success;
+}
+
+    /*****************************************************************//**
+    * @brief connection serving
+    *
+    * This method is used to answer the requests read from a connection
+    * until the client stops sending or the connection breaks.
+    *
+    * @param connection_fd int representing the connection's descriptor
+    *********************************************************************/
+    void socketServer::serve_connection(int connection_fd) {
+       /**********************************************************\ 
+      | Answer every request line with a frame holding the result, |
+      | writing each answer at once so interactive clients get it  |
+      | without delay (the reader closes the connection when it is |
+      | destroyed after the writer):                               |
+       \**********************************************************/
+      lineReader requests(connection_fd,65536);
+      resultWriter answers(connection_fd,1,65536);
+      fieldView line;
+      std::string frame;
+      while(!answers.failed() && requests.next_line(line))
+      {
+        frame.clear();
+        workerPool::append_frame(frame,task.process(std::string(line.begin,line.end)));
+        answers.put_result(frame);
+      }
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a socketClient for a given socket path.
+    * The connection is not made before the client is run.
+    *
+    * @param the_path filePath of the socket to connect to
+    *
+    * @return socketClient for the given socket path
+    *********************************************************************/
+    socketClient::socketClient(const filePath & the_path)
+    :path(the_path) {
+}
+
+    /*****************************************************************//**
+    * @brief request sending
+    *
+    * This method is used to connect to the server, send all requests of
+    * a source and pass the answers on to a sink in request order.
+    * If the connection cannot be made or breaks before all requests are
+    * answered an error is raised.
+    *
+    * @param source requestSource reference to take the requests from
+    * @param sink resultSink reference to pass the answers to
+    *
+    * @return true if all requests were answered, false otherwise
+    *********************************************************************/
+    bool socketClient::run(requestSource & source, resultSink & sink) {
+       /**************************************************************\ 
+      | Connect to the server stating an error in the case of failure: |
+       \**************************************************************/
+      sockaddr_un address;
+      const int fd(make_address(address,path) ? socket(AF_UNIX,SOCK_STREAM,0) : -1);
+      if(fd < 0 || connect(fd,reinterpret_cast<sockaddr *>(&address),sizeof(address)) != 0)
+      {
+        std::cerr << "microSNPscore::socketClient::run\n";
+        std::cerr << " ==> Cannot connect to socket " << path << ": ";
+        std::cerr << strerror(errno) << std::endl;
+        std::cerr << "  --> no requests will be sent\n";
+        if(fd >= 0)
+        {
+          close(fd);
+        }
+        return false;
+      }
+       /***********************************************************\ 
+      | Keep up to 64 KiB of request lines queued for sending while |
+      | receiving the answers, half-close the connection once all   |
+      | requests are sent and stop when the server closes it:       |
+       \***********************************************************/
+      void (*previous_handler)(int) = signal(SIGPIPE,SIG_IGN);
+      fcntl(fd,F_SETFL,fcntl(fd,F_GETFL) | O_NONBLOCK);
+      const std::string::size_type queue_size(65536);
+      std::string requests;
+      std::string::size_type requests_written(0);
+      std::string answers;
+      std::string::size_type answers_extracted(0);
+      std::string request;
+      std::string answer;
+      unsigned long sent(0);
+      unsigned long received(0);
+      bool source_done(false);
+      bool sending(true);
+      bool success(true);
+      char read_buffer[65536];
+      while(true)
+      {
+        while(!source_done && requests.size() - requests_written < queue_size)
+        {
+          if(!source.next_request(request))
+          {
+            source_done = true;
+          }
+          else
+          {
+            requests += request;
+            requests += '\n';
+            ++sent;
+          }
+        }
+        if(sending && source_done && requests.empty())
+        {
+          shutdown(fd,SHUT_WR);
+          sending = false;
+        }
+        pollfd poll_fd = {fd,short(POLLIN | (sending ? POLLOUT : 0)),0};
+        if(poll(&poll_fd,1,-1) < 0)
+        {
+          if(errno == EINTR)
+          {
+            continue;
+          }
+          success = false;
+          break;
+        }
+        if(sending && (poll_fd.revents & POLLOUT))
+        {
+          const ssize_t bytes_written(write(fd,requests.data() + requests_written,requests.size() - requests_written));
+          if(bytes_written > 0)
+          {
+            requests_written += bytes_written;
+            workerPool::compact_buffer(requests,requests_written);
+          }
+          else if(bytes_written < 0 && errno != EAGAIN && errno != EINTR)
+          {
+            success = false;
+            break;
+          }
+        }
+        if(poll_fd.revents & (POLLIN | POLLHUP | POLLERR))
+        {
+          const ssize_t bytes_read(read(fd,read_buffer,sizeof(read_buffer)));
+          if(bytes_read == 0)
+          {
+            break;
+          }
+          if(bytes_read < 0)
+          {
+            if(errno != EAGAIN && errno != EINTR)
+            {
+              success = false;
+              break;
+            }
+            continue;
+          }
+          answers.append(read_buffer,bytes_read);
+          while(workerPool::extract_frame(answers,answers_extracted,answer))
+          {
+            sink.put_result(answer);
+            ++received;
+          }
+          workerPool::compact_buffer(answers,answers_extracted);
+        }
+      } // true
+      close(fd);
+      signal(SIGPIPE,previous_handler);
+       /*************************************************************\ 
+      | Make sure every request was answered stating an error if not: |
+       \*************************************************************/
+      if(!success || received != sent || !source_done)
+      {
+        std::cerr << "microSNPscore::socketClient::run\n";
+        std::cerr << " ==> connection to socket " << path << " broke: ";
+        std::cerr << (success ? "closed by server" : strerror(errno)) << std::endl;
+        std::cerr << "  --> " << sent - received << " requests were not answered\n";
+        return false;
+      }
+      return true;
+}
+
+
+} // namespace microSNPscore
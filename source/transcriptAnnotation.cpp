@@ -0,0 +1,341 @@
+#include <iostream>
+//for std::cerr and std::endl (error stating)
+#include <algorithm>
+//for std::sort, std::count, std::search and std::reverse (exon ordering, line checking, attribute search and reverse complement)
+#include <string.h>
+//for strlen (attribute search)
+#include "transcriptAnnotation.h"
+#include "referenceGenome.h"
+#include "sequenceFile.h"
+#include "resultWriter.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief exon order
+    *
+    * This is used to sort exons by their start positions.
+    *
+    * @param first const exon reference to the first exon
+    * @param second const exon reference to the second exon
+    *
+    * @return true if the first exon starts before the second one, false
+    *     otherwise
+    *********************************************************************/
+    static bool starts_before(const exon & first, const exon & second) {
+      return first.get_start() < second.get_start();
+}
+
+    /*****************************************************************//**
+    * @brief genome base conversion
+    *
+    * This is used to convert a base of the genome (+ strand) to the
+    * letter of the base on the transcript's strand.
+    * Ns and other ambiguous bases are masked (X), other characters are
+    * kept so they are reported when the sequence is created.
+    *
+    * @param base char of the genome base
+    * @param complement bool indicating whether the transcript is on
+    *     the - strand (i.e. the complementary base is needed)
+    *
+    * @return the letter of the base on the transcript's strand
+    *********************************************************************/
+    static char transcript_base(char base, bool complement) {
+      switch(base)
+      {
+        case 'A': return complement ? 'T' : 'A';
+        case 'C': return complement ? 'G' : 'C';
+        case 'G': return complement ? 'C' : 'G';
+        case 'T': case 'U': return complement ? 'A' : base;
+        case 'a': return complement ? 't' : 'a';
+        case 'c': return complement ? 'g' : 'c';
+        case 'g': return complement ? 'c' : 'g';
+        case 't': case 'u': return complement ? 'a' : base;
+        case 'N': case 'R': case 'Y': case 'S': case 'W': case 'K': case 'M': case 'B': case 'D': case 'H': case 'V':
+        case 'n': case 'r': case 'y': case 's': case 'w': case 'k': case 'm': case 'b': case 'd': case 'h': case 'v':
+          return 'X';
+        default: return base;
+      }
+}
+
+    /*****************************************************************//**
+    * @brief position list parsing
+    *
+    * This is used to convert a comma-separated list of positions (as
+    * the block sizes and starts of BED12 lines, optionally followed by
+    * a comma) to a vector.
+    *
+    * @param field const fieldView reference to the field holding the
+    *     list
+    * @param positions std::vector reference the positions are assigned
+    *     to
+    *
+    * @return true if the field is a valid position list, false otherwise
+    *********************************************************************/
+    static bool parse_position_list(const fieldView & field, std::vector<chromosomePosition> & positions) {
+      positions.clear();
+      for(const char * position_begin(field.begin);position_begin!=field.end;)
+      {
+        fieldView position_field = {position_begin,std::find(position_begin,field.end,',')};
+        chromosomePosition position;
+        if(!lineReader::parse_position(position_field,position))
+        {
+          return false;
+        }
+        positions.push_back(position);
+        position_begin = position_field.end == field.end ? field.end : position_field.end + 1;
+      }
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to read the transcripts of an annotation file.
+    * Invalid lines are reported and skipped.
+    * If the file cannot be read an error is raised and the annotation is
+    * created without any transcripts.
+    *
+    * @param the_path filePath to the BED12 or GTF file
+    *
+    * @return transcriptAnnotation for the given file
+    *********************************************************************/
+    transcriptAnnotation::transcriptAnnotation(const filePath & the_path)
+    :transcripts(),GTF_transcripts() {
+       /*************************************************\ 
+      | Try to open a line reader for the given file path |
+      | stating an error in the case of failure:          |
+       \*************************************************/
+      lineReader file(the_path);
+      if(!file.is_open())
+      {
+        std::cerr << "microSNPscore::transcriptAnnotation::transcriptAnnotation\n";
+        std::cerr << " ==> Cannot open file to read from: ";
+        std::cerr << the_path << std::endl;
+        std::cerr << "  --> no transcripts will be read from the file\n";
+        return;
+      }
+       /*****************************************************************\ 
+      | Read the file linewise skipping empty, comment, track and browser |
+      | lines and take lines with twelve fields as BED12 lines and those  |
+      | with nine fields as GTF lines stating an error for other lines or |
+      | if they do not describe a valid transcript or exon:               |
+       \*****************************************************************/
+      fieldView line;
+      fieldView fields[12];
+      while(file.next_line(line))
+      {
+        const std::string::size_type line_length(line.end-line.begin);
+        if(line_length == 0 || *line.begin == '#' || (line_length >= 5 && std::string(line.begin,5) == "track") ||
+           (line_length >= 7 && std::string(line.begin,7) == "browser"))
+        {
+          continue;
+        }
+        const long tab_count(std::count(line.begin,line.end,'\t'));
+        if(!(tab_count == 11 && lineReader::split_fields(line,fields,12) && add_BED_line(fields)) &&
+           !(tab_count == 8 && lineReader::split_fields(line,fields,9) && add_GTF_line(fields)))
+        {
+          std::cerr << "microSNPscore::transcriptAnnotation::transcriptAnnotation\n";
+          std::cerr << " ==> no valid BED12 or GTF line:\n";
+          std::cerr << std::string(line.begin,line.end) << std::endl;
+          std::cerr << "  --> omitting line\n";
+        }
+      } // file.next_line(line)
+      GTF_transcripts.clear();
+}
+
+    /*****************************************************************//**
+    * @brief sequence file entry creation
+    *
+    * This method is used to assign the sequence file entry of a
+    * transcript to a given entry taking the spliced sequence of its
+    * exons from a genome (reverse complemented for transcripts on the
+    * - strand).
+    * Ns and other ambiguous bases of the genome are masked.
+    * If an exon is not on the genome an error is raised and the entry is
+    * not changed.
+    *
+    * @param index unsigned long representing the number of the
+    *     transcript in the annotation (less than its size)
+    * @param genome const referenceGenome reference to the genome the
+    *     sequence is taken from
+    * @param entry sequenceFileEntry reference the entry is assigned to
+    *
+    * @return true if the entry was assigned, false otherwise
+    *********************************************************************/
+    bool transcriptAnnotation::get_entry(unsigned long index, const referenceGenome & genome, sequenceFileEntry & entry) const {
+       /*****************************************************************\ 
+      | Sort the exons along the chromosome and append the genome bases   |
+      | of each one (in the order of the + strand) stating an error if an |
+      | exon is not on the genome:                                        |
+       \*****************************************************************/
+      const annotatedTranscript & transcript(transcripts[index]);
+      std::vector<exon> exons(transcript.exons);
+      std::sort(exons.begin(),exons.end(),starts_before);
+      std::string bases;
+      std::string::size_type length(0);
+      for(std::vector<exon>::const_iterator exon_it(exons.begin());exon_it!=exons.end();++exon_it)
+      {
+        length += exon_it->get_end() - exon_it->get_start() + 1;
+      }
+      bases.reserve(length);
+      for(std::vector<exon>::const_iterator exon_it(exons.begin());exon_it!=exons.end();++exon_it)
+      {
+        if(!genome.append_bases(bases,transcript.chromosome,exon_it->get_start(),exon_it->get_end()))
+        {
+          std::cerr << "microSNPscore::transcriptAnnotation::get_entry\n";
+          std::cerr << " ==> exon " << exon_it->get_start() << "-" << exon_it->get_end() << " of transcript " << transcript.ID;
+          std::cerr << " is not on the genome: " << transcript.chromosome << std::endl;
+          std::cerr << "  --> omitting transcript\n";
+          return false;
+        }
+      }
+       /***************************************************************\ 
+      | Convert the bases to the transcript's strand (reading them from |
+      | the other end for the - strand) and assign the entry:           |
+       \***************************************************************/
+      const bool complement(transcript.strand == Minus);
+      for(std::string::iterator base_it(bases.begin());base_it!=bases.end();++base_it)
+      {
+        *base_it = transcript_base(*base_it,complement);
+      }
+      if(complement)
+      {
+        std::reverse(bases.begin(),bases.end());
+      }
+      entry.ID = transcript.ID;
+      entry.chromosome = transcript.chromosome;
+      entry.strand = transcript.strand;
+      entry.exon_starts.clear();
+      entry.exon_ends.clear();
+      for(std::vector<exon>::const_iterator exon_it(exons.begin());exon_it!=exons.end();++exon_it)
+      {
+        if(exon_it != exons.begin())
+        {
+          entry.exon_starts += ',';
+          entry.exon_ends += ',';
+        }
+        resultWriter::append_position(entry.exon_starts,exon_it->get_start());
+        resultWriter::append_position(entry.exon_ends,exon_it->get_end());
+      }
+      entry.nucleotide_sequence.swap(bases);
+      entry.mapped_begin = NULL;
+      entry.mapped_end = NULL;
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief BED12 line parsing
+    *
+    * This method is used to add the transcript described by the fields
+    * of a BED12 line.
+    *
+    * @param fields const fieldView array holding the twelve fields
+    *
+    * @return true if the fields describe a valid transcript, false
+    *     otherwise
+    *********************************************************************/
+    bool transcriptAnnotation::add_BED_line(const fieldView fields[]) {
+       /*****************************************************************\ 
+      | Parse the chromosome range, strand and blocks making sure there   |
+      | are as many block sizes and starts as blocks and every block lies |
+      | inside the range:                                                 |
+       \*****************************************************************/
+      chromosomePosition chromosome_start;
+      chromosomePosition chromosome_end;
+      chromosomePosition block_count;
+      std::vector<chromosomePosition> block_sizes;
+      std::vector<chromosomePosition> block_starts;
+      if(fields[0].begin == fields[0].end || fields[3].begin == fields[3].end ||
+         !lineReader::parse_position(fields[1],chromosome_start) || !lineReader::parse_position(fields[2],chromosome_end) ||
+         fields[5].end != fields[5].begin+1 || (*fields[5].begin != '+' && *fields[5].begin != '-') ||
+         !lineReader::parse_position(fields[9],block_count) || block_count == 0 ||
+         !parse_position_list(fields[10],block_sizes) || !parse_position_list(fields[11],block_starts) ||
+         block_sizes.size() != block_count || block_starts.size() != block_count)
+      {
+        return false;
+      }
+       /***************************************************************\ 
+      | Convert the blocks (with 0-based starts relative to the range)  |
+      | to exons (with 1-based positions on the chromosome) and add the |
+      | transcript:                                                     |
+       \***************************************************************/
+      annotatedTranscript transcript;
+      transcript.ID.assign(fields[3].begin,fields[3].end);
+      transcript.chromosome.assign(fields[0].begin,fields[0].end);
+      transcript.strand = *fields[5].begin == '+' ? Plus : Minus;
+      for(chromosomePosition block(0);block!=block_count;++block)
+      {
+        if(block_sizes[block] == 0 || block_starts[block] > chromosome_end - chromosome_start ||
+           block_sizes[block] > chromosome_end - chromosome_start - block_starts[block])
+        {
+          return false;
+        }
+        transcript.exons.push_back(exon(chromosome_start + block_starts[block] + 1,chromosome_start + block_starts[block] + block_sizes[block]));
+      }
+      transcripts.push_back(transcript);
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief GTF line parsing
+    *
+    * This method is used to add the exon described by the fields of a
+    * GTF line to its transcript (lines of other features are accepted
+    * but ignored).
+    *
+    * @param fields const fieldView array holding the nine fields
+    *
+    * @return true if the fields describe a valid feature, false
+    *     otherwise
+    *********************************************************************/
+    bool transcriptAnnotation::add_GTF_line(const fieldView fields[]) {
+       /***************************************************************\ 
+      | Accept lines of other features than exons unchecked and parse   |
+      | the positions, strand and transcript ID attribute of exon lines |
+      | (the ID being the quoted value following transcript_id):        |
+       \***************************************************************/
+      if(std::string(fields[2].begin,fields[2].end) != "exon")
+      {
+        return true;
+      }
+      const char * const attribute_name("transcript_id \"");
+      const char * const attribute(std::search(fields[8].begin,fields[8].end,attribute_name,attribute_name+strlen(attribute_name)));
+      const char * const ID_begin(attribute != fields[8].end ? attribute + strlen(attribute_name) : fields[8].end);
+      const char * const ID_end(std::find(ID_begin,fields[8].end,'"'));
+      chromosomePosition start;
+      chromosomePosition end;
+      if(fields[0].begin == fields[0].end || !lineReader::parse_position(fields[3],start) || !lineReader::parse_position(fields[4],end) ||
+         start == 0 || start > end || fields[6].end != fields[6].begin+1 || (*fields[6].begin != '+' && *fields[6].begin != '-') ||
+         ID_end == fields[8].end || ID_end == ID_begin)
+      {
+        return false;
+      }
+       /*****************************************************************\ 
+      | Add the exon to its transcript (adding the transcript if it is    |
+      | new) making sure all exons of a transcript are on the same strand |
+      | of the same chromosome:                                           |
+       \*****************************************************************/
+      const sequenceID ID(ID_begin,ID_end);
+      const chromosomeType chromosome(fields[0].begin,fields[0].end);
+      const strandType strand(*fields[6].begin == '+' ? Plus : Minus);
+      const std::pair<std::map<sequenceID,unsigned long>::iterator,bool> registered(GTF_transcripts.insert(std::make_pair(ID,transcripts.size())));
+      if(registered.second)
+      {
+        annotatedTranscript transcript;
+        transcript.ID = ID;
+        transcript.chromosome = chromosome;
+        transcript.strand = strand;
+        transcripts.push_back(transcript);
+      }
+      annotatedTranscript & transcript(transcripts[registered.first->second]);
+      if(transcript.chromosome != chromosome || transcript.strand != strand)
+      {
+        return false;
+      }
+      transcript.exons.push_back(exon(start,end));
+      return true;
+}
+
+
+} // namespace microSNPscore
@@ -0,0 +1,501 @@
+#include <iostream>
+//for std::cerr and std::endl (error stating)
+#include <map>
+//for std::map (reorder buffer)
+#include <unistd.h>
+//for fork, pipe, read, write and close (worker processes)
+#include <fcntl.h>
+//for fcntl (non-blocking pipes)
+#include <poll.h>
+//for poll (waiting for worker pipes)
+#include <signal.h>
+//for signal (ignoring SIGPIPE)
+#include <sys/wait.h>
+//for waitpid (worker termination)
+#include <errno.h>
+//for errno (error stating)
+#include <string.h>
+//for strerror (error stating)
+#include "workerPool.h"
+
+namespace microSNPscore {
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to destroy a worker task.
+    *********************************************************************/
+    workerTask::~workerTask() {
+}
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to destroy a request source.
+    *********************************************************************/
+    requestSource::~requestSource() {
+}
+
+    /*****************************************************************//**
+    * @brief destructor
+    *
+    * This is used to destroy a result sink.
+    *********************************************************************/
+    resultSink::~resultSink() {
+}
+
+    /*****************************************************************//**
+    * @brief constructor
+    *
+    * This is used to create a worker pool.
+    * The workers are not started until the @p run method is called.
+    *
+    * @param the_task workerTask reference to the task the workers should
+    *     process the requests with
+    * @param the_worker_count (optional) unsigned short representing the
+    *     number of worker processes - Defaults to 1
+    * @param the_queue_depth (optional) unsigned short representing the
+    *     maximal number of requests queued per worker - Defaults to 16
+    *
+    * @return a worker pool processing requests with the given task
+    *
+    * @see run()
+    *********************************************************************/
+    workerPool::workerPool(workerTask & the_task, unsigned short the_worker_count, unsigned short the_queue_depth)
+    :task(the_task),worker_count(the_worker_count == 0 ? 1 : the_worker_count),queue_depth(the_queue_depth == 0 ? 1 : the_queue_depth),workers(std::vector<worker>()) {
+}
+
+    /*****************************************************************//**
+    * @brief request processing
+    *
+    * This method is used to process all requests of the given source
+    * passing the results to the given sink in the order of the requests.
+    * The number of results held back to restore the request order is
+    * limited by the number of workers times the queue depth.
+    * If a worker process cannot be started or terminates unexpectedly an
+    * error is raised and the processing is stopped.
+    *
+    * @param source requestSource reference to take the requests from
+    * @param sink resultSink reference to pass the results to
+    *
+    * @return true if all requests were processed, false otherwise
+    *********************************************************************/
+    bool workerPool::run(requestSource & source, resultSink & sink) {
+       /****************************************************************\ 
+      | A single worker does not need any process or reordering overhead |
+      | so process the requests in the calling process:                  |
+       \****************************************************************/
+      std::string request;
+      if(worker_count == 1)
+      {
+        while(source.next_request(request))
+        {
+          sink.put_result(task.process(request));
+        }
+        return true;
+      }
+       /************************************************************\ 
+      | Ignore SIGPIPE (a dying worker is detected by the failing    |
+      | write instead) and start the workers stating an error in the |
+      | case of failure:                                             |
+       \************************************************************/
+      void (*previous_handler)(int) = signal(SIGPIPE,SIG_IGN);
+      bool success(start_workers());
+      if(!success)
+      {
+        std::cerr << "microSNPscore::workerPool::run\n";
+        std::cerr << " ==> cannot start worker processes: ";
+        std::cerr << strerror(errno) << std::endl;
+        std::cerr << "  --> no requests will be processed\n";
+      }
+       /*****************************************************************\ 
+      | Until all requests are processed, queue new requests at the least |
+      | busy worker, wait for the pipes to become ready, exchange data    |
+      | with the workers and pass the results on in request order:        |
+       \*****************************************************************/
+      std::map<unsigned long,std::string> held_back;
+      unsigned long next_request_number(0);
+      unsigned long next_result_number(0);
+      bool source_done(!success);
+      std::vector<pollfd> poll_fds;
+      std::vector<std::vector<worker>::iterator> poll_workers;
+      char read_buffer[65536];
+      while(success)
+      {
+        while(!source_done)
+        {
+          std::vector<worker>::iterator idle_it(workers.end());
+          for(std::vector<worker>::iterator worker_it(workers.begin());worker_it!=workers.end();++worker_it)
+          {
+            if(worker_it->in_flight.size() < queue_depth &&
+               (idle_it == workers.end() || worker_it->in_flight.size() < idle_it->in_flight.size()))
+            {
+              idle_it = worker_it;
+            }
+          }
+          if(idle_it == workers.end())
+          {
+            break;
+          }
+          if(!source.next_request(request))
+          {
+            source_done = true;
+          }
+          else
+          {
+            append_frame(idle_it->requests,request);
+            idle_it->in_flight.push_back(next_request_number++);
+          }
+        } // !source_done
+        bool all_done(source_done);
+        poll_fds.clear();
+        poll_workers.clear();
+        for(std::vector<worker>::iterator worker_it(workers.begin());worker_it!=workers.end();++worker_it)
+        {
+          if(source_done && worker_it->request_fd >= 0 && worker_it->requests.empty())
+          {
+            close(worker_it->request_fd);
+            worker_it->request_fd = -1;
+          }
+          if(worker_it->request_fd >= 0 && !worker_it->requests.empty())
+          {
+            pollfd request_poll = {worker_it->request_fd,POLLOUT,0};
+            poll_fds.push_back(request_poll);
+            poll_workers.push_back(worker_it);
+          }
+          if(!worker_it->in_flight.empty())
+          {
+            pollfd result_poll = {worker_it->result_fd,POLLIN,0};
+            poll_fds.push_back(result_poll);
+            poll_workers.push_back(worker_it);
+            all_done = false;
+          }
+        }
+        if(all_done)
+        {
+          break;
+        }
+        if(poll(&poll_fds[0],poll_fds.size(),-1) < 0)
+        {
+          if(errno == EINTR)
+          {
+            continue;
+          }
+          success = false;
+          break;
+        }
+        for(std::vector<pollfd>::size_type poll_index(0);success && poll_index!=poll_fds.size();++poll_index)
+        {
+          std::vector<worker>::iterator worker_it(poll_workers[poll_index]);
+          if(poll_fds[poll_index].revents == 0)
+          {
+            continue;
+          }
+          else if(poll_fds[poll_index].fd == worker_it->request_fd)
+          {
+            ssize_t written(write(worker_it->request_fd,worker_it->requests.data() + worker_it->requests_written,
+                                  worker_it->requests.size() - worker_it->requests_written));
+            if(written > 0)
+            {
+              worker_it->requests_written += written;
+              compact_buffer(worker_it->requests,worker_it->requests_written);
+            }
+            else if(written < 0 && errno != EAGAIN && errno != EINTR)
+            {
+              success = false;
+            }
+          }
+          else // result pipe
+          {
+            ssize_t bytes_read(read(worker_it->result_fd,read_buffer,sizeof(read_buffer)));
+            if(bytes_read > 0)
+            {
+              worker_it->results.append(read_buffer,bytes_read);
+              std::string result;
+              while(extract_frame(worker_it->results,worker_it->results_extracted,result))
+              {
+                held_back[worker_it->in_flight.front()] = result;
+                worker_it->in_flight.pop_front();
+              }
+              compact_buffer(worker_it->results,worker_it->results_extracted);
+            }
+            else if(bytes_read == 0 || (errno != EAGAIN && errno != EINTR))
+            {
+              success = false;
+            }
+          }
+        } // poll_index
+        if(!success)
+        {
+          std::cerr << "microSNPscore::workerPool::run\n";
+          std::cerr << " ==> worker process terminated unexpectedly\n";
+          std::cerr << "  --> stopping request processing\n";
+        }
+        for(std::map<unsigned long,std::string>::iterator result_it(held_back.begin());
+            result_it!=held_back.end() && result_it->first == next_result_number;held_back.erase(result_it++),++next_result_number)
+        {
+          sink.put_result(result_it->second);
+        }
+      } // success
+       /**********************************************************\ 
+      | Stop the workers and restore the previous SIGPIPE handler: |
+       \**********************************************************/
+      success = stop_workers() && success;
+      signal(SIGPIPE,previous_handler);
+      return success;
+}
+
+    /*****************************************************************//**
+    * @brief worker process main loop
+    *
+    * This method is run in a forked worker process. It reads framed
+    * requests from the given file descriptor, processes them with the
+    * task and writes the framed results to the other file descriptor
+    * until the request pipe is closed.
+    *
+    * @param request_fd file descriptor to read requests from
+    * @param result_fd file descriptor to write results to
+    *
+    * @return true if the request pipe was closed properly, false on
+    *     errors
+    *********************************************************************/
+    bool workerPool::serve(int request_fd, int result_fd) {
+       /*****************************************************************\ 
+      | Read chunks from the request pipe, process every complete request |
+      | and write its framed result back until the pipe is closed:        |
+       \*****************************************************************/
+      std::string requests;
+      std::string::size_type requests_extracted(0);
+      std::string request;
+      std::string results;
+      std::string::size_type results_written(0);
+      char read_buffer[65536];
+      for(;;)
+      {
+        ssize_t bytes_read(read(request_fd,read_buffer,sizeof(read_buffer)));
+        if(bytes_read == 0)
+        {
+          return requests.empty();
+        }
+        else if(bytes_read < 0)
+        {
+          if(errno == EINTR)
+          {
+            continue;
+          }
+          return false;
+        }
+        requests.append(read_buffer,bytes_read);
+        while(extract_frame(requests,requests_extracted,request))
+        {
+          append_frame(results,task.process(request));
+        }
+        compact_buffer(requests,requests_extracted);
+        while(!results.empty())
+        {
+          ssize_t written(write(result_fd,results.data() + results_written,results.size() - results_written));
+          if(written > 0)
+          {
+            results_written += written;
+            compact_buffer(results,results_written);
+          }
+          else if(errno != EINTR)
+          {
+            return false;
+          }
+        }
+      }
+}
+
+    /*****************************************************************//**
+    * @brief worker process start
+    *
+    * This method is used to fork the worker processes.
+    *
+    * @return true if all worker processes were started, false otherwise
+    *********************************************************************/
+    bool workerPool::start_workers() {
+       /****************************************************************\ 
+      | Create a request and a result pipe for every worker and fork it. |
+      | The worker closes the parent's pipe ends (including those of the |
+      | workers started before so they get notified when the parent      |
+      | closes them) and runs the main loop, the parent makes its ends   |
+      | non-blocking:                                                    |
+       \****************************************************************/
+      for(unsigned short worker_number(0);worker_number!=worker_count;++worker_number)
+      {
+        int request_pipe[2];
+        int result_pipe[2];
+        if(pipe(request_pipe) != 0)
+        {
+          return false;
+        }
+        if(pipe(result_pipe) != 0)
+        {
+          close(request_pipe[0]);
+          close(request_pipe[1]);
+          return false;
+        }
+        pid_t pid(fork());
+        if(pid < 0)
+        {
+          close(request_pipe[0]);
+          close(request_pipe[1]);
+          close(result_pipe[0]);
+          close(result_pipe[1]);
+          return false;
+        }
+        else if(pid == 0) // worker
+        {
+          for(std::vector<worker>::const_iterator worker_it(workers.begin());worker_it!=workers.end();++worker_it)
+          {
+            close(worker_it->request_fd);
+            close(worker_it->result_fd);
+          }
+          close(request_pipe[1]);
+          close(result_pipe[0]);
+          _exit(serve(request_pipe[0],result_pipe[1]) ? 0 : 1);
+        }
+        else // parent
+        {
+          close(request_pipe[0]);
+          close(result_pipe[1]);
+          fcntl(request_pipe[1],F_SETFL,fcntl(request_pipe[1],F_GETFL) | O_NONBLOCK);
+          fcntl(result_pipe[0],F_SETFL,fcntl(result_pipe[0],F_GETFL) | O_NONBLOCK);
+          worker new_worker;
+          new_worker.pid = pid;
+          new_worker.request_fd = request_pipe[1];
+          new_worker.requests_written = 0;
+          new_worker.result_fd = result_pipe[0];
+          new_worker.results_extracted = 0;
+          workers.push_back(new_worker);
+        }
+      } // worker_number
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief worker process stop
+    *
+    * This method is used to close the pipes to the worker processes
+    * and wait for their termination.
+    *
+    * @return true if all workers terminated normally, false otherwise
+    *********************************************************************/
+    bool workerPool::stop_workers() {
+       /****************************************************************\ 
+      | Close the remaining pipe ends (making the workers terminate) and |
+      | collect the exit status of every worker:                         |
+       \****************************************************************/
+      bool success(true);
+      for(std::vector<worker>::iterator worker_it(workers.begin());worker_it!=workers.end();++worker_it)
+      {
+        if(worker_it->request_fd >= 0)
+        {
+          close(worker_it->request_fd);
+        }
+        close(worker_it->result_fd);
+      }
+      for(std::vector<worker>::iterator worker_it(workers.begin());worker_it!=workers.end();++worker_it)
+      {
+        int status(0);
+        while(waitpid(worker_it->pid,&status,0) < 0 && errno == EINTR) {/* nothing */}
+        success = success && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+      }
+      workers.clear();
+      return success;
+}
+
+    /*****************************************************************//**
+    * @brief frame creation
+    *
+    * This method is used to append a length-prefixed frame containing
+    * the given payload to a buffer.
+    * Frames are used for the worker pipes and may be used for other
+    * byte streams carrying payloads that may contain newlines.
+    *
+    * @param buffer std::string reference to append the frame to
+    * @param payload const std::string reference to the frame's payload
+    *********************************************************************/
+    void workerPool::append_frame(std::string & buffer, const std::string & payload) {
+       /************************************************************\ 
+      | Prefix the payload with its length as four big-endian bytes: |
+       \************************************************************/
+      const unsigned long length(payload.size());
+      buffer += char((length >> 24) & 0xff);
+      buffer += char((length >> 16) & 0xff);
+      buffer += char((length >> 8) & 0xff);
+      buffer += char(length & 0xff);
+      buffer += payload;
+}
+
+    /*****************************************************************//**
+    * @brief frame extraction
+    *
+    * This method is used to extract a complete length-prefixed frame
+    * starting at a given offset of a buffer. The buffer is left as it is
+    * and the offset is moved behind the frame so consecutive frames are
+    * extracted without moving the remaining bytes.
+    *
+    * @param buffer const std::string reference to extract the frame from
+    * @param offset std::string::size_type reference to the offset of
+    *     the frame (moved behind it if it is complete)
+    * @param payload std::string reference the frame's payload is
+    *     assigned to
+    *
+    * @return true if a complete frame was extracted, false otherwise
+    *
+    * @see compact_buffer()
+    *********************************************************************/
+    bool workerPool::extract_frame(const std::string & buffer, std::string::size_type & offset, std::string & payload) {
+       /****************************************************************\ 
+      | Decode the length prefix and copy the payload if it is complete: |
+       \****************************************************************/
+      if(buffer.size() < offset + 4)
+      {
+        return false;
+      }
+      const unsigned long length((static_cast<unsigned long>(static_cast<unsigned char>(buffer[offset])) << 24) |
+                                 (static_cast<unsigned long>(static_cast<unsigned char>(buffer[offset + 1])) << 16) |
+                                 (static_cast<unsigned long>(static_cast<unsigned char>(buffer[offset + 2])) << 8) |
+                                  static_cast<unsigned long>(static_cast<unsigned char>(buffer[offset + 3])));
+      if(buffer.size() < offset + length + 4)
+      {
+        return false;
+      }
+      payload.assign(buffer,offset + 4,length);
+      offset += length + 4;
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief buffer compaction
+    *
+    * This method is used to drop the consumed bytes before a given
+    * offset from a buffer. To keep appending and consuming linear, the
+    * bytes are only moved once the consumed part exceeds half of the
+    * buffer (an entirely consumed buffer is simply cleared).
+    *
+    * @param buffer std::string reference to compact
+    * @param offset std::string::size_type reference to the number of
+    *     consumed bytes at the beginning of the buffer (reset to zero if
+    *     they are dropped)
+    *********************************************************************/
+    void workerPool::compact_buffer(std::string & buffer, std::string::size_type & offset) {
+       /****************************************************************\ 
+      | Move the remaining bytes to the front once they are the minority |
+      | so that moving them costs less than consuming the others did:    |
+       \****************************************************************/
+      if(offset == buffer.size())
+      {
+        buffer.clear();
+        offset = 0;
+      }
+      else if(offset > buffer.size() / 2)
+      {
+        buffer.erase(0,offset);
+        offset = 0;
+      }
+}
+
+} // namespace microSNPscore
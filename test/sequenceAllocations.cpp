@@ -0,0 +1,235 @@
+/*****************************************************************//**
+* @file sequenceAllocations.cpp
+* @brief nucleotide buffer allocation test
+*
+* This program checks that reading sequences through read_sequences
+* allocates exactly one nucleotide buffer per transcript, i.e. that
+* each sequence's nucleotides are decoded into one buffer which is then
+* moved (and never copied) into its table.
+* It reads the given files twice: the first reading provides the
+* nucleotides of every transcript, the second one is done with the
+* global operator new and delete replaced and counts every buffer freed
+* on the way that holds the nucleotides of a transcript - any such
+* buffer is a copy (or an original copied from) and fails the check.
+* The files should not contain duplicate IDs, as a duplicate is decoded
+* before it is rejected.
+*
+* It is built and run on the files in test/data (plain and compressed)
+* by "make check" in test/, see the Makefile there.
+*
+* It exits with 0 if the check passes and 1 otherwise.
+*********************************************************************/
+#include <new>
+//for std::bad_alloc (replaced operator new)
+#include <map>
+//for std::map (transcripts per buffer size)
+#include <vector>
+//for std::vector (transcripts of a buffer size)
+#include <iostream>
+//for std::cout and std::cerr (result stating)
+#include <stdlib.h>
+//for malloc and free (replaced operator new and delete)
+#include <pthread.h>
+//for pthread_mutex_lock and pthread_mutex_unlock (threaded reading)
+#include "nucleotide.h"
+#include "sequenceLoader.h"
+
+using namespace microSNPscore;
+
+    /*****************************************************************//**
+    * @brief allocation header size
+    *
+    * This is the number of bytes in front of each allocation that hold
+    * its size (keeping the alignment of malloc).
+    *********************************************************************/
+    static const size_t header_size = 16;
+
+    /*****************************************************************//**
+    * @brief transcript buffers
+    *
+    * These are the nucleotides of the transcripts of the first reading
+    * per number of bytes they take.
+    * The map is complete before counting starts and is only read while
+    * counting, so operator delete can search it without allocating.
+    *********************************************************************/
+    static std::map<size_t,std::vector<const nucleotide *> > transcript_buffers;
+
+    /*****************************************************************//**
+    * @brief counting flag
+    *
+    * This tells whether freed buffers are counted at the moment.
+    *********************************************************************/
+    static bool counting = false;
+
+    /*****************************************************************//**
+    * @brief freed nucleotide buffer count
+    *
+    * This is the number of buffers freed while counting that held the
+    * nucleotides of a transcript.
+    *********************************************************************/
+    static unsigned long freed_buffers = 0;
+
+    /*****************************************************************//**
+    * @brief count lock
+    *
+    * This serializes counting, as sequences are created on several
+    * threads.
+    *********************************************************************/
+    static pthread_mutex_t count_lock = PTHREAD_MUTEX_INITIALIZER;
+
+    /*****************************************************************//**
+    * @brief nucleotide comparison
+    *
+    * This is used to compare the nucleotides of two buffers (by value,
+    * so padding does not matter).
+    *
+    * @param first const nucleotide pointer to the first buffer
+    * @param second const nucleotide pointer to the second buffer
+    * @param count size_t representing the number of nucleotides
+    *
+    * @return true if the buffers hold the same nucleotides, false else
+    *********************************************************************/
+    static bool same_nucleotides(const nucleotide * first, const nucleotide * second, size_t count) {
+      for(size_t index(0);index!=count;++index)
+      {
+        if(first[index].get_base() != second[index].get_base()
+           || first[index].get_sequence_position() != second[index].get_sequence_position()
+           || first[index].get_chromosome_position() != second[index].get_chromosome_position()
+           || first[index].get_conservation_offset() != second[index].get_conservation_offset())
+        {
+          return false;
+        }
+      }
+      return true;
+}
+
+    /*****************************************************************//**
+    * @brief allocation
+    *
+    * This replaces the global operator new storing the size of the
+    * allocation in front of it.
+    *
+    * @param size size_t representing the number of bytes to allocate
+    *
+    * @return void pointer to the memory allocated
+    *********************************************************************/
+    void * operator new(size_t size) {
+      char * const memory(static_cast<char *>(malloc(header_size+size)));
+      if(memory == NULL)
+      {
+        throw std::bad_alloc();
+      }
+      *reinterpret_cast<size_t *>(memory) = size;
+      return memory+header_size;
+}
+
+    /*****************************************************************//**
+    * @brief array allocation
+    *
+    * This replaces the global operator new[].
+    *
+    * @param size size_t representing the number of bytes to allocate
+    *
+    * @return void pointer to the memory allocated
+    *********************************************************************/
+    void * operator new[](size_t size) {
+      return operator new(size);
+}
+
+    /*****************************************************************//**
+    * @brief deallocation
+    *
+    * This replaces the global operator delete counting the buffer if it
+    * holds the nucleotides of a transcript while counting.
+    *
+    * @param memory void pointer to the memory to free
+    *********************************************************************/
+    void operator delete(void * memory) throw() {
+      if(memory == NULL)
+      {
+        return;
+      }
+      char * const allocation(static_cast<char *>(memory)-header_size);
+      if(counting)
+      {
+        const size_t size(*reinterpret_cast<size_t *>(allocation));
+        std::map<size_t,std::vector<const nucleotide *> >::const_iterator size_it(transcript_buffers.find(size));
+        if(size_it != transcript_buffers.end())
+        {
+          for(std::vector<const nucleotide *>::const_iterator buffer_it(size_it->second.begin());buffer_it!=size_it->second.end();++buffer_it)
+          {
+            if(same_nucleotides(static_cast<const nucleotide *>(memory),*buffer_it,size/sizeof(nucleotide)))
+            {
+              pthread_mutex_lock(&count_lock);
+              ++freed_buffers;
+              pthread_mutex_unlock(&count_lock);
+              break;
+            }
+          }
+        }
+      }
+      free(allocation);
+}
+
+    /*****************************************************************//**
+    * @brief array deallocation
+    *
+    * This replaces the global operator delete[].
+    *
+    * @param memory void pointer to the memory to free
+    *********************************************************************/
+    void operator delete[](void * memory) throw() {
+      operator delete(memory);
+}
+
+    /*****************************************************************//**
+    * @brief transcript buffer collection
+    *
+    * This is used to collect the nucleotides of the sequences of a table
+    * per number of bytes they take.
+    *
+    * @param table entityTable reference to the sequences to collect
+    *********************************************************************/
+    template<class T>
+    static void collect_buffers(const entityTable<sequenceID,T> & table) {
+      for(entityID ID(0);ID!=table.size();++ID)
+      {
+        if(table[ID].begin() != table[ID].end())
+        {
+          transcript_buffers[(table[ID].end()-table[ID].begin())*sizeof(nucleotide)].push_back(&*table[ID].begin());
+        }
+      }
+}
+
+int main(int argc, char * argv[])
+{
+   /*************************************************************\ 
+  | Read the sequences once and collect their nucleotides by size |
+  | as a reference:                                               |
+   \*************************************************************/
+  if(argc != 3)
+  {
+    std::cerr << "usage: " << argv[0] << " <mRNA file> <miRNA file>\n";
+    return 1;
+  }
+  entityTable<sequenceID,mRNA> reference_mRNAs;
+  entityTable<sequenceID,miRNA> reference_miRNAs;
+  read_sequences(reference_mRNAs,argv[1],reference_miRNAs,argv[2]);
+  collect_buffers(reference_mRNAs);
+  collect_buffers(reference_miRNAs);
+   /***************************************************************\ 
+  | Read them again counting the buffers freed that held the        |
+  | nucleotides of a transcript - each stored sequence holds one    |
+  | buffer, so these are the buffers allocated beyond one for each: |
+   \***************************************************************/
+  entityTable<sequenceID,mRNA> mRNAs;
+  entityTable<sequenceID,miRNA> miRNAs;
+  counting = true;
+  read_sequences(mRNAs,argv[1],miRNAs,argv[2]);
+  counting = false;
+  const unsigned long transcripts(mRNAs.size()+miRNAs.size());
+  const bool passed(transcripts != 0 && transcripts == reference_mRNAs.size()+reference_miRNAs.size() && freed_buffers == 0);
+  std::cout << transcripts << " transcripts, " << transcripts+freed_buffers << " nucleotide buffers: ";
+  std::cout << (passed ? "passed" : "failed") << std::endl;
+  return passed ? 0 : 1;
+}